@@ -72,15 +72,34 @@ for var in ['CC', 'CXX', 'CFLAGS', 'CXXFLAGS']:
 # env.Program(source='src/c/tests/test_set.c',
 #             target='test_set')
 
-read_indicator_object = env.Object(source='src/c/read_indicators/reader_groups_read_indicator.c')
+asymmetric_fence_object = env.Object(source='src/c/misc/asymmetric_fence.c')
+read_indicator_object = env.Object(source='src/c/read_indicators/read_indicator.c')
+reader_groups_read_indicator_object = env.Object(source='src/c/read_indicators/reader_groups_read_indicator.c')
+adaptive_lock_object = env.Object(source='src/c/locks/adaptive_lock.c')
+biased_lock_object = env.Object(source='src/c/locks/biased_lock.c')
 ccsynch_lock_object = env.Object(source='src/c/locks/ccsynch_lock.c')
+compact_qd_lock_object = env.Object(source='src/c/locks/compact_qd_lock.c')
+priority_qd_lock_object = env.Object(source='src/c/locks/priority_qd_lock.c')
 drmcs_lock_object = env.Object(source='src/c/locks/drmcs_lock.c')
 mcs_lock_object = env.Object(source='src/c/locks/mcs_lock.c')
 mrqd_lock_object = env.Object(source='src/c/locks/mrqd_lock.c')
 qd_lock_object = env.Object(source='src/c/locks/qd_lock.c')
 tatas_lock_object = env.Object(source='src/c/locks/tatas_lock.c')
+lock_tuner_object = env.Object(source='src/c/locks/lock_tuner.c')
+lock_table_object = env.Object(source='src/c/locks/lock_table.c')
+delegate_fence_object = env.Object(source='src/c/locks/delegate_fence.c')
+delegate_forward_object = env.Object(source='src/c/locks/delegate_forward.c')
+delegate_deadline_object = env.Object(source='src/c/locks/delegate_deadline.c')
+wait_until_object = env.Object(source='src/c/locks/wait_until.c')
+delegate_async_object = env.Object(source='src/c/locks/delegate_async.c')
+oo_lock_api_object = env.Object(source='src/c/locks/oo_lock_api.c')
 
-lock_dependencies = [read_indicator_object,ccsynch_lock_object,drmcs_lock_object,mcs_lock_object,mrqd_lock_object,qd_lock_object,tatas_lock_object]
+lock_dependencies = [asymmetric_fence_object,read_indicator_object,reader_groups_read_indicator_object,adaptive_lock_object,biased_lock_object,ccsynch_lock_object,compact_qd_lock_object,priority_qd_lock_object,drmcs_lock_object,mcs_lock_object,mrqd_lock_object,qd_lock_object,tatas_lock_object,lock_tuner_object,lock_table_object,delegate_fence_object,delegate_forward_object,delegate_deadline_object,wait_until_object,delegate_async_object,oo_lock_api_object]
+
+mailbox_object = env.Object(source='src/c/qd_queues/mailbox.c')
+actor_object = env.Object(source='src/c/qd_queues/actor.c')
+
+queue_dependencies = [mailbox_object,actor_object]
 
 chained_hash_set_object = env.Object(source='src/c/data_structures/chained_hash_set.c')
 conc_splitch_set_object = env.Object(source='src/c/data_structures/conc_splitch_set.c')
@@ -88,7 +107,7 @@ sorted_list_set_object = env.Object(source='src/c/data_structures/sorted_list_se
 
 data_structures_dependencies = [chained_hash_set_object,conc_splitch_set_object,sorted_list_set_object]
 
-dependencies = lock_dependencies + data_structures_dependencies
+dependencies = lock_dependencies + queue_dependencies + data_structures_dependencies
 
 
 #Static Library
@@ -104,6 +123,8 @@ dynamic_lib = env.SharedLibrary(target = 'qd_lock_lib',
                                 source = 
                                 Glob('src/c/data_structures/*.c') + 
                                 Glob('src/c/locks/*.c') +
+                                Glob('src/c/misc/*.c') +
+                                Glob('src/c/qd_queues/*.c') +
                                 Glob('src/c/read_indicators/*.c'))
 
 #Tests
@@ -116,12 +137,38 @@ env.Program(source=['src/c/tests/test_lock.c'] + dependencies,
 env.Program(source='src/c/tests/test_qd_queue.c',
             target='test_qd_queue')
 
+env.Program(source=['src/c/tests/test_mailbox.c'] + dependencies,
+            target='test_mailbox')
+
+env.Program(source=['src/c/tests/test_locks_cpp.cpp'] + dependencies,
+            target='test_locks_cpp')
+
+# The coroutine support needs C++20
+cxx20_flags = str(env['CXXFLAGS']).replace('-std=c++11', '-std=c++20')
+
+env.Program(source=['src/c/tests/test_locks_coroutine.cpp'] + dependencies,
+            target='test_locks_coroutine',
+            CXXFLAGS=cxx20_flags)
+
+env.Program(source=['src/c/tests/test_lock_tuner.c'] + dependencies,
+            target='test_lock_tuner')
+
+env.Program(source=['src/c/tests/test_read_indicator.c'] + dependencies,
+            target='test_read_indicator')
+
+env.Program(source=['src/c/tests/test_lock_table.c'] + dependencies,
+            target='test_lock_table')
+
 if not use_gcc:
     #Plain locks
     #type, type name
     all_locks = [('TATASLock', 'PLAIN_TATAS_LOCK'),
                  ('QDLock', 'PLAIN_QD_LOCK'),
                  ('MRQDLock', 'PLAIN_MRQD_LOCK'),
+                 ('AdaptiveLock', 'PLAIN_ADAPTIVE_LOCK'),
+                 ('BiasedLock', 'PLAIN_BIASED_LOCK'),
+                 ('CompactQDLock', 'PLAIN_COMPACT_QD_LOCK'),
+                 ('PriorityQDLock', 'PLAIN_PRIORITY_QD_LOCK'),
                  ('CCSynchLock', 'PLAIN_CCSYNCH_LOCK'),
                  ('MCSLock', 'PLAIN_MCS_LOCK'),
                  ('DRMCSLock', 'PLAIN_DRMCS_LOCK')]
@@ -166,3 +213,19 @@ env.Program(source=['src/c/examples/shared_int_example.c'] + static_lib,
 
 env.Program(source=['src/c/examples/concurrent_queue_example.c'] + static_lib,
             target='concurrent_queue_example')
+
+#Benchmarks
+###########
+
+env.Program(source=['src/c/benchmarks/writer_latency_benchmark.c'] + static_lib,
+            target='writer_latency_benchmark')
+
+env.Program(source=['src/c/benchmarks/read_indicator_memory_benchmark.c'] + static_lib,
+            target='read_indicator_memory_benchmark')
+
+env.Program(source=['src/c/benchmarks/priority_lane_latency_benchmark.c'] + static_lib,
+            target='priority_lane_latency_benchmark')
+
+env.Program(source=['src/c/benchmarks/coroutine_delegation_benchmark.cpp'] + static_lib,
+            target='coroutine_delegation_benchmark',
+            CXXFLAGS=cxx20_flags)
@@ -0,0 +1,155 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "locks/locks_coroutine.hpp"
+
+/* Coroutine delegation benchmark
+
+   Compares two ways of having many delegated critical sections in
+   flight. In the thread-per-wait model every in-flight operation has
+   its own thread that calls ll::delegate_wait in a loop. In the
+   coroutine model the same number of coroutines await
+   ll::delegate_await in a loop on a pool with a fixed number of
+   threads. Each critical section is followed by the same amount of
+   work outside the lock. The throughput of each model is printed for
+   a growing number of in-flight operations.
+
+   Usage: coroutine_delegation_benchmark [LOCK_TYPE] [MAX_IN_FLIGHT] [POOL_THREADS] [CS_WORK_ITERATIONS] */
+
+#define MEASURE_MILLISECONDS 1000
+
+static const struct {
+    const char * name;
+    LL_lock_type_name type;
+} lockTypeNames[] = {
+    {"QD_LOCK", QD_LOCK},
+    {"MRQD_LOCK", MRQD_LOCK},
+    {"PRIORITY_QD_LOCK", PRIORITY_QD_LOCK},
+    {"COMPACT_QD_LOCK", COMPACT_QD_LOCK},
+    {"ADAPTIVE_LOCK", ADAPTIVE_LOCK},
+    {"CCSYNCH_LOCK", CCSYNCH_LOCK},
+    {"TATAS_LOCK", TATAS_LOCK},
+    {"MCS_LOCK", MCS_LOCK}
+};
+
+unsigned long csWorkIterations = 100;
+unsigned long sharedCounter = 0;
+std::atomic<bool> stop;
+std::atomic<unsigned long> operations;
+std::atomic<int> finishedCoroutines;
+
+void work(){
+    for(unsigned long i = 0; i < csWorkIterations; i++){
+        __asm__ __volatile__("" : : : "memory");
+    }
+}
+
+unsigned long critical_section(){
+    work();
+    sharedCounter++;
+    return sharedCounter;
+}
+
+void thread_per_wait_client(ll::Lock & lock){
+    unsigned long done = 0;
+    while(!stop.load(std::memory_order_acquire)){
+        ll::delegate_wait(lock, critical_section);
+        work();
+        done++;
+    }
+    operations.fetch_add(done);
+}
+
+ll::DetachedCoroutine coroutine_client(ll::Lock & lock, ll::ThreadPool & pool){
+    co_await pool.schedule();
+    unsigned long done = 0;
+    while(!stop.load(std::memory_order_acquire)){
+        co_await ll::delegate_await(lock, critical_section, pool);
+        work();
+        done++;
+    }
+    operations.fetch_add(done);
+    finishedCoroutines.fetch_add(1);
+}
+
+void measure(){
+    std::this_thread::sleep_for(std::chrono::milliseconds(MEASURE_MILLISECONDS));
+    stop.store(true, std::memory_order_release);
+}
+
+double measure_thread_per_wait(LL_lock_type_name lockType, int inFlight){
+    ll::Lock lock(lockType);
+    std::vector<std::thread> clients;
+    stop.store(false);
+    operations.store(0);
+    for(int i = 0; i < inFlight; i++){
+        clients.emplace_back(thread_per_wait_client, std::ref(lock));
+    }
+    measure();
+    for(std::thread & client : clients){
+        client.join();
+    }
+    return operations.load() * (1000.0 / MEASURE_MILLISECONDS);
+}
+
+double measure_coroutines(LL_lock_type_name lockType, int inFlight, int poolThreads){
+    ll::Lock lock(lockType);
+    stop.store(false);
+    operations.store(0);
+    finishedCoroutines.store(0);
+    ll::ThreadPool pool(poolThreads);
+    for(int i = 0; i < inFlight; i++){
+        coroutine_client(lock, pool);
+    }
+    measure();
+    while(finishedCoroutines.load() < inFlight){
+        std::this_thread::yield();
+    }
+    return operations.load() * (1000.0 / MEASURE_MILLISECONDS);
+}
+
+int main(int argc, char **argv){
+    LL_lock_type_name lockType = QD_LOCK;
+    const char * lockTypeName = "QD_LOCK";
+    int maxInFlight = 1024;
+    int poolThreads = 4;
+    if(argc > 1){
+        bool found = false;
+        for(const auto & name : lockTypeNames){
+            if(strcmp(name.name, argv[1]) == 0){
+                lockType = name.type;
+                found = true;
+            }
+        }
+        if(!found){
+            printf("Unknown lock type %s\n", argv[1]);
+            return 1;
+        }
+        lockTypeName = argv[1];
+    }
+    if(argc > 2){
+        maxInFlight = atoi(argv[2]);
+    }
+    if(argc > 3){
+        poolThreads = atoi(argv[3]);
+    }
+    if(argc > 4){
+        csWorkIterations = strtoul(argv[4], NULL, 10);
+    }
+    printf("# lock type: %s, pool threads: %d, critical section work iterations: %lu\n",
+           lockTypeName,
+           poolThreads,
+           csWorkIterations);
+    printf("# in flight  thread-per-wait (ops/s)  coroutines (ops/s)\n");
+    for(int inFlight = 1; inFlight <= maxInFlight; inFlight = inFlight * 4){
+        double threadPerWait = measure_thread_per_wait(lockType, inFlight);
+        double coroutines = measure_coroutines(lockType, inFlight, poolThreads);
+        printf("%11d  %23.0f  %18.0f\n", inFlight, threadPerWait, coroutines);
+    }
+    return 0;
+}
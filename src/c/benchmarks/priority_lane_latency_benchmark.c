@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+
+#include "locks/locks.h"
+
+/* Priority lane latency benchmark
+
+   Bulk threads delegate critical sections without waiting for them
+   while a latency thread delegates and waits for critical sections
+   with the highest and the lowest priority. The latency of each
+   delegate wait call is recorded and the 50th, 99th and 99.9th
+   percentiles are printed for each priority. Lock types without
+   priority lanes ignore the priority, which gives the baseline.
+
+   Usage: priority_lane_latency_benchmark [LOCK_TYPE] [BULK_THREADS] [CS_WORK_ITERATIONS] */
+
+#define LATENCY_SAMPLES 20000
+
+OOLock * lock;
+LLPaddedBool stop;
+unsigned long csWorkIterations = 100;
+unsigned long sharedCounter = 0;
+
+void critical_section(unsigned int messageSize, void * message){
+    UNUSED(messageSize);
+    UNUSED(message);
+    for(unsigned long i = 0; i < csWorkIterations; i++){
+        __asm__ __volatile__("" : : : "memory");
+    }
+    sharedCounter++;
+}
+
+void * bulk_thread(void * unused){
+    UNUSED(unused);
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        LL_delegate(lock, critical_section, 0, NULL);
+    }
+    return NULL;
+}
+
+int compare_uint64(const void * a, const void * b){
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+uint64_t percentile(uint64_t * sortedSamples, double p){
+    unsigned long index = (unsigned long)(p * (LATENCY_SAMPLES - 1));
+    return sortedSamples[index];
+}
+
+void measure_lane_latency(LL_lock_type_name lockType, int numberOfBulkThreads){
+    pthread_t bulkThreads[numberOfBulkThreads];
+    unsigned int priorities[] = {0, PQD_LOCK_DEFAULT_PRIORITY};
+    uint64_t * samples[2];
+    lock = LL_create(lockType);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < numberOfBulkThreads; i++){
+        pthread_create(&bulkThreads[i], NULL, &bulk_thread, NULL);
+    }
+    for(int p = 0; p < 2; p++){
+        samples[p] = malloc(sizeof(uint64_t) * LATENCY_SAMPLES);
+    }
+    // The priorities are interleaved so that both see the same load
+    for(int i = 0; i < LATENCY_SAMPLES; i++){
+        for(int p = 0; p < 2; p++){
+            uint64_t start = ll_now_nanos();
+            LL_delegate_wait_priority(lock, priorities[p], critical_section, 0, NULL);
+            samples[p][i] = ll_now_nanos() - start;
+        }
+    }
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < numberOfBulkThreads; i++){
+        pthread_join(bulkThreads[i], NULL);
+    }
+    LL_free(lock);
+    for(int p = 0; p < 2; p++){
+        qsort(samples[p], LATENCY_SAMPLES, sizeof(uint64_t), compare_uint64);
+        printf("%12d  %8u  %8lu  %8lu  %8lu\n",
+               numberOfBulkThreads,
+               priorities[p],
+               (unsigned long)percentile(samples[p], 0.5),
+               (unsigned long)percentile(samples[p], 0.99),
+               (unsigned long)percentile(samples[p], 0.999));
+        free(samples[p]);
+    }
+}
+
+int main(int argc, char **argv){
+    LL_lock_type_name lockType = PRIORITY_QD_LOCK;
+    const char * lockTypeName = "PRIORITY_QD_LOCK";
+    int maxBulkThreads = 8;
+    if(argc > 1){
+        lockTypeName = argv[1];
+        if(strcmp("PRIORITY_QD_LOCK", argv[1]) == 0){
+            lockType = PRIORITY_QD_LOCK;
+        }else if(strcmp("QD_LOCK", argv[1]) == 0){
+            lockType = QD_LOCK;
+        }else{
+            printf("Give PRIORITY_QD_LOCK or QD_LOCK as lock type\n");
+            return 1;
+        }
+    }
+    if(argc > 2){
+        maxBulkThreads = atoi(argv[2]);
+    }
+    if(argc > 3){
+        csWorkIterations = strtoul(argv[3], NULL, 10);
+    }
+    printf("# lock type: %s, critical section work iterations: %lu\n",
+           lockTypeName,
+           csWorkIterations);
+    printf("# bulk threads  priority  p50 (ns)  p99 (ns)  p99.9 (ns)\n");
+    for(int threads = 1; threads <= maxBulkThreads; threads = threads * 2){
+        measure_lane_latency(lockType, threads);
+    }
+    return 0;
+}
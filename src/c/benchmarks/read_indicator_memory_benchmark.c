@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+#include "misc/random.h"
+
+#include "locks/locks.h"
+
+/* Read indicator memory benchmark
+
+   Creates NUMBER_OF_LOCKS MRQD locks and lets NUMBER_OF_THREADS
+   threads take read or write locks on randomly selected locks. The
+   benchmark is run with read indicators of different widths and with
+   one read indicator shared by all locks. For each configuration it
+   prints the number of bytes used per lock (the lock itself plus its
+   share of the read indicator memory) and the throughput.
+
+   Usage: read_indicator_memory_benchmark [NUMBER_OF_THREADS] [WRITE_PERCENTAGE] [NUMBER_OF_LOCKS] */
+
+#define RUN_MILLIS 1000
+#define SHARED_READ_INDICATOR_WIDTH -1
+
+typedef struct {
+    unsigned int seed;
+    unsigned long operations;
+    char pad[CACHE_LINE_SIZE_PAD(sizeof(unsigned int) + sizeof(unsigned long))];
+} BenchmarkThreadData;
+
+MRQDLock ** locks;
+int numberOfLocks = 1024;
+double writePercentage = 0.01;
+LLPaddedBool stop;
+
+void * benchmark_thread(void * threadDataVPtr){
+    BenchmarkThreadData * threadData = threadDataVPtr;
+    unsigned long operations = 0;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        MRQDLock * lock = locks[rand_r(&threadData->seed) % numberOfLocks];
+        if(random_double(&threadData->seed) < writePercentage){
+            LL_lock(lock);
+            LL_unlock(lock);
+        }else{
+            LL_rlock(lock);
+            LL_runlock(lock);
+        }
+        operations = operations + 1;
+    }
+    threadData->operations = operations;
+    return NULL;
+}
+
+/* Returns the throughput in operations per microsecond and stores the
+   number of bytes used per lock in bytesPerLock */
+double run_benchmark(int numberOfThreads, int width, double * bytesPerLock){
+    ReadIndicator sharedReadIndicator;
+    size_t totalBytes = 0;
+    locks = malloc(sizeof(MRQDLock *) * numberOfLocks);
+    if(width == SHARED_READ_INDICATOR_WIDTH){
+        ri_initialize(&sharedReadIndicator, READER_GROUPS_READ_INDICATOR);
+        totalBytes = ri_allocated_size(&sharedReadIndicator);
+    }
+    for(int i = 0; i < numberOfLocks; i++){
+        if(width == SHARED_READ_INDICATOR_WIDTH){
+            locks[i] = LL_create_with_shared_read_indicator(PLAIN_MRQD_LOCK, &sharedReadIndicator);
+        }else{
+            locks[i] = LL_create_with_read_indicator_width(PLAIN_MRQD_LOCK,
+                                                           READER_GROUPS_READ_INDICATOR,
+                                                           width);
+        }
+        totalBytes = totalBytes + sizeof(MRQDLock) + ri_allocated_size(&locks[i]->readIndicator);
+    }
+    *bytesPerLock = (double)totalBytes / numberOfLocks;
+    pthread_t threads[numberOfThreads];
+    BenchmarkThreadData * threadData =
+        aligned_alloc(CACHE_LINE_SIZE, sizeof(BenchmarkThreadData) * numberOfThreads);
+    atomic_store(&stop.value, false);
+    uint64_t startTime = ll_now_nanos();
+    for(int i = 0; i < numberOfThreads; i++){
+        threadData[i].seed = i + 1;
+        threadData[i].operations = 0;
+        pthread_create(&threads[i], NULL, &benchmark_thread, &threadData[i]);
+    }
+    struct timespec runTime = {.tv_sec = RUN_MILLIS / 1000,
+                               .tv_nsec = (RUN_MILLIS % 1000) * 1000000};
+    nanosleep(&runTime, NULL);
+    atomic_store_explicit(&stop.value, true, memory_order_release);
+    unsigned long operations = 0;
+    for(int i = 0; i < numberOfThreads; i++){
+        pthread_join(threads[i], NULL);
+        operations = operations + threadData[i].operations;
+    }
+    uint64_t elapsedNanos = ll_now_nanos() - startTime;
+    for(int i = 0; i < numberOfLocks; i++){
+        LL_free(locks[i]);
+    }
+    if(width == SHARED_READ_INDICATOR_WIDTH){
+        ri_destroy(&sharedReadIndicator);
+    }
+    free(threadData);
+    free(locks);
+    return ((double)operations * 1000.0) / (double)elapsedNanos;
+}
+
+int main(int argc, char **argv){
+    int numberOfThreads = 4;
+    if(argc > 1){
+        numberOfThreads = atoi(argv[1]);
+    }
+    if(argc > 2){
+        writePercentage = atof(argv[2]) / 100.0;
+    }
+    if(argc > 3){
+        numberOfLocks = atoi(argv[3]);
+    }
+    printf("# threads: %d, write percentage: %.2f, locks: %d\n",
+           numberOfThreads,
+           writePercentage * 100.0,
+           numberOfLocks);
+    printf("# read indicator      bytes/lock  ops/us\n");
+    for(int width = MRQD_LOCK_NUMBER_OF_READER_GROUPS; width >= 1; width = width / 4){
+        double bytesPerLock;
+        double throughput = run_benchmark(numberOfThreads, width, &bytesPerLock);
+        printf("  width %-12d  %10.0f  %6.2f\n", width, bytesPerLock, throughput);
+    }
+    double bytesPerLock;
+    double throughput = run_benchmark(numberOfThreads, SHARED_READ_INDICATOR_WIDTH, &bytesPerLock);
+    printf("  %-18s  %10.0f  %6.2f\n", "shared", bytesPerLock, throughput);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+
+#include "locks/locks.h"
+
+/* Writer acquisition latency benchmark
+
+   Measures the average time for LL_lock + LL_unlock in a writer thread
+   while a growing number of reader threads use LL_rlock. The readers
+   do local work between their read critical sections. The writer
+   therefore mostly sees a few or no readers and the latency is
+   dominated by the read indicator scan.
+
+   Usage: writer_latency_benchmark [LOCK_TYPE] [MAX_THREADS] [READER_THINK_ITERATIONS] */
+
+#define WRITER_ACQUISITIONS 200000
+
+OOLock * lock;
+LLPaddedBool stop;
+unsigned long readerThinkIterations = 1000;
+
+void * reader_thread(void * unused){
+    UNUSED(unused);
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        LL_rlock(lock);
+        LL_runlock(lock);
+        for(unsigned long i = 0; i < readerThinkIterations; i++){
+            __asm__ __volatile__("" : : : "memory");
+        }
+    }
+    return NULL;
+}
+
+double measure_writer_latency(LL_lock_type_name lockType, int numberOfReaders){
+    pthread_t readers[numberOfReaders];
+    lock = LL_create(lockType);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < numberOfReaders; i++){
+        pthread_create(&readers[i], NULL, &reader_thread, NULL);
+    }
+    uint64_t start = ll_now_nanos();
+    for(int i = 0; i < WRITER_ACQUISITIONS; i++){
+        LL_lock(lock);
+        LL_unlock(lock);
+    }
+    uint64_t elapsed = ll_now_nanos() - start;
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < numberOfReaders; i++){
+        pthread_join(readers[i], NULL);
+    }
+    LL_free(lock);
+    return (double)elapsed / WRITER_ACQUISITIONS;
+}
+
+int main(int argc, char **argv){
+    LL_lock_type_name lockType = MRQD_LOCK;
+    const char * lockTypeName = "MRQD_LOCK";
+    int maxThreads = 16;
+    if(argc > 1){
+        lockTypeName = argv[1];
+        if(strcmp("MRQD_LOCK", argv[1]) == 0){
+            lockType = MRQD_LOCK;
+        }else if(strcmp("DRMCS_LOCK", argv[1]) == 0){
+            lockType = DRMCS_LOCK;
+        }else{
+            printf("Give MRQD_LOCK or DRMCS_LOCK as lock type\n");
+            return 1;
+        }
+    }
+    if(argc > 2){
+        maxThreads = atoi(argv[2]);
+    }
+    if(argc > 3){
+        readerThinkIterations = strtoul(argv[3], NULL, 10);
+    }
+    printf("# lock type: %s, reader think iterations: %lu\n",
+           lockTypeName,
+           readerThinkIterations);
+    printf("# threads  writer lock+unlock (ns)\n");
+    for(int threads = 1; threads <= maxThreads; threads = threads * 2){
+        printf("%9d  %.1f\n", threads, measure_writer_latency(lockType, threads - 1));
+    }
+    return 0;
+}
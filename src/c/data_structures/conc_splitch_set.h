@@ -249,6 +249,7 @@ void csh_set_free(void * setParam){
         }
         free(subset->buckets);
         LL_unlock(lock);
+        LL_destroy(lock);
     }
     free(set);
 }
@@ -117,6 +117,30 @@ void * dequeue(ConcurrentQueue* q) {
     return res;
 }
 
+bool dequeue_if_not_empty(void* m) {
+    DeqMsg* msg = m;
+    *(msg->writeBack) = deq(&msg->queue->head,
+                            &msg->queue->tail);
+    return *(msg->writeBack) != NULL;
+}
+
+/* 
+ * Dequeue function that waits until the queue is not empty
+ */
+void * dequeue_blocking(ConcurrentQueue* q) {
+    void * res;
+    DeqMsg msg = {.queue = q, .writeBack = &res};
+    LL_wait_until(q->lock, dequeue_if_not_empty, &msg);
+    return res;
+}
+
+void * consumer(void * queue) {
+    int * v = dequeue_blocking(queue);
+    assert((*v) == 42);
+    free(v);
+    return NULL;
+}
+
 /* 
  * Test
  */
@@ -136,6 +160,12 @@ int main(){
     int * v = dequeue(queue);
     assert(v == NULL);
 
+    pthread_t consumerThread;
+    pthread_create(&consumerThread, NULL, consumer, queue);
+    int value = 42;
+    enqueue(queue, &value, sizeof(int));
+    pthread_join(consumerThread, NULL);
+
     free_concurrent_queue(queue);
 
     printf("SUCCESS!\n");
@@ -0,0 +1,292 @@
+#include "adaptive_lock.h"
+
+
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable ADAPTIVE_LOCK_METHOD_TABLE =
+{
+     .free = &free,
+     .lock = &adaptive_lock,
+     .unlock = &adaptive_unlock,
+     .is_locked = &adaptive_is_locked,
+     .try_lock = &adaptive_try_lock,
+     .rlock = &adaptive_lock,
+     .runlock = &adaptive_unlock,
+     .delegate = &adaptive_delegate,
+     .delegate_wait = &adaptive_delegate_wait,
+     .delegate_or_lock = &adaptive_delegate_or_lock,
+     .close_delegate_buffer = &adaptive_close_delegate_buffer,
+     .delegate_unlock = &adaptive_delegate_unlock,
+     .lock_timed = &adaptive_lock_timed,
+     .try_delegate = &adaptive_try_delegate,
+     .delegate_timed = &adaptive_delegate_timed,
+     .delegate_fence = &adaptive_delegate_fence
+};
+
+
+void adaptive_initialize(AdaptiveLock * lock){
+    tatas_initialize(&lock->mutexLock);
+    atomic_store_explicit(&lock->version.value, 0, memory_order_relaxed);
+    atomic_store_explicit(&lock->failedTryLocks.value, 0, memory_order_relaxed);
+    AdaptiveLockStats initialStats = {
+        .mode = ADAPTIVE_LOCK_MODE_INLINE,
+        .contentionScore = 0,
+        .modeSwitches = 0,
+        .inlineAcquisitions = 0,
+        .delegateAcquisitions = 0,
+        .delegatedOperations = 0
+    };
+    lock->holderData.value.stats = initialStats;
+    lock->holderData.value.queueOpen = false;
+    qdq_initialize(&lock->queue);
+}
+
+/* Called by the thread that just acquired the lock in a delegate
+   function. Makes the version odd. The queue is only opened in the
+   delegate mode. */
+static inline
+void adaptive_open(AdaptiveLock * l){
+    AdaptiveLockStats * stats = &l->holderData.value.stats;
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    if(stats->mode == ADAPTIVE_LOCK_MODE_DELEGATE){
+        l->holderData.value.queueOpen = true;
+        stats->delegateAcquisitions++;
+        qdq_open(&l->queue);
+    }else{
+        l->holderData.value.queueOpen = false;
+        stats->inlineAcquisitions++;
+    }
+}
+
+/* Flushes the queue if it is open, samples the contention, switches
+   mode if needed, increments the version and releases the lock */
+static inline
+void adaptive_close_and_unlock(AdaptiveLock * l){
+    AdaptiveLockStats * stats = &l->holderData.value.stats;
+    bool contended = false;
+    if(l->holderData.value.queueOpen){
+        unsigned long executed = qdq_flush(&l->queue);
+        stats->delegatedOperations = stats->delegatedOperations + executed;
+        contended = executed > 0;
+    }
+    if(atomic_load_explicit(&l->failedTryLocks.value, memory_order_relaxed) > 0){
+        atomic_store_explicit(&l->failedTryLocks.value, 0, memory_order_relaxed);
+        contended = true;
+    }
+    if(contended){
+        stats->contentionScore = stats->contentionScore + ADAPTIVE_LOCK_CONTENDED_INCREMENT;
+        if(stats->contentionScore > ADAPTIVE_LOCK_SCORE_MAX){
+            stats->contentionScore = ADAPTIVE_LOCK_SCORE_MAX;
+        }
+    }else if(stats->contentionScore > 0){
+        stats->contentionScore = stats->contentionScore - 1;
+    }
+    if(stats->mode == ADAPTIVE_LOCK_MODE_INLINE &&
+       stats->contentionScore >= ADAPTIVE_LOCK_DELEGATE_THRESHOLD){
+        stats->mode = ADAPTIVE_LOCK_MODE_DELEGATE;
+        stats->modeSwitches++;
+    }else if(stats->mode == ADAPTIVE_LOCK_MODE_DELEGATE &&
+             stats->contentionScore <= ADAPTIVE_LOCK_INLINE_THRESHOLD){
+        stats->mode = ADAPTIVE_LOCK_MODE_INLINE;
+        stats->modeSwitches++;
+    }
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_release);
+    tatas_unlock(&l->mutexLock);
+}
+
+static inline
+void adaptive_register_failed_try_lock(AdaptiveLock * l){
+    atomic_fetch_add_explicit(&l->failedTryLocks.value, 1, memory_order_relaxed);
+}
+
+
+void adaptive_lock(void * lock) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    tatas_lock(&l->mutexLock);
+}
+
+
+void adaptive_unlock(void * lock) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    tatas_unlock(&l->mutexLock);
+}
+
+
+bool adaptive_is_locked(void * lock){
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    return tatas_is_locked(&l->mutexLock);
+}
+
+
+bool adaptive_try_lock(void * lock) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    return tatas_try_lock(&l->mutexLock);
+}
+
+
+void adaptive_delegate(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    while(true) {
+        if(tatas_try_lock(&l->mutexLock)) {
+            adaptive_open(l);
+            funPtr(messageSize, messageAddress);
+            adaptive_close_and_unlock(l);
+            return;
+        } else if(qdq_enqueue(&l->queue,
+                              funPtr,
+                              messageSize,
+                              messageAddress)){
+            ll_delegate_fence_record(&l->version.value, 0, NULL);
+            return;
+        }
+        adaptive_register_failed_try_lock(l);
+        thread_yield();
+    }
+}
+
+
+void * adaptive_delegate_or_lock(void* lock,
+                                 unsigned int messageSize) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    void * buffer;
+    while(true) {
+        if(tatas_try_lock(&l->mutexLock)) {
+            adaptive_open(l);
+            return NULL;
+        } else if(NULL != (buffer = qdq_enqueue_get_buffer(&l->queue,
+                                                           messageSize))){
+            ll_delegate_fence_record(&l->version.value, 0, NULL);
+            return buffer;
+        }
+        adaptive_register_failed_try_lock(l);
+        thread_yield();
+    }
+}
+
+
+void adaptive_close_delegate_buffer(void * buffer,
+                                    void (*funPtr)(unsigned int, void *)){
+    qdq_enqueue_close_buffer(buffer, funPtr);
+}
+
+
+void adaptive_delegate_unlock(void* lock) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    adaptive_close_and_unlock(l);
+}
+
+
+void adaptive_executeAndWaitCS(unsigned int size, void * data){
+    char * buff = data;
+    volatile atomic_int * writeBackAddress = *((volatile atomic_int **)buff);
+    void (*csFunc)(unsigned int, void *) =
+        *((void (**)(unsigned int, void *))&(buff[sizeof(volatile atomic_int *)]));
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    void * csData = (void*)&(buff[metaDataSize]);
+    csFunc(size - metaDataSize, csData);
+    atomic_store_explicit(writeBackAddress, 0, memory_order_release);
+}
+
+
+void adaptive_delegate_wait(void* lock,
+                            void (*funPtr)(unsigned int, void *),
+                            unsigned int messageSize,
+                            void * messageAddress) {
+    volatile atomic_int waitVar = ATOMIC_VAR_INIT(1);
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    char * buff = adaptive_delegate_or_lock(lock,
+                                            metaDataSize + messageSize);
+    if(buff==NULL){
+        funPtr(messageSize, messageAddress);
+        adaptive_delegate_unlock(lock);
+    }else{
+        volatile atomic_int ** waitVarPtrAddress = (volatile atomic_int **)buff;
+        *waitVarPtrAddress = &waitVar;
+        void (**funPtrAdress)(unsigned int, void *) = (void (**)(unsigned int, void *))&buff[sizeof(volatile atomic_int *)];
+        *funPtrAdress = funPtr;
+        char * msgBuffer = (char *)messageAddress;
+        for(unsigned int i = metaDataSize; i < (messageSize + metaDataSize); i++){
+            buff[i] = msgBuffer[i - metaDataSize];
+        }
+        adaptive_close_delegate_buffer((void *)buff, adaptive_executeAndWaitCS);
+        while(atomic_load_explicit(&waitVar, memory_order_acquire)){
+            thread_yield();
+        }
+    }
+}
+
+
+bool adaptive_lock_timed(void * lock, uint64_t timeoutNanos) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    return tatas_lock_timed(&l->mutexLock, timeoutNanos);
+}
+
+
+bool adaptive_try_delegate(void* lock,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    if(tatas_try_lock(&l->mutexLock)) {
+        adaptive_open(l);
+        funPtr(messageSize, messageAddress);
+        adaptive_close_and_unlock(l);
+        return true;
+    }else if(qdq_enqueue(&l->queue,
+                         funPtr,
+                         messageSize,
+                         messageAddress)){
+        ll_delegate_fence_record(&l->version.value, 0, NULL);
+        return true;
+    }
+    return false;
+}
+
+
+bool adaptive_delegate_timed(void* lock,
+                             void (*funPtr)(unsigned int, void *),
+                             unsigned int messageSize,
+                             void * messageAddress,
+                             uint64_t timeoutNanos) {
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(true) {
+        if(adaptive_try_delegate(lock, funPtr, messageSize, messageAddress)) {
+            return true;
+        } else if(ll_deadline_passed(deadline)) {
+            return false;
+        }
+        adaptive_register_failed_try_lock(l);
+        thread_yield();
+    }
+}
+
+
+AdaptiveLockStats adaptive_stats(AdaptiveLock * lock){
+    return lock->holderData.value.stats;
+}
+
+
+AdaptiveLock * plain_adaptive_create(){
+    AdaptiveLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(AdaptiveLock));
+    adaptive_initialize(l);
+    return l;
+}
+
+
+OOLock * oo_adaptive_create(){
+    AdaptiveLock * l = plain_adaptive_create();
+    OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
+    ool->lock = l;
+    ool->m = &ADAPTIVE_LOCK_METHOD_TABLE;
+    return ool;
+}
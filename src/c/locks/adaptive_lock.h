@@ -0,0 +1,117 @@
+#ifndef ADAPTIVE_LOCK_H
+#define ADAPTIVE_LOCK_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "misc/padded_types.h"
+#include "locks/tatas_lock.h"
+#include "locks/delegate_fence.h"
+#include "qd_queues/qd_queue.h"
+#include "locks/oo_lock_interface.h"
+
+/* Adaptive Lock */
+
+// The adaptive lock is a QD lock that only opens its delegation queue
+// when the lock is contended. In the inline mode a delegated critical
+// section is executed under the lock as with a TATAS lock. In the
+// delegate mode the lock holder opens the queue and executes the
+// critical sections delegated by other threads as with a QD lock.
+//
+// The lock holder keeps a contention score that is increased when a
+// release finds that other threads failed to take the lock or that
+// critical sections were delegated to it, and decreased otherwise.
+// The mode is changed by the lock holder when the score crosses one
+// of the thresholds below.
+//
+// The version is odd while the lock is held by a delegate operation,
+// so that delegation fences work as with the QD lock (see
+// locks/delegate_fence.h).
+
+#define ADAPTIVE_LOCK_MODE_INLINE 0
+#define ADAPTIVE_LOCK_MODE_DELEGATE 1
+
+#ifndef ADAPTIVE_LOCK_SCORE_MAX
+#    define ADAPTIVE_LOCK_SCORE_MAX 64
+#endif
+#ifndef ADAPTIVE_LOCK_CONTENDED_INCREMENT
+#    define ADAPTIVE_LOCK_CONTENDED_INCREMENT 4
+#endif
+#ifndef ADAPTIVE_LOCK_DELEGATE_THRESHOLD
+#    define ADAPTIVE_LOCK_DELEGATE_THRESHOLD 32
+#endif
+#ifndef ADAPTIVE_LOCK_INLINE_THRESHOLD
+#    define ADAPTIVE_LOCK_INLINE_THRESHOLD 0
+#endif
+
+typedef struct {
+    int mode;
+    unsigned int contentionScore;
+    unsigned long modeSwitches;
+    unsigned long inlineAcquisitions;
+    unsigned long delegateAcquisitions;
+    unsigned long delegatedOperations;
+} AdaptiveLockStats;
+
+typedef union {
+    struct {
+        AdaptiveLockStats stats;
+        bool queueOpen;
+    } value;
+    char pad[CACHE_LINE_SIZE];
+} AdaptiveLockHolderData;
+
+typedef struct {
+    TATASLock mutexLock;
+    LLPaddedULong version;
+    LLPaddedULong failedTryLocks;
+    AdaptiveLockHolderData holderData; //Only written by the lock holder
+    QDQueue queue;
+} AdaptiveLock;
+
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable ADAPTIVE_LOCK_METHOD_TABLE;
+
+void adaptive_initialize(AdaptiveLock * lock);
+void adaptive_lock(void * lock);
+void adaptive_unlock(void * lock);
+bool adaptive_is_locked(void * lock);
+bool adaptive_try_lock(void * lock);
+void adaptive_delegate(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress);
+void * adaptive_delegate_or_lock(void* lock,
+                                 unsigned int messageSize);
+void adaptive_close_delegate_buffer(void * buffer,
+                                    void (*funPtr)(unsigned int, void *));
+void adaptive_delegate_unlock(void* lock);
+void adaptive_delegate_wait(void* lock,
+                            void (*funPtr)(unsigned int, void *),
+                            unsigned int messageSize,
+                            void * messageAddress);
+bool adaptive_lock_timed(void * lock, uint64_t timeoutNanos);
+bool adaptive_try_delegate(void* lock,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress);
+// See LL_delegate_fence in locks/locks.h
+static inline
+void adaptive_delegate_fence(void * lock){
+    AdaptiveLock *l = (AdaptiveLock*)lock;
+    ll_delegate_fence_version(&l->version.value);
+}
+bool adaptive_delegate_timed(void* lock,
+                             void (*funPtr)(unsigned int, void *),
+                             unsigned int messageSize,
+                             void * messageAddress,
+                             uint64_t timeoutNanos);
+// Returns a snapshot of the statistics of the lock. The values are
+// only exact when no thread is using the lock.
+AdaptiveLockStats adaptive_stats(AdaptiveLock * lock);
+AdaptiveLock * plain_adaptive_create();
+OOLock * oo_adaptive_create();
+
+#endif
@@ -0,0 +1,209 @@
+#include "biased_lock.h"
+
+/* The address of this variable identifies the current thread */
+__thread char biasedLockThreadIdentity;
+
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable BIASED_LOCK_METHOD_TABLE =
+{
+     .free = &free,
+     .lock = &biased_lock,
+     .unlock = &biased_unlock,
+     .is_locked = &biased_is_locked,
+     .try_lock = &biased_try_lock,
+     .rlock = &biased_lock,
+     .runlock = &biased_unlock,
+     .delegate = &biased_delegate,
+     .delegate_wait = &biased_delegate,
+     .delegate_or_lock = &biased_delegate_or_lock,
+     .close_delegate_buffer = NULL, /* Should never be called */
+     .delegate_unlock = &biased_unlock,
+     .lock_timed = &biased_lock_timed,
+     .try_delegate = &biased_try_delegate,
+     .delegate_timed = &biased_delegate_timed
+};
+
+
+void biased_initialize(BiasedLock * lock){
+    atomic_init(&lock->ownerData.owner, BIASED_LOCK_NO_OWNER);
+    atomic_init(&lock->ownerData.ownerInCS, 0);
+    atomic_init(&lock->revoked.value, 0);
+    tatas_initialize(&lock->mutexLock);
+    ll_asymmetric_fence_initialize();
+}
+
+/* Returns true if the current thread is the owner. The first thread
+   that calls this function becomes the owner. */
+static inline
+bool biased_check_owner(BiasedLock * l){
+    intptr_t me = (intptr_t)&biasedLockThreadIdentity;
+    intptr_t owner = atomic_load_explicit(&l->ownerData.owner, memory_order_relaxed);
+    if(owner == BIASED_LOCK_NO_OWNER){
+        atomic_compare_exchange_strong(&l->ownerData.owner, &owner, me);
+        owner = atomic_load_explicit(&l->ownerData.owner, memory_order_relaxed);
+    }
+    return owner == me;
+}
+
+/* Fast path for the owner. Only plain stores and loads are used. */
+static inline
+bool biased_owner_try_lock(BiasedLock * l){
+    atomic_store_explicit(&l->ownerData.ownerInCS, 1, memory_order_relaxed);
+    ll_light_fence();
+    if(!atomic_load_explicit(&l->revoked.value, memory_order_acquire)){
+        return true;
+    }
+    atomic_store_explicit(&l->ownerData.ownerInCS, 0, memory_order_relaxed);
+    return false;
+}
+
+/* Revokes the bias. Must be called with the mutex lock held. Returns
+   false if the owner did not leave its critical section before the
+   deadline. The bias is restored in that case. */
+static inline
+bool biased_revoke_until(BiasedLock * l, uint64_t deadline){
+    atomic_store_explicit(&l->revoked.value, 1, memory_order_relaxed);
+    ll_heavy_fence();
+    while(atomic_load_explicit(&l->ownerData.ownerInCS, memory_order_acquire)){
+        if(ll_deadline_passed(deadline)){
+            atomic_store_explicit(&l->revoked.value, 0, memory_order_release);
+            return false;
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+
+void biased_lock(void * lock) {
+    BiasedLock *l = (BiasedLock*)lock;
+    if(biased_check_owner(l)){
+        if(biased_owner_try_lock(l)){
+            return;
+        }
+        tatas_lock(&l->mutexLock);
+        return;
+    }
+    tatas_lock(&l->mutexLock);
+    biased_revoke_until(l, UINT64_MAX);
+}
+
+
+void biased_unlock(void * lock) {
+    BiasedLock *l = (BiasedLock*)lock;
+    if(atomic_load_explicit(&l->ownerData.ownerInCS, memory_order_relaxed) &&
+       biased_check_owner(l)){
+        atomic_store_explicit(&l->ownerData.ownerInCS, 0, memory_order_release);
+        return;
+    }
+    atomic_store_explicit(&l->revoked.value, 0, memory_order_release);
+    tatas_unlock(&l->mutexLock);
+}
+
+
+bool biased_is_locked(void * lock){
+    BiasedLock *l = (BiasedLock*)lock;
+    return atomic_load(&l->ownerData.ownerInCS) ||
+        tatas_is_locked(&l->mutexLock);
+}
+
+
+bool biased_try_lock(void * lock) {
+    BiasedLock *l = (BiasedLock*)lock;
+    bool owner = biased_check_owner(l);
+    if(owner && biased_owner_try_lock(l)){
+        return true;
+    }
+    if(!tatas_try_lock(&l->mutexLock)){
+        return false;
+    }
+    if(owner || biased_revoke_until(l, 0)){
+        return true;
+    }
+    tatas_unlock(&l->mutexLock);
+    return false;
+}
+
+
+bool biased_lock_timed(void * lock, uint64_t timeoutNanos) {
+    BiasedLock *l = (BiasedLock*)lock;
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    bool owner = biased_check_owner(l);
+    if(owner && biased_owner_try_lock(l)){
+        return true;
+    }
+    if(!tatas_lock_until(&l->mutexLock, deadline)){
+        return false;
+    }
+    if(owner || biased_revoke_until(l, deadline)){
+        return true;
+    }
+    tatas_unlock(&l->mutexLock);
+    return false;
+}
+
+
+void biased_delegate(void * lock,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress){
+    biased_lock(lock);
+    funPtr(messageSize, messageAddress);
+    biased_unlock(lock);
+}
+
+
+void * biased_delegate_or_lock(void * lock, unsigned int messageSize){
+    (void)messageSize;
+    biased_lock(lock);
+    return NULL;
+}
+
+
+bool biased_try_delegate(void * lock,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress){
+    if(!biased_try_lock(lock)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    biased_unlock(lock);
+    return true;
+}
+
+
+bool biased_delegate_timed(void * lock,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress,
+                           uint64_t timeoutNanos){
+    if(!biased_lock_timed(lock, timeoutNanos)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    biased_unlock(lock);
+    return true;
+}
+
+
+bool biased_is_owner(BiasedLock * lock){
+    return atomic_load_explicit(&lock->ownerData.owner, memory_order_relaxed) ==
+        (intptr_t)&biasedLockThreadIdentity;
+}
+
+
+BiasedLock * plain_biased_create(){
+    BiasedLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(BiasedLock));
+    biased_initialize(l);
+    return l;
+}
+
+
+OOLock * oo_biased_create(){
+    BiasedLock * l = plain_biased_create();
+    OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
+    ool->lock = l;
+    ool->m = &BIASED_LOCK_METHOD_TABLE;
+    return ool;
+}
@@ -0,0 +1,74 @@
+#ifndef BIASED_LOCK_H
+#define BIASED_LOCK_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "misc/padded_types.h"
+#include "misc/asymmetric_fence.h"
+#include "locks/tatas_lock.h"
+#include "locks/oo_lock_interface.h"
+
+/* Biased Lock */
+
+// The biased lock is biased towards an owner thread. The owner is the
+// first thread that acquires the lock. The owner acquires and releases
+// the lock with plain loads and stores and a compiler barrier, without
+// any atomic read-modify-write instruction.
+//
+// Other threads take the TATAS lock and then revoke the bias with a
+// handshake. They set the revocation flag, execute a heavy asymmetric
+// fence (membarrier) and wait until the owner has left its critical
+// section. The bias is only revoked while the other thread holds the
+// lock. An owner that finds the revocation flag set takes the TATAS
+// lock like any other thread.
+//
+// The lock pays off when almost all acquisitions are done by the
+// owner. An acquisition by another thread costs a membarrier system
+// call.
+
+#define BIASED_LOCK_NO_OWNER ((intptr_t)0)
+
+typedef struct {
+    volatile atomic_intptr_t owner;
+    volatile atomic_int ownerInCS; //Only written by the owner
+    char pad[CACHE_LINE_SIZE_PAD(sizeof(atomic_intptr_t) + sizeof(atomic_int))];
+} BiasedLockOwnerData;
+
+typedef struct {
+    BiasedLockOwnerData ownerData;
+    LLPaddedInt revoked;
+    TATASLock mutexLock;
+} BiasedLock;
+
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable BIASED_LOCK_METHOD_TABLE;
+
+void biased_initialize(BiasedLock * lock);
+void biased_lock(void * lock);
+void biased_unlock(void * lock);
+bool biased_is_locked(void * lock);
+bool biased_try_lock(void * lock);
+void biased_delegate(void * lock,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress);
+void * biased_delegate_or_lock(void * lock, unsigned int messageSize);
+bool biased_lock_timed(void * lock, uint64_t timeoutNanos);
+bool biased_try_delegate(void * lock,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress);
+bool biased_delegate_timed(void * lock,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress,
+                           uint64_t timeoutNanos);
+// Returns true if the current thread is the owner of the lock
+bool biased_is_owner(BiasedLock * lock);
+BiasedLock * plain_biased_create();
+OOLock * oo_biased_create();
+
+#endif
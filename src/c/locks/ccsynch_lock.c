@@ -3,6 +3,8 @@
 _Alignas(CACHE_LINE_SIZE)
 __thread CCSynchLockNode * ccsynchNextLocalNode = NULL;
 
+__thread CCSynchLockNode * ccsynchAbandonedNodes = NULL;
+
 
 _Alignas(CACHE_LINE_SIZE)
 OOLockMethodTable CCSYNCH_LOCK_METHOD_TABLE = 
@@ -18,7 +20,10 @@ OOLockMethodTable CCSYNCH_LOCK_METHOD_TABLE =
      .delegate_wait = &ccsynch_delegate,
      .delegate_or_lock = &ccsynch_delegate_or_lock,
      .close_delegate_buffer = &ccsynch_close_delegate_buffer,
-     .delegate_unlock = &ccsynch_delegate_unlock
+     .delegate_unlock = &ccsynch_delegate_unlock,
+     .lock_timed = &ccsynch_lock_timed,
+     .try_delegate = &ccsynch_try_delegate,
+     .delegate_timed = &ccsynch_delegate_timed
 };
 
 
@@ -28,15 +33,66 @@ void ccsynchlock_initNode(CCSynchLockNode * node){
     node->messageSize = CCSYNCH_BUFFER_SIZE + 1;
     atomic_store_explicit(&node->wait, 0, memory_order_relaxed);
     node->completed = false;
+    node->nextAbandoned = NULL;
     volatile atomic_uintptr_t tmp = ATOMIC_VAR_INIT((uintptr_t)NULL);
     node->next = tmp;
 }
 
+static
+CCSynchLockNode * ccsynchlock_reclaimAbandonedNode(){
+    CCSynchLockNode ** prevPtr = &ccsynchAbandonedNodes;
+    CCSynchLockNode * node = ccsynchAbandonedNodes;
+    while(node != NULL){
+        if(atomic_load_explicit(&node->wait, memory_order_acquire) == CCSYNCH_WAIT_RELEASED){
+            *prevPtr = node->nextAbandoned;
+            ccsynchlock_initNode(node);
+            return node;
+        }
+        prevPtr = &node->nextAbandoned;
+        node = node->nextAbandoned;
+    }
+    return NULL;
+}
+
 static inline
 void ccsynchlock_initLocalIfNeeded(){
     if(ccsynchNextLocalNode == NULL){
-        ccsynchNextLocalNode = aligned_alloc(CACHE_LINE_SIZE, sizeof(CCSynchLockNode));
-        ccsynchlock_initNode(ccsynchNextLocalNode);
+        ccsynchNextLocalNode = ccsynchlock_reclaimAbandonedNode();
+        if(ccsynchNextLocalNode == NULL){
+            ccsynchNextLocalNode = aligned_alloc(CACHE_LINE_SIZE, sizeof(CCSynchLockNode));
+            ccsynchlock_initNode(ccsynchNextLocalNode);
+        }
+    }
+}
+
+/* Tries to give up the place in the queue that the current local
+   node holds. Returns false if the lock was handed over to the node
+   before it could be abandoned. */
+static inline
+bool ccsynchlock_abandonLocalNode(){
+    CCSynchLockNode * node = ccsynchNextLocalNode;
+    int expected = 1;
+    if(atomic_compare_exchange_strong(&node->wait, &expected, CCSYNCH_WAIT_ABANDONED)){
+        node->nextAbandoned = ccsynchAbandonedNodes;
+        ccsynchAbandonedNodes = node;
+        ccsynchNextLocalNode = NULL;
+        return true;
+    }
+    return false;
+}
+
+/* Hands over the lock to node. Abandoned nodes are skipped. */
+static inline
+void ccsynch_hand_off(CCSynchLockNode * node){
+    int expected = 1;
+    while(!atomic_compare_exchange_strong(&node->wait, &expected, 0)){
+        CCSynchLockNode * next;
+        while(NULL == (next = (CCSynchLockNode *)atomic_load_explicit(&node->next, memory_order_acquire))){
+            thread_yield();
+        }
+        atomic_store_explicit(&node->wait, CCSYNCH_WAIT_RELEASED, memory_order_release);
+        node = next;
+        expected = 1;
     }
 }
 
@@ -83,7 +139,7 @@ void ccsynch_unlock(void * lock) {
         atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
         tmpNode = tmpNodeNext;
     }
-    atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
+    ccsynch_hand_off(tmpNode);
 }
 
 bool ccsynch_is_locked(void * lock) {
@@ -94,12 +150,30 @@ bool ccsynch_is_locked(void * lock) {
 
 
 bool ccsynch_try_lock(void * lock) {
-    if(ccsynch_is_locked(lock)){
+    CCSynchLock *l = (CCSynchLock*)lock;
+    CCSynchLockNode *nextNode;
+    CCSynchLockNode *curNode;
+    ccsynchlock_initLocalIfNeeded();
+    curNode = (CCSynchLockNode *)atomic_load_explicit(&l->tailPtr.value, memory_order_acquire);
+    if(atomic_load_explicit(&curNode->wait, memory_order_acquire) != 0){
         return false;
-    }else{
-        ccsynch_lock(lock);
+    }
+    nextNode = ccsynchNextLocalNode;
+    atomic_store_explicit(&nextNode->next, (uintptr_t)NULL, memory_order_relaxed);
+    atomic_store_explicit(&nextNode->wait, 1, memory_order_relaxed);
+    nextNode->completed = false;
+    uintptr_t expected = (uintptr_t)curNode;
+    if(!atomic_compare_exchange_strong(&l->tailPtr.value, &expected, (uintptr_t)nextNode)){
+        return false;
+    }
+    curNode->requestFunction = NULL;
+    atomic_store_explicit(&curNode->next, (uintptr_t)nextNode, memory_order_release);
+    ccsynchNextLocalNode = curNode;
+    if(atomic_load_explicit(&curNode->wait, memory_order_acquire) == 0){
         return true;
     }
+    //The tail node was reused before the CAS so we ended up in the queue
+    return !ccsynchlock_abandonLocalNode();
 }
 
 
@@ -146,7 +220,7 @@ void ccsynch_delegate(void* lock,
         atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
         tmpNode = tmpNodeNext;
     }
-    atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
+    ccsynch_hand_off(tmpNode);
 }
 
 
@@ -209,7 +283,7 @@ void ccsynch_close_delegate_buffer(void * buffer,
         atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
         tmpNode = tmpNodeNext;
     }
-    atomic_store_explicit(&tmpNode->wait, 0, memory_order_release);
+    ccsynch_hand_off(tmpNode);
 }
 
 
@@ -218,6 +292,57 @@ void ccsynch_delegate_unlock(void* lock) {
 }
 
 
+bool ccsynch_lock_timed(void * lock, uint64_t timeoutNanos) {
+    CCSynchLock *l = (CCSynchLock*)lock;
+    CCSynchLockNode *nextNode;
+    CCSynchLockNode *curNode;
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    ccsynchlock_initLocalIfNeeded();
+    nextNode = ccsynchNextLocalNode;
+    atomic_store_explicit(&nextNode->next, (uintptr_t)NULL, memory_order_relaxed);
+    atomic_store_explicit(&nextNode->wait, 1, memory_order_relaxed);
+    nextNode->completed = false;
+    curNode = (CCSynchLockNode *)atomic_exchange_explicit( &l->tailPtr.value, (uintptr_t)nextNode, memory_order_release);
+    curNode->requestFunction = NULL;
+    atomic_store_explicit(&curNode->next, (uintptr_t)nextNode, memory_order_release);
+    ccsynchNextLocalNode = curNode;
+    while (atomic_load_explicit(&curNode->wait, memory_order_acquire) == 1){
+        if(ll_deadline_passed(deadline)){
+            return !ccsynchlock_abandonLocalNode();
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+
+bool ccsynch_try_delegate(void* lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress) {
+    if(!ccsynch_try_lock(lock)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    ccsynch_unlock(lock);
+    return true;
+}
+
+
+bool ccsynch_delegate_timed(void* lock,
+                            void (*funPtr)(unsigned int, void *), 
+                            unsigned int messageSize,
+                            void * messageAddress,
+                            uint64_t timeoutNanos) {
+    if(!ccsynch_lock_timed(lock, timeoutNanos)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    ccsynch_unlock(lock);
+    return true;
+}
+
+
 CCSynchLock * plain_ccsynch_create(){
     CCSynchLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(CCSynchLock));
     ccsynch_initialize(l);
@@ -9,6 +9,7 @@
 
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
 #include "misc/thread_includes.h"//Until c11 thread.h is available
+#include "misc/timing.h"
 #include <stdbool.h>
 
 #include "misc/padded_types.h"
@@ -17,18 +18,24 @@
 #define CCSYNCH_BUFFER_SIZE 512
 #define CCSYNCH_HAND_OFF_LIMIT 512
 
-typedef struct {
+// Values of the wait field besides 0 (go) and 1 (wait). A thread that
+// gives up waiting for the lock marks its node as abandoned. The
+// thread that hands the lock over to an abandoned node passes it on
+// to the next node instead and marks the abandoned node as released
+// so that its owner can reuse it.
+#define CCSYNCH_WAIT_ABANDONED 2
+#define CCSYNCH_WAIT_RELEASED 3
+
+typedef struct CCSynchLockNodeImpl {
     volatile atomic_uintptr_t next;
     void (*requestFunction)(unsigned int, void *);
     volatile atomic_int wait;
     unsigned int messageSize;
     unsigned char * buffer;
     bool completed;
-    char pad2[CACHE_LINE_SIZE_PAD(sizeof(void *)*2 + 
-                                  sizeof(unsigned int) +
-                                  sizeof(char *) +
-                                  sizeof(bool) +
-                                  sizeof(atomic_int))];
+    struct CCSynchLockNodeImpl * nextAbandoned;
+    // Starts at a cache line so that messages are aligned
+    _Alignas(CACHE_LINE_SIZE)
     unsigned char tempBuffer[CACHE_LINE_SIZE*8]; //used in ccsynch_delegate_or_lock 
 } CCSynchLockNode;
 
@@ -39,6 +46,10 @@ typedef struct {
 
 // Public interface
 
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable CCSYNCH_LOCK_METHOD_TABLE;
+
 void ccsynch_initialize(CCSynchLock * l);
 void ccsynch_lock(void * lock);
 void ccsynch_unlock(void * lock);
@@ -53,6 +64,16 @@ void * ccsynch_delegate_or_lock(void* lock,
 void ccsynch_close_delegate_buffer(void * buffer,
                                    void (*funPtr)(unsigned int, void *));
 void ccsynch_delegate_unlock(void* lock);
+bool ccsynch_lock_timed(void * lock, uint64_t timeoutNanos);
+bool ccsynch_try_delegate(void* lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress);
+bool ccsynch_delegate_timed(void* lock,
+                            void (*funPtr)(unsigned int, void *), 
+                            unsigned int messageSize,
+                            void * messageAddress,
+                            uint64_t timeoutNanos);
 CCSynchLock * plain_ccsynch_create();
 OOLock * oo_ccsynch_create();
 
@@ -0,0 +1,361 @@
+#include "compact_qd_lock.h"
+
+
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable COMPACT_QD_LOCK_METHOD_TABLE =
+{
+     .free = &cqd_free,
+     .lock = &cqd_lock,
+     .unlock = &cqd_unlock,
+     .is_locked = &cqd_is_locked,
+     .try_lock = &cqd_try_lock,
+     .rlock = &cqd_lock,
+     .runlock = &cqd_unlock,
+     .delegate = &cqd_delegate,
+     .delegate_wait = &cqd_delegate_wait,
+     .delegate_or_lock = &cqd_delegate_or_lock,
+     .close_delegate_buffer = &cqd_close_delegate_buffer,
+     .delegate_unlock = &cqd_delegate_unlock,
+     .lock_timed = &cqd_lock_timed,
+     .try_delegate = &cqd_try_delegate,
+     .delegate_timed = &cqd_delegate_timed,
+     .delegate_fence = &cqd_delegate_fence
+};
+
+
+/* Queue pool */
+
+static volatile atomic_int cqdPoolLock = ATOMIC_VAR_INIT(0);
+static CQDPooledQueue * cqdPoolFreeList = NULL;
+static volatile atomic_ulong cqdPoolAllocatedQueues = ATOMIC_VAR_INIT(0);
+
+
+static void cqd_pool_lock(){
+    while(atomic_load_explicit(&cqdPoolLock, memory_order_acquire) ||
+          atomic_exchange(&cqdPoolLock, 1)){
+        thread_yield();
+    }
+}
+
+
+static void cqd_pool_unlock(){
+    atomic_store_explicit(&cqdPoolLock, 0, memory_order_release);
+}
+
+
+static CQDPooledQueue * cqd_pool_get(){
+    cqd_pool_lock();
+    CQDPooledQueue * q = cqdPoolFreeList;
+    if(q != NULL){
+        cqdPoolFreeList = q->next;
+    }
+    cqd_pool_unlock();
+    if(q == NULL){
+        q = aligned_alloc(CACHE_LINE_SIZE, sizeof(CQDPooledQueue));
+        atomic_store(&q->users, 0);
+        qdq_initialize(&q->queue);
+        atomic_fetch_add(&cqdPoolAllocatedQueues, 1);
+    }
+    return q;
+}
+
+
+/* The queue has to be closed and flushed */
+static void cqd_pool_put(CQDPooledQueue * q){
+    cqd_pool_lock();
+    q->next = cqdPoolFreeList;
+    cqdPoolFreeList = q;
+    cqd_pool_unlock();
+}
+
+
+unsigned long cqd_pool_allocated_queues(){
+    return atomic_load(&cqdPoolAllocatedQueues);
+}
+
+
+/* Queue attachment */
+
+static void cqd_attach_queue(CompactQDLock * l){
+    CQDPooledQueue * q = cqd_pool_get();
+    uintptr_t expected = 0;
+    if(!atomic_compare_exchange_strong(&l->queue, &expected, (uintptr_t)q)){
+        cqd_pool_put(q);
+    }
+}
+
+
+/* Only called by the lock holder. Waits for delegating threads that
+   may still use the queue before it is put back in the pool. */
+static void cqd_detach_queue(CompactQDLock * l, CQDPooledQueue * q){
+    atomic_store(&l->queue, 0);
+    while(atomic_load(&q->users) > 0){
+        thread_yield();
+    }
+    cqd_pool_put(q);
+}
+
+
+/* Returns the attached queue with the users count incremented, or
+   NULL if there is no attached queue. Attaches a queue if there is
+   none, so that a later holder can open it. */
+static CQDPooledQueue * cqd_enter_queue(CompactQDLock * l){
+    CQDPooledQueue * q = (CQDPooledQueue *)atomic_load(&l->queue);
+    if(q == NULL){
+        cqd_attach_queue(l);
+        return NULL;
+    }
+    atomic_fetch_add(&q->users, 1);
+    if((CQDPooledQueue *)atomic_load(&l->queue) != q){
+        atomic_fetch_sub(&q->users, 1);
+        return NULL;
+    }
+    return q;
+}
+
+
+static void cqd_leave_queue(CQDPooledQueue * q){
+    atomic_fetch_sub_explicit(&q->users, 1, memory_order_release);
+}
+
+
+/* Called after the lock has been taken by a delegate operation. Makes
+   the version odd. */
+static void cqd_open_queue(CompactQDLock * l){
+    unsigned long version = atomic_load_explicit(&l->version, memory_order_relaxed);
+    atomic_store_explicit(&l->version, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    CQDPooledQueue * q = (CQDPooledQueue *)atomic_load(&l->queue);
+    l->openedQueue = q;
+    if(q != NULL){
+        qdq_open(&q->queue);
+    }
+}
+
+
+static bool cqd_try_enqueue(CompactQDLock * l,
+                            void (*funPtr)(unsigned int, void *),
+                            unsigned int messageSize,
+                            void * messageAddress){
+    CQDPooledQueue * q = cqd_enter_queue(l);
+    if(q == NULL){
+        return false;
+    }
+    bool enqueued = qdq_enqueue(&q->queue, funPtr, messageSize, messageAddress);
+    cqd_leave_queue(q);
+    if(enqueued){
+        ll_delegate_fence_record(&l->version, 0, NULL);
+    }
+    return enqueued;
+}
+
+
+/* Lock */
+
+void cqd_initialize(CompactQDLock * lock){
+    atomic_store(&lock->locked, 0);
+    atomic_store(&lock->queue, 0);
+    lock->openedQueue = NULL;
+    atomic_store(&lock->version, 0);
+}
+
+
+void cqd_destroy(CompactQDLock * lock){
+    CQDPooledQueue * q = (CQDPooledQueue *)atomic_load(&lock->queue);
+    if(q != NULL){
+        cqd_detach_queue(lock, q);
+    }
+}
+
+
+void cqd_free(void * lock){
+    cqd_destroy((CompactQDLock *)lock);
+    free(lock);
+}
+
+
+bool cqd_try_lock(void * lock) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    return !atomic_load_explicit(&l->locked, memory_order_acquire) &&
+        !atomic_exchange(&l->locked, 1);
+}
+
+
+void cqd_lock(void * lock) {
+    while(!cqd_try_lock(lock)){
+        thread_yield();
+    }
+}
+
+
+void cqd_unlock(void * lock) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    atomic_store_explicit(&l->locked, 0, memory_order_release);
+}
+
+
+void cqd_delegate_unlock(void* lock) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    CQDPooledQueue * q = l->openedQueue;
+    if(q != NULL){
+        l->openedQueue = NULL;
+        if(qdq_flush(&q->queue) == 0){
+            //Nobody delegated while the lock was held
+            cqd_detach_queue(l, q);
+        }
+    }
+    unsigned long version = atomic_load_explicit(&l->version, memory_order_relaxed);
+    atomic_store_explicit(&l->version, version + 1, memory_order_release);
+    cqd_unlock(l);
+}
+
+
+void cqd_delegate(void* lock,
+                  void (*funPtr)(unsigned int, void *),
+                  unsigned int messageSize,
+                  void * messageAddress) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    while(true) {
+        if(cqd_try_lock(l)) {
+            cqd_open_queue(l);
+            funPtr(messageSize, messageAddress);
+            cqd_delegate_unlock(l);
+            return;
+        } else if(cqd_try_enqueue(l, funPtr, messageSize, messageAddress)){
+            return;
+        }
+        thread_yield();
+    }
+}
+
+
+void * cqd_delegate_or_lock(void* lock,
+                            unsigned int messageSize) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    while(true) {
+        if(cqd_try_lock(l)) {
+            cqd_open_queue(l);
+            return NULL;
+        }
+        CQDPooledQueue * q = cqd_enter_queue(l);
+        if(q != NULL){
+            /* The holder's flush waits for the buffer to be closed, so
+               the queue can not be detached before that */
+            void * buffer = qdq_enqueue_get_buffer(&q->queue, messageSize);
+            cqd_leave_queue(q);
+            if(buffer != NULL){
+                ll_delegate_fence_record(&l->version, 0, NULL);
+                return buffer;
+            }
+        }
+        thread_yield();
+    }
+}
+
+
+void cqd_close_delegate_buffer(void * buffer,
+                               void (*funPtr)(unsigned int, void *)){
+    qdq_enqueue_close_buffer(buffer, funPtr);
+}
+
+
+static void cqd_executeAndWaitCS(unsigned int size, void * data){
+    char * buff = data;
+    volatile atomic_int * writeBackAddress = *((volatile atomic_int **)buff);
+    void (*csFunc)(unsigned int, void *) =
+        *((void (**)(unsigned int, void *))&(buff[sizeof(volatile atomic_int *)]));
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    void * csData = (void*)&(buff[metaDataSize]);
+    csFunc(size - metaDataSize, csData);
+    atomic_store_explicit(writeBackAddress, 0, memory_order_release);
+}
+
+
+void cqd_delegate_wait(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress) {
+    volatile atomic_int waitVar = ATOMIC_VAR_INIT(1);
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    char * buff = cqd_delegate_or_lock(lock,
+                                       metaDataSize + messageSize);
+    if(buff==NULL){
+        funPtr(messageSize, messageAddress);
+        cqd_delegate_unlock(lock);
+    }else{
+        volatile atomic_int ** waitVarPtrAddress = (volatile atomic_int **)buff;
+        *waitVarPtrAddress = &waitVar;
+        void (**funPtrAdress)(unsigned int, void *) = (void (**)(unsigned int, void *))&buff[sizeof(volatile atomic_int *)];
+        *funPtrAdress = funPtr;
+        char * msgBuffer = (char *)messageAddress;
+        for(unsigned int i = metaDataSize; i < (messageSize + metaDataSize); i++){
+            buff[i] = msgBuffer[i - metaDataSize];
+        }
+        cqd_close_delegate_buffer((void *)buff, cqd_executeAndWaitCS);
+        while(atomic_load_explicit(&waitVar, memory_order_acquire)){
+            thread_yield();
+        }
+    }
+}
+
+
+bool cqd_lock_timed(void * lock, uint64_t timeoutNanos) {
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(!cqd_try_lock(lock)){
+        if(ll_deadline_passed(deadline)){
+            return false;
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+
+bool cqd_try_delegate(void* lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress) {
+    CompactQDLock *l = (CompactQDLock*)lock;
+    if(cqd_try_lock(l)) {
+        cqd_open_queue(l);
+        funPtr(messageSize, messageAddress);
+        cqd_delegate_unlock(l);
+        return true;
+    }
+    return cqd_try_enqueue(l, funPtr, messageSize, messageAddress);
+}
+
+
+
+bool cqd_delegate_timed(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos) {
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(true) {
+        if(cqd_try_delegate(lock, funPtr, messageSize, messageAddress)) {
+            return true;
+        } else if(ll_deadline_passed(deadline)) {
+            return false;
+        }
+        thread_yield();
+    }
+}
+
+
+CompactQDLock * plain_cqd_create(){
+    CompactQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(CompactQDLock));
+    cqd_initialize(l);
+    return l;
+}
+
+OOLock * oo_cqd_create(){
+    CompactQDLock * l = plain_cqd_create();
+    OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
+    ool->lock = l;
+    ool->m = &COMPACT_QD_LOCK_METHOD_TABLE;
+    return ool;
+}
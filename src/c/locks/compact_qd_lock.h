@@ -0,0 +1,110 @@
+#ifndef COMPACT_QD_LOCK_H
+#define COMPACT_QD_LOCK_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "misc/padded_types.h"
+#include "misc/timing.h"
+#include "qd_queues/qd_queue.h"
+#include "locks/delegate_fence.h"
+#include "locks/oo_lock_interface.h"
+
+/* Compact Queue Delegation Lock */
+
+// A queue delegation lock that fits in one cache line so that it can
+// be embedded in every object or hash bucket. The lock does not own a
+// queue. A thread that fails to take the lock attaches a queue from a
+// process wide pool to it. The queue is opened by the next thread that
+// takes the lock with a delegate operation, and delegated critical
+// sections are then queued as in the QD lock. A holder whose queue was
+// empty when it was flushed (the lock has gone idle) detaches the
+// queue and returns it to the pool.
+//
+// The first contended acquisitions therefore wait like with a plain
+// spin lock, and the pool only needs as many queues as there are
+// locks that are contended at the same time. Queues are never freed,
+// so a stale queue pointer always points to a queue. A delegating
+// thread announces itself in the users count of the queue and checks
+// that the queue is still attached before it enqueues. The holder
+// waits until the users count is zero before it puts a detached queue
+// back in the pool.
+//
+// The version is odd while the lock is held by a delegate operation,
+// so that delegation fences work as with the QD lock (see
+// locks/delegate_fence.h).
+
+typedef struct CQDPooledQueueImpl {
+    union {
+        struct {
+            volatile atomic_int users;
+            struct CQDPooledQueueImpl * next; //Only used in the pool
+        };
+        char pad[CACHE_LINE_SIZE];
+    };
+    QDQueue queue;
+} CQDPooledQueue;
+
+typedef union {
+    struct {
+        volatile atomic_int locked;
+        volatile atomic_uintptr_t queue; //CQDPooledQueue * or 0
+        CQDPooledQueue * openedQueue; //Only accessed by the lock holder
+        volatile atomic_ulong version;
+    };
+    char pad[CACHE_LINE_SIZE];
+} CompactQDLock;
+
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable COMPACT_QD_LOCK_METHOD_TABLE;
+
+void cqd_initialize(CompactQDLock * lock);
+// Returns an attached queue to the pool. The lock must not be held.
+void cqd_destroy(CompactQDLock * lock);
+// Destroys and frees a lock created with plain_cqd_create
+void cqd_free(void * lock);
+void cqd_lock(void * lock);
+void cqd_unlock(void * lock);
+static inline
+bool cqd_is_locked(void * lock){
+    CompactQDLock *l = (CompactQDLock*)lock;
+    return atomic_load(&l->locked);
+}
+bool cqd_try_lock(void * lock);
+void cqd_delegate(void* lock,
+                  void (*funPtr)(unsigned int, void *),
+                  unsigned int messageSize,
+                  void * messageAddress);
+void * cqd_delegate_or_lock(void* lock,
+                            unsigned int messageSize);
+void cqd_close_delegate_buffer(void * buffer,
+                               void (*funPtr)(unsigned int, void *));
+void cqd_delegate_unlock(void* lock);
+void cqd_delegate_wait(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress);
+bool cqd_lock_timed(void * lock, uint64_t timeoutNanos);
+bool cqd_try_delegate(void* lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress);
+// See LL_delegate_fence in locks/locks.h
+static inline
+void cqd_delegate_fence(void * lock){
+    CompactQDLock *l = (CompactQDLock*)lock;
+    ll_delegate_fence_version(&l->version);
+}
+bool cqd_delegate_timed(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos);
+// The number of queues allocated by the pool so far
+unsigned long cqd_pool_allocated_queues();
+CompactQDLock * plain_cqd_create();
+OOLock * oo_cqd_create();
+
+#endif
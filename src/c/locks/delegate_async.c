@@ -0,0 +1,170 @@
+#include "delegate_async.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "misc/error_help.h"
+
+#if defined(__linux__) && !defined(LL_NO_EVENTFD)
+#    include <sys/eventfd.h>
+#    define LL_HAS_EVENTFD 1
+#endif
+
+// Put in front of the message of an asynchronous delegation
+typedef struct {
+    LLCompletionRing * ring;
+    void * tag;
+    void (*funPtr)(unsigned int, void *);
+} LLAsyncMessageHeader;
+
+static void ll_completion_ring_open_fds(LLCompletionRing * ring){
+#ifdef LL_HAS_EVENTFD
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(fd < 0){
+        LL_error_and_exit("Could not create the eventfd of a completion ring\n");
+    }
+    ring->readFd = fd;
+    ring->writeFd = fd;
+#else
+    int fds[2];
+    if(pipe(fds) != 0){
+        LL_error_and_exit("Could not create the pipe of a completion ring\n");
+    }
+    for(int i = 0; i < 2; i++){
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    ring->readFd = fds[0];
+    ring->writeFd = fds[1];
+#endif
+}
+
+LLCompletionRing * ll_completion_ring_create(unsigned int capacity){
+    if(capacity == 0){
+        LL_error_and_exit("A completion ring needs a capacity of at least one\n");
+    }
+    LLCompletionRing * ring = aligned_alloc(CACHE_LINE_SIZE, sizeof(LLCompletionRing));
+    ring->capacity = capacity;
+    ring->reserved = 0;
+    ring->head = 0;
+    ring->completions = calloc(capacity, sizeof(LLCompletion));
+    if(ring->completions == NULL){
+        LL_error_and_exit("Could not allocate a completion ring\n");
+    }
+    for(unsigned int i = 0; i < capacity; i++){
+        atomic_store_explicit(&ring->completions[i].ready, false, memory_order_relaxed);
+    }
+    atomic_store(&ring->tail.value, 0);
+    atomic_store(&ring->signalled.value, false);
+    ll_completion_ring_open_fds(ring);
+    return ring;
+}
+
+void ll_completion_ring_free(LLCompletionRing * ring){
+    close(ring->readFd);
+    if(ring->writeFd != ring->readFd){
+        close(ring->writeFd);
+    }
+    free(ring->completions);
+    free(ring);
+}
+
+// Makes the descriptor readable unless it has been signalled since the
+// last harvest
+static void ll_completion_ring_signal(LLCompletionRing * ring){
+    if(atomic_exchange_explicit(&ring->signalled.value, true, memory_order_acq_rel)){
+        return;
+    }
+#ifdef LL_HAS_EVENTFD
+    uint64_t one = 1;
+    ssize_t written = write(ring->writeFd, &one, sizeof(one));
+#else
+    char one = 1;
+    ssize_t written = write(ring->writeFd, &one, sizeof(one));
+#endif
+    (void)written; //A full pipe is readable anyway
+}
+
+static void ll_completion_ring_clear_fd(LLCompletionRing * ring){
+#ifdef LL_HAS_EVENTFD
+    uint64_t count;
+    ssize_t readBytes = read(ring->readFd, &count, sizeof(count));
+    (void)readBytes;
+#else
+    char buffer[64];
+    while(read(ring->readFd, buffer, sizeof(buffer)) > 0){
+        // Empty the pipe
+    }
+#endif
+}
+
+unsigned int ll_completion_ring_harvest(LLCompletionRing * ring,
+                                        void ** tags,
+                                        unsigned int maxTags){
+    ll_completion_ring_clear_fd(ring);
+    // Completions that are written after this signal the descriptor
+    // again. The exchange makes the completions of the threads that
+    // found the ring signalled visible.
+    (void)atomic_exchange_explicit(&ring->signalled.value, false, memory_order_acq_rel);
+    unsigned int harvested = 0;
+    while(harvested < maxTags){
+        LLCompletion * completion = &ring->completions[ring->head % ring->capacity];
+        if(!atomic_load_explicit(&completion->ready, memory_order_acquire)){
+            return harvested;
+        }
+        tags[harvested] = (void *)atomic_load_explicit(&completion->tag, memory_order_relaxed);
+        atomic_store_explicit(&completion->ready, false, memory_order_relaxed);
+        ring->head = ring->head + 1;
+        ring->reserved = ring->reserved - 1;
+        harvested = harvested + 1;
+    }
+    // Keep the descriptor readable for the completions that are left
+    LLCompletion * next = &ring->completions[ring->head % ring->capacity];
+    if(atomic_load_explicit(&next->ready, memory_order_relaxed)){
+        ll_completion_ring_signal(ring);
+    }
+    return harvested;
+}
+
+// Executes the critical section of an asynchronous delegation and
+// writes the completion to the ring of the delegating thread
+static void ll_execute_async(unsigned int messageSize, void * messageAddress){
+    LLAsyncMessageHeader * header = (LLAsyncMessageHeader *)messageAddress;
+    LLCompletionRing * ring = header->ring;
+    void * tag = header->tag;
+    header->funPtr(messageSize - sizeof(LLAsyncMessageHeader),
+                   (char *)messageAddress + sizeof(LLAsyncMessageHeader));
+    // The owner has reserved a slot, so the slot is free
+    unsigned long index = atomic_fetch_add_explicit(&ring->tail.value, 1, memory_order_relaxed);
+    LLCompletion * completion = &ring->completions[index % ring->capacity];
+    atomic_store_explicit(&completion->tag, (uintptr_t)tag, memory_order_relaxed);
+    atomic_store_explicit(&completion->ready, true, memory_order_release);
+    ll_completion_ring_signal(ring);
+}
+
+bool ll_delegate_async(void * lock,
+                       void (*delegate)(void*,
+                                        void (*funPtr)(unsigned int, void *),
+                                        unsigned int messageSize,
+                                        void * messageAddress),
+                       LLCompletionRing * ring,
+                       void * tag,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress){
+    if(ring->reserved == ring->capacity){
+        return false;
+    }
+    ring->reserved = ring->reserved + 1;
+    _Alignas(LLAsyncMessageHeader)
+        char buffer[sizeof(LLAsyncMessageHeader) + messageSize];
+    LLAsyncMessageHeader * header = (LLAsyncMessageHeader *)buffer;
+    header->ring = ring;
+    header->tag = tag;
+    header->funPtr = funPtr;
+    memcpy(buffer + sizeof(LLAsyncMessageHeader), messageAddress, messageSize);
+    delegate(lock, ll_execute_async, sizeof(buffer), buffer);
+    return true;
+}
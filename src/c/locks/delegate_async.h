@@ -0,0 +1,78 @@
+#ifndef DELEGATE_ASYNC_H
+#define DELEGATE_ASYNC_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "misc/padded_types.h"
+
+/* Asynchronous Delegations with Completion Rings */
+
+// A thread that runs an event loop can not wait for delegated critical
+// sections. It delegates them with LL_delegate_async (see
+// locks/locks.h) and a completion ring that it owns instead. The
+// thread that executes a critical section, usually a lock holder,
+// writes the tag of the delegation to the ring after the critical
+// section and signals the file descriptor of the ring. The event loop
+// polls the descriptor together with its other descriptors and
+// harvests the tags when it becomes readable. Results are written by
+// the critical sections to memory that the message points to, as with
+// LL_delegate_wait.
+//
+// A ring has room for a fixed number of completions. A delegation
+// reserves a slot before it is sent and LL_delegate_async fails when
+// all slots are reserved, so the executing thread never waits for the
+// ring. The slot is released when the completion is harvested. Only
+// the first completion after a harvest signals the descriptor, so a
+// batch of completions costs one system call.
+//
+// The descriptor is an eventfd on Linux and the read end of a pipe
+// elsewhere (or when LL_NO_EVENTFD is defined). A ring must only be
+// used by the thread that created it.
+
+typedef struct {
+    volatile atomic_uintptr_t tag;
+    volatile atomic_bool ready;
+} LLCompletion;
+
+typedef struct {
+    // Only accessed by the owner
+    unsigned int capacity;
+    unsigned int reserved;
+    unsigned long head;
+    int readFd;
+    int writeFd;
+    LLCompletion * completions;
+    // Written by the executing threads
+    LLPaddedULong tail;
+    LLPaddedBool signalled;
+} LLCompletionRing;
+
+LLCompletionRing * ll_completion_ring_create(unsigned int capacity);
+void ll_completion_ring_free(LLCompletionRing * ring);
+
+// The file descriptor that becomes readable when there are completions
+static inline
+int ll_completion_ring_fd(LLCompletionRing * ring){
+    return ring->readFd;
+}
+
+// Writes the tags of at most maxTags completions to tags and returns
+// the number of written tags. Never blocks.
+unsigned int ll_completion_ring_harvest(LLCompletionRing * ring,
+                                        void ** tags,
+                                        unsigned int maxTags);
+
+bool ll_delegate_async(void * lock,
+                       void (*delegate)(void*,
+                                        void (*funPtr)(unsigned int, void *),
+                                        unsigned int messageSize,
+                                        void * messageAddress),
+                       LLCompletionRing * ring,
+                       void * tag,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress);
+
+#endif
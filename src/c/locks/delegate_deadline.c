@@ -0,0 +1,36 @@
+#include "delegate_deadline.h"
+
+#include <string.h>
+
+// Executes the critical section of a deadline message or cancels it if
+// the deadline has passed
+static void ll_execute_before_deadline(unsigned int messageSize, void * messageAddress){
+    LLDeadlineMessageHeader * header = (LLDeadlineMessageHeader *)messageAddress;
+    unsigned int size = messageSize - sizeof(LLDeadlineMessageHeader);
+    void * message = (char *)messageAddress + sizeof(LLDeadlineMessageHeader);
+    if(!ll_deadline_passed(header->deadline)){
+        header->funPtr(size, message);
+    }else if(header->cancelFunPtr != NULL){
+        header->cancelFunPtr(size, message);
+    }
+}
+
+void ll_delegate_deadline(void * lock,
+                          void (*delegate)(void*,
+                                           void (*funPtr)(unsigned int, void *),
+                                           unsigned int messageSize,
+                                           void * messageAddress),
+                          uint64_t deadline,
+                          void (*cancelFunPtr)(unsigned int, void *),
+                          void (*funPtr)(unsigned int, void *),
+                          unsigned int messageSize,
+                          void * messageAddress){
+    _Alignas(LLDeadlineMessageHeader)
+        char buffer[sizeof(LLDeadlineMessageHeader) + messageSize];
+    LLDeadlineMessageHeader * header = (LLDeadlineMessageHeader *)buffer;
+    header->deadline = deadline;
+    header->cancelFunPtr = cancelFunPtr;
+    header->funPtr = funPtr;
+    memcpy(buffer + sizeof(LLDeadlineMessageHeader), messageAddress, messageSize);
+    delegate(lock, ll_execute_before_deadline, sizeof(buffer), buffer);
+}
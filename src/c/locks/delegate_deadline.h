@@ -0,0 +1,43 @@
+#ifndef DELEGATE_DEADLINE_H
+#define DELEGATE_DEADLINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "misc/timing.h"
+
+/* Delegations with Deadlines */
+
+// A critical section delegated with a deadline (see
+// LL_delegate_deadline in locks/locks.h) is wrapped in a message that
+// starts with the deadline, a cancel function and the critical
+// section. The wrapper is executed by the thread that executes the
+// critical section, i.e. the lock holder, which checks the deadline
+// just before the critical section would have been executed. An
+// expired critical section is skipped and the cancel function (if not
+// NULL) is called with the message instead, so a holder that has
+// fallen behind does not spend time on requests that nobody waits
+// for anymore.
+//
+// The deadline is stored in the message rather than in the request
+// header of the delegation queues, so delegations without a deadline
+// do not pay for it.
+
+typedef struct {
+    uint64_t deadline;
+    void (*cancelFunPtr)(unsigned int, void *);
+    void (*funPtr)(unsigned int, void *);
+} LLDeadlineMessageHeader; //Followed by the message
+
+void ll_delegate_deadline(void * lock,
+                          void (*delegate)(void*,
+                                           void (*funPtr)(unsigned int, void *),
+                                           unsigned int messageSize,
+                                           void * messageAddress),
+                          uint64_t deadline,
+                          void (*cancelFunPtr)(unsigned int, void *),
+                          void (*funPtr)(unsigned int, void *),
+                          unsigned int messageSize,
+                          void * messageAddress);
+
+#endif
@@ -0,0 +1,39 @@
+#include "delegate_fence.h"
+
+_Thread_local LLOutstandingDelegations llOutstandingDelegations = {.numberOfEntries = 0};
+
+void ll_delegate_fence_entry(unsigned int index){
+    LLOutstandingDelegations * outstanding = &llOutstandingDelegations;
+    LLOutstandingDelegation * entry = &outstanding->entries[index];
+    if(entry->observedVersion & 1){
+        while(atomic_load_explicit(entry->version, memory_order_acquire) == entry->observedVersion){
+            thread_yield();
+        }
+    }
+    while(ll_forward_count_pending(entry->forwards,
+                                   entry->firstEpoch,
+                                   entry->lastEpoch)){
+        thread_yield();
+    }
+    outstanding->numberOfEntries--;
+    for(unsigned int i = index; i < outstanding->numberOfEntries; i++){
+        outstanding->entries[i] = outstanding->entries[i + 1];
+    }
+}
+
+void ll_delegate_fence_version(volatile atomic_ulong * version){
+    LLOutstandingDelegations * outstanding = &llOutstandingDelegations;
+    for(unsigned int i = 0; i < outstanding->numberOfEntries; i++){
+        if(outstanding->entries[i].version == version){
+            ll_delegate_fence_entry(i);
+            return;
+        }
+    }
+}
+
+void LL_delegate_fence_all(){
+    LLOutstandingDelegations * outstanding = &llOutstandingDelegations;
+    while(outstanding->numberOfEntries > 0){
+        ll_delegate_fence_entry(outstanding->numberOfEntries - 1);
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef DELEGATE_FENCE_H
+#define DELEGATE_FENCE_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "locks/delegate_forward.h"
+
+/* Delegation Fences */
+
+// A critical section that is delegated to a QD, MRQD, priority QD,
+// adaptive or compact QD lock while another thread holds the lock is
+// executed by the holder before it increments the version of the lock
+// on release (see locks/qd_lock.h). A delegating thread that reads an
+// odd version after its critical section has been enqueued therefore
+// knows that the critical section has been executed when the version
+// has changed. An even version means that the batch has already been
+// flushed.
+//
+// Each thread records the odd versions it has seen in a small thread
+// local table with one entry per lock. A fence waits for the versions
+// in the table to change. No messages are sent to the locks. When the
+// table is full the thread waits for the oldest entry before it
+// records a new one.
+//
+// A fence also waits for the follow-ups that have been forwarded from
+// the batches of the lock (see LLForwardCount in
+// locks/delegate_forward.h), but only for those of the epochs in which
+// the critical sections may have been executed. A thread reads the
+// version before and after it enqueues. If both reads return the same
+// odd version, the critical section is in that batch and its epoch is
+// known. Otherwise the thread waits for the epoch read after the
+// enqueue and the one before it. A thread therefore also records a
+// lock when the version is even but follow-ups of these epochs are in
+// flight. A holder that forwards a follow-up from a batch does not
+// record the target lock since the follow-up is counted on the source
+// lock. The adaptive and compact QD locks can not forward and pass
+// NULL as forward count.
+//
+// The table refers to the locks, so a thread has to fence a lock it
+// has delegated to (or call LL_delegate_fence_all) before the lock is
+// destroyed.
+
+#ifndef LL_DELEGATE_FENCE_SLOTS
+#    define LL_DELEGATE_FENCE_SLOTS 16
+#endif
+
+typedef struct {
+    volatile atomic_ulong * version;
+    LLForwardCount * forwards;
+    unsigned long observedVersion;
+    unsigned long firstEpoch;
+    unsigned long lastEpoch;
+} LLOutstandingDelegation;
+
+typedef struct {
+    LLOutstandingDelegation entries[LL_DELEGATE_FENCE_SLOTS];
+    unsigned int numberOfEntries;
+} LLOutstandingDelegations;
+
+extern
+_Thread_local LLOutstandingDelegations llOutstandingDelegations;
+
+// Waits until the delegations recorded in entry index have been
+// executed and removes the entry
+void ll_delegate_fence_entry(unsigned int index);
+
+// Called by a thread before it tries to enqueue a critical section in
+// the queue of the lock with the given version. The result is passed
+// to ll_delegate_fence_record.
+static inline
+unsigned long ll_delegate_fence_observe(volatile atomic_ulong * version){
+    return atomic_load_explicit(version, memory_order_acquire);
+}
+
+// Called by a thread after it has enqueued a critical section in the
+// queue of the lock with the given version and forward count. The
+// forward count may be NULL and versionBefore is then not used.
+static inline
+void ll_delegate_fence_record(volatile atomic_ulong * version,
+                              unsigned long versionBefore,
+                              LLForwardCount * forwards){
+    if(llDeferredForwards.forwards != NULL){
+        return; //Follow-ups are counted on the lock they come from
+    }
+    unsigned long firstEpoch = 0;
+    unsigned long lastEpoch = 0;
+    if(forwards != NULL){
+        lastEpoch = atomic_load_explicit(&forwards->epoch.value, memory_order_acquire);
+    }
+    unsigned long observedVersion = atomic_load_explicit(version, memory_order_acquire);
+    if(forwards != NULL){
+        if((observedVersion & 1) && observedVersion == versionBefore){
+            firstEpoch = lastEpoch;
+        }else{
+            lastEpoch = atomic_load_explicit(&forwards->epoch.value, memory_order_acquire);
+            firstEpoch = lastEpoch > 0 ? lastEpoch - 1 : 0;
+        }
+    }
+    if((observedVersion & 1) == 0 &&
+       !ll_forward_count_pending(forwards, firstEpoch, lastEpoch)){
+        return;
+    }
+    LLOutstandingDelegations * outstanding = &llOutstandingDelegations;
+    for(unsigned int i = 0; i < outstanding->numberOfEntries; i++){
+        LLOutstandingDelegation * entry = &outstanding->entries[i];
+        if(entry->version == version){
+            entry->observedVersion = observedVersion;
+            if(firstEpoch < entry->firstEpoch){
+                entry->firstEpoch = firstEpoch;
+            }
+            entry->lastEpoch = lastEpoch;
+            return;
+        }
+    }
+    if(outstanding->numberOfEntries == LL_DELEGATE_FENCE_SLOTS){
+        ll_delegate_fence_entry(0);
+    }
+    LLOutstandingDelegation * entry = &outstanding->entries[outstanding->numberOfEntries];
+    entry->version = version;
+    entry->forwards = forwards;
+    entry->observedVersion = observedVersion;
+    entry->firstEpoch = firstEpoch;
+    entry->lastEpoch = lastEpoch;
+    outstanding->numberOfEntries++;
+}
+
+// Waits until the critical sections that the calling thread has
+// delegated to the lock with the given version counter have been
+// executed
+void ll_delegate_fence_version(volatile atomic_ulong * version);
+
+// Waits until all critical sections that the calling thread has
+// delegated to the QD based locks and their follow-ups have been
+// executed
+void LL_delegate_fence_all();
+
+#endif
@@ -0,0 +1,164 @@
+#include "delegate_forward.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "misc/error_help.h"
+
+_Thread_local LLDeferredForwards llDeferredForwards =
+    {.forwards = NULL,
+     .sending = false,
+     .headChunk = NULL,
+     .tailChunk = NULL,
+     .head = 0,
+     .freeChunks = NULL};
+
+// Put in front of the message of a follow-up that is forwarded from a
+// batch
+typedef struct {
+    volatile atomic_ulong * forwards;
+    void (*funPtr)(unsigned int, void *);
+} LLForwardedMessageHeader;
+
+#define LL_DEFERRED_FORWARD_ALIGNMENT 16
+
+static inline unsigned int ll_deferred_forward_size(unsigned int messageSize){
+    unsigned int size = sizeof(LLDeferredForward) + messageSize;
+    return (size + LL_DEFERRED_FORWARD_ALIGNMENT - 1) & ~(LL_DEFERRED_FORWARD_ALIGNMENT - 1);
+}
+
+static inline void * ll_deferred_forward_message(LLDeferredForward * entry){
+    return (char *)entry + sizeof(LLDeferredForward);
+}
+
+// Executes a forwarded follow-up and counts it as executed on the lock
+// it was forwarded from
+static void ll_execute_forwarded(unsigned int messageSize, void * messageAddress){
+    LLForwardedMessageHeader * header = (LLForwardedMessageHeader *)messageAddress;
+    LLDeferredForwards * deferred = &llDeferredForwards;
+    volatile atomic_ulong * forwards = header->forwards;
+    volatile atomic_ulong * previousForwards = deferred->forwards;
+    deferred->forwards = forwards;
+    header->funPtr(messageSize - sizeof(LLForwardedMessageHeader),
+                   (char *)messageAddress + sizeof(LLForwardedMessageHeader));
+    deferred->forwards = previousForwards;
+    atomic_fetch_sub_explicit(forwards, 1, memory_order_release);
+}
+
+// Returns the first deferred follow-up or NULL. Chunks that have been
+// sent are put in the free list.
+static LLDeferredForward * ll_first_deferred_forward(LLDeferredForwards * deferred){
+    while(deferred->headChunk != NULL && deferred->head == deferred->headChunk->size){
+        LLDeferredForwardChunk * chunk = deferred->headChunk;
+        deferred->headChunk = chunk->next;
+        if(deferred->headChunk == NULL){
+            deferred->tailChunk = NULL;
+        }
+        chunk->next = deferred->freeChunks;
+        deferred->freeChunks = chunk;
+        deferred->head = 0;
+    }
+    if(deferred->headChunk == NULL){
+        return NULL;
+    }
+    return (LLDeferredForward *)&deferred->headChunk->buffer[deferred->head];
+}
+
+// Reserves room for an entry of the given size at the end of the list.
+// Entries are never moved, so they stay valid while they are executed.
+static LLDeferredForward * ll_append_deferred_forward(LLDeferredForwards * deferred,
+                                                      unsigned int entrySize){
+    if(entrySize > LL_DELEGATE_FORWARD_CHUNK_SIZE){
+        LL_error_and_exit("The forwarded message is too big\n");
+    }
+    LLDeferredForwardChunk * chunk = deferred->tailChunk;
+    if(chunk == NULL || chunk->size + entrySize > LL_DELEGATE_FORWARD_CHUNK_SIZE){
+        chunk = deferred->freeChunks;
+        if(chunk != NULL){
+            deferred->freeChunks = chunk->next;
+        }else{
+            chunk = aligned_alloc(CACHE_LINE_SIZE, sizeof(LLDeferredForwardChunk));
+            if(chunk == NULL){
+                LL_error_and_exit("Could not allocate a forwarded delegation chunk\n");
+            }
+        }
+        chunk->next = NULL;
+        chunk->size = 0;
+        if(deferred->tailChunk == NULL){
+            deferred->headChunk = chunk;
+            deferred->head = 0;
+        }else{
+            deferred->tailChunk->next = chunk;
+        }
+        deferred->tailChunk = chunk;
+    }
+    LLDeferredForward * entry = (LLDeferredForward *)&chunk->buffer[chunk->size];
+    chunk->size = chunk->size + entrySize;
+    return entry;
+}
+
+void ll_send_deferred_forwards_slow(){
+    LLDeferredForwards * deferred = &llDeferredForwards;
+    if(deferred->sending){
+        return; //Entries added while sending are sent by the outer call
+    }
+    deferred->sending = true;
+    LLDeferredForward * entry;
+    while(NULL != (entry = ll_first_deferred_forward(deferred))){
+        if(!entry->sent){
+            entry->sent = true;
+            entry->delegate(entry->lock,
+                            entry->funPtr,
+                            entry->messageSize,
+                            ll_deferred_forward_message(entry));
+        }
+        deferred->head = deferred->head + ll_deferred_forward_size(entry->messageSize);
+    }
+    deferred->sending = false;
+}
+
+void ll_delegate_forward(void * lock,
+                         void (*delegate)(void*,
+                                          void (*funPtr)(unsigned int, void *),
+                                          unsigned int messageSize,
+                                          void * messageAddress),
+                         bool (*tryEnqueue)(void*,
+                                            void (*funPtr)(unsigned int, void *),
+                                            unsigned int messageSize,
+                                            void * messageAddress),
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress){
+    LLDeferredForwards * deferred = &llDeferredForwards;
+    volatile atomic_ulong * forwards = deferred->forwards;
+    unsigned int headerSize = forwards == NULL ? 0 : sizeof(LLForwardedMessageHeader);
+    unsigned int entrySize = ll_deferred_forward_size(headerSize + messageSize);
+    // The entry is written to the list first and stays there if the
+    // follow-up can not be enqueued
+    LLDeferredForward * entry = ll_append_deferred_forward(deferred, entrySize);
+    char * message = ll_deferred_forward_message(entry);
+    entry->lock = lock;
+    entry->delegate = delegate;
+    entry->messageSize = headerSize + messageSize;
+    entry->sent = false;
+    if(forwards == NULL){
+        entry->funPtr = funPtr;
+    }else{
+        LLForwardedMessageHeader * header = (LLForwardedMessageHeader *)message;
+        header->forwards = forwards;
+        header->funPtr = funPtr;
+        entry->funPtr = ll_execute_forwarded;
+        atomic_fetch_add_explicit(forwards, 1, memory_order_relaxed);
+    }
+    memcpy(message + headerSize, messageAddress, messageSize);
+    // Only tried when nothing is deferred before it to keep the order
+    if(ll_first_deferred_forward(deferred) != entry){
+        return;
+    }
+    if(tryEnqueue(lock, entry->funPtr, entry->messageSize, message)){
+        entry->sent = true;
+        while(NULL != (entry = ll_first_deferred_forward(deferred)) && entry->sent){
+            deferred->head = deferred->head + ll_deferred_forward_size(entry->messageSize);
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef DELEGATE_FORWARD_H
+#define DELEGATE_FORWARD_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "misc/padded_types.h"
+#include "qd_queues/qd_queue.h"
+#include "locks/oo_lock_interface.h"
+
+/* Forwarded Delegations */
+
+// A critical section that is executed by the holder of a QD or MRQD
+// lock can forward a follow-up critical section to another lock
+// without waiting for it (see LL_delegate_forward in locks/locks.h).
+// The follow-up is put in the queue of the target lock if a holder of
+// that lock has opened it. Otherwise it is stored in a thread local
+// list and delegated after the holder has released the lock whose
+// batch it is executing. A holder therefore never takes another lock,
+// waits for it or executes its batch while it holds its own. The list
+// is stored in chunks that are reused by the thread.
+// Follow-ups from one thread are delegated in the order they were
+// forwarded.
+//
+// Every QD, MRQD and priority QD lock counts the follow-ups that have
+// been forwarded from its batches and not yet executed. A follow-up
+// that is forwarded from a follow-up is counted where its parent is
+// counted, and the parent is only uncounted after it has returned.
+// The count is kept per epoch (see LLForwardCount below) so that a
+// delegation fence on a lock (see locks/delegate_fence.h) only waits
+// for the follow-ups of the epochs in which the critical sections of
+// the fencing thread may have been executed. Follow-ups that other
+// threads keep forwarding in later epochs do not delay it.
+
+// The lock holder starts a new epoch when it takes the lock for
+// writing, unless follow-ups of the previous epoch are still in
+// flight. The follow-ups forwarded from a batch are counted in the
+// epoch of the batch. An epoch can therefore only start when the
+// counter it shares with the epoch two steps back is zero, and a
+// counter only grows from zero in the current epoch.
+typedef struct {
+    LLPaddedULong epoch;
+    LLPaddedULong forwards[2];
+} LLForwardCount;
+
+static inline
+void ll_forward_count_initialize(LLForwardCount * count){
+    atomic_store(&count->epoch.value, 0);
+    atomic_store(&count->forwards[0].value, 0);
+    atomic_store(&count->forwards[1].value, 0);
+}
+
+// Called by the lock holder after the lock has been taken for writing
+// and before the version of the lock is made odd
+static inline
+void ll_forward_count_begin_write(LLForwardCount * count){
+    unsigned long epoch =
+        atomic_load_explicit(&count->epoch.value, memory_order_relaxed);
+    if(atomic_load_explicit(&count->forwards[(epoch + 1) & 1].value,
+                            memory_order_acquire) == 0){
+        atomic_store_explicit(&count->epoch.value, epoch + 1, memory_order_release);
+        atomic_thread_fence(memory_order_release);
+    }
+}
+
+// The counter of the current epoch. Only called by the lock holder.
+static inline
+volatile atomic_ulong * ll_forward_count_current(LLForwardCount * count){
+    unsigned long epoch =
+        atomic_load_explicit(&count->epoch.value, memory_order_relaxed);
+    return &count->forwards[epoch & 1].value;
+}
+
+// Returns true if follow-ups that were forwarded in one of the epochs
+// from firstEpoch to lastEpoch may not have been executed yet. The
+// epochs before lastEpoch - 1 have always been drained. The count may
+// be NULL.
+static inline
+bool ll_forward_count_pending(LLForwardCount * count,
+                              unsigned long firstEpoch,
+                              unsigned long lastEpoch){
+    if(count == NULL){
+        return false;
+    }
+    if(lastEpoch > 0 && firstEpoch < lastEpoch - 1){
+        firstEpoch = lastEpoch - 1;
+    }
+    for(unsigned long epoch = firstEpoch; epoch <= lastEpoch; epoch++){
+        if(atomic_load_explicit(&count->forwards[epoch & 1].value,
+                                memory_order_acquire) != 0 &&
+           atomic_load_explicit(&count->epoch.value,
+                                memory_order_acquire) < epoch + 2){
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifndef LL_DELEGATE_FORWARD_CHUNK_SIZE
+#    define LL_DELEGATE_FORWARD_CHUNK_SIZE 16384
+#endif
+
+typedef struct {
+    void * lock;
+    void (*delegate)(void*,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress);
+    void (*funPtr)(unsigned int, void *);
+    unsigned int messageSize;
+    bool sent;
+} LLDeferredForward; //Followed by the message
+
+typedef struct LLDeferredForwardChunkImpl {
+    struct LLDeferredForwardChunkImpl * next;
+    unsigned int size;
+    _Alignas(16) char buffer[LL_DELEGATE_FORWARD_CHUNK_SIZE];
+} LLDeferredForwardChunk;
+
+typedef struct {
+    // The counter of the epoch of the batch that is being executed by
+    // the thread or NULL
+    volatile atomic_ulong * forwards;
+    bool sending;
+    // The deferred follow-ups start at offset head in headChunk. The
+    // chunks are NULL when there are no deferred follow-ups.
+    LLDeferredForwardChunk * headChunk;
+    LLDeferredForwardChunk * tailChunk;
+    unsigned int head;
+    LLDeferredForwardChunk * freeChunks;
+} LLDeferredForwards;
+
+extern
+_Thread_local LLDeferredForwards llDeferredForwards;
+
+// Makes the follow-ups that the calling thread forwards count on the
+// given counter until ll_forwarding_exit is called with the returned
+// value
+static inline
+volatile atomic_ulong * ll_forwarding_enter(volatile atomic_ulong * forwards){
+    LLDeferredForwards * deferred = &llDeferredForwards;
+    volatile atomic_ulong * previousForwards = deferred->forwards;
+    deferred->forwards = forwards;
+    return previousForwards;
+}
+
+static inline
+void ll_forwarding_exit(volatile atomic_ulong * previousForwards){
+    llDeferredForwards.forwards = previousForwards;
+}
+
+// Executes the requests in the queue of a lock with the given forward
+// count. Works like qdq_flush.
+static inline
+unsigned long ll_forwarding_flush(QDQueue * queue, LLForwardCount * forwards){
+    volatile atomic_ulong * previousForwards =
+        ll_forwarding_enter(ll_forward_count_current(forwards));
+    unsigned long executed = qdq_flush(queue);
+    ll_forwarding_exit(previousForwards);
+    return executed;
+}
+
+void ll_send_deferred_forwards_slow();
+
+// Called by QD and MRQD lock holders after they have released the lock
+static inline
+void ll_send_deferred_forwards(){
+    LLDeferredForwards * deferred = &llDeferredForwards;
+    if(deferred->headChunk != NULL && deferred->forwards == NULL){
+        ll_send_deferred_forwards_slow();
+    }
+}
+
+void ll_delegate_forward(void * lock,
+                         void (*delegate)(void*,
+                                          void (*funPtr)(unsigned int, void *),
+                                          unsigned int messageSize,
+                                          void * messageAddress),
+                         bool (*tryEnqueue)(void*,
+                                            void (*funPtr)(unsigned int, void *),
+                                            unsigned int messageSize,
+                                            void * messageAddress),
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress);
+
+// Only QD, MRQD and priority QD locks can be the target of a forwarded
+// follow-up, so other lock types exit with an error
+static inline void oolock_delegate_forward(OOLock * lock,
+                                           void (*funPtr)(unsigned int, void *),
+                                           unsigned int messageSize,
+                                           void * messageAddress){
+    if(lock->m->try_enqueue == NULL){
+        LL_error_and_exit("Forwarding is not supported by the lock type\n");
+    }
+    ll_delegate_forward(lock->lock,
+                        lock->m->delegate,
+                        lock->m->try_enqueue,
+                        funPtr,
+                        messageSize,
+                        messageAddress);
+}
+
+#endif
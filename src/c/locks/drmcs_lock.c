@@ -3,7 +3,7 @@
 _Alignas(CACHE_LINE_SIZE)
 OOLockMethodTable DRMCS_LOCK_METHOD_TABLE = 
 {
-     .free = &free,
+     .free = &drmcs_free,
      .lock = &drmcs_lock,
      .unlock = &drmcs_unlock,
      .is_locked = &drmcs_is_locked,
@@ -14,15 +14,64 @@ OOLockMethodTable DRMCS_LOCK_METHOD_TABLE =
      .delegate_wait = &drmcs_delegate,
      .delegate_or_lock = &drmcs_delegate_or_lock,
      .close_delegate_buffer = NULL, /* Should never be called */
-     .delegate_unlock = &drmcs_unlock
+     .delegate_unlock = &drmcs_unlock,
+     .lock_timed = &drmcs_lock_timed,
+     .try_delegate = &drmcs_try_delegate,
+     .delegate_timed = &drmcs_delegate_timed,
+     .upgrade = &drmcs_upgrade,
+     .downgrade = &drmcs_downgrade
 };
 
 
 void drmcs_initialize(DRMCSLock * lock){
+    drmcs_initialize_with_read_indicator(lock, DRMCS_LOCK_READ_INDICATOR_TYPE);
+}
+
+static void drmcs_initialize_except_read_indicator(DRMCSLock * lock){
     mcs_initialize(&lock->lock);
     atomic_int tmp = ATOMIC_VAR_INIT(0);
     lock->writeBarrier.value = tmp;
-    reader_groups_initialize(&lock->readIndicator);
+    atomic_store_explicit(&lock->readersMayBeInside.value, false, memory_order_relaxed);
+}
+
+
+/* Called by a writer that got the lock from its predecessor. Returns
+   true if it has to wait for readers anyway. */
+static inline bool drmcs_take_readers_may_be_inside(DRMCSLock * l){
+    if(atomic_load_explicit(&l->readersMayBeInside.value, memory_order_relaxed)){
+        atomic_store_explicit(&l->readersMayBeInside.value, false, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+
+/* Releases the lock when readers may be inside */
+static inline void drmcs_unlock_with_readers_inside(DRMCSLock * l){
+    atomic_store_explicit(&l->readersMayBeInside.value, true, memory_order_relaxed);
+    mcs_unlock(&l->lock);
+}
+
+
+void drmcs_initialize_with_read_indicator(DRMCSLock * lock,
+                                          LL_read_indicator_type readIndicatorType){
+    drmcs_initialize_except_read_indicator(lock);
+    ri_initialize(&lock->readIndicator, readIndicatorType);
+}
+
+
+void drmcs_initialize_with_read_indicator_width(DRMCSLock * lock,
+                                                LL_read_indicator_type readIndicatorType,
+                                                int width){
+    drmcs_initialize_except_read_indicator(lock);
+    ri_initialize_with_width(&lock->readIndicator, readIndicatorType, width);
+}
+
+
+void drmcs_initialize_with_shared_read_indicator(DRMCSLock * lock,
+                                                 ReadIndicator * sharedReadIndicator){
+    drmcs_initialize_except_read_indicator(lock);
+    ri_initialize_shared(&lock->readIndicator, sharedReadIndicator);
 }
 
 
@@ -31,8 +80,8 @@ void drmcs_lock(void * lock) {
     while(atomic_load_explicit(&l->writeBarrier.value, memory_order_acquire)){
         thread_yield();
     }
-    if(!mcs_lock_status(&l->lock)){
-        rgri_wait_all_readers_gone(&l->readIndicator);
+    if(!mcs_lock_status(&l->lock) || drmcs_take_readers_may_be_inside(l)){
+        ri_wait_all_readers_gone(&l->readIndicator);
     }
 }
 
@@ -55,7 +104,7 @@ bool drmcs_try_lock(void * lock) {
         thread_yield();
     }
     if(mcs_try_lock(&l->lock)){
-        rgri_wait_all_readers_gone(&l->readIndicator);
+        ri_wait_all_readers_gone(&l->readIndicator);
         return true;
     }else{
         return false;
@@ -68,9 +117,9 @@ void drmcs_rlock(void * lock) {
     bool bRaised = false;
     int readPatience = 0;
  start:
-    rgri_arrive(&l->readIndicator);
+    ri_arrive(&l->readIndicator);
     if(mcs_is_locked(&l->lock)) {
-        rgri_depart(&l->readIndicator);
+        ri_depart(&l->readIndicator);
         while(mcs_is_locked(&l->lock)) {
             thread_yield();
             if((readPatience == DRMCS_READ_PATIENCE_LIMIT) && !bRaised) {
@@ -89,7 +138,41 @@ void drmcs_rlock(void * lock) {
 
 void drmcs_runlock(void * lock) {
     DRMCSLock *l = (DRMCSLock*)lock;
-    rgri_depart(&l->readIndicator);
+    ri_depart(&l->readIndicator);
+}
+
+
+bool drmcs_upgrade(void * lock) {
+    DRMCSLock *l = (DRMCSLock*)lock;
+    // A writer that holds or waits for the MCS lock waits for this
+    // reader, so the read lock has to be released if it is taken
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0 ||
+       !mcs_try_lock(&l->lock)){
+        ri_depart(&l->readIndicator);
+        return false;
+    }
+    ri_depart(&l->readIndicator);
+    ri_wait_all_readers_gone(&l->readIndicator);
+    return true;
+}
+
+
+bool drmcs_upgrade_or_delegate(void * lock,
+                               void (*funPtr)(unsigned int, void *),
+                               unsigned int messageSize,
+                               void * messageAddress) {
+    if(drmcs_upgrade(lock)){
+        return true;
+    }
+    drmcs_delegate(lock, funPtr, messageSize, messageAddress);
+    return false;
+}
+
+
+void drmcs_downgrade(void * lock) {
+    DRMCSLock *l = (DRMCSLock*)lock;
+    ri_arrive(&l->readIndicator);
+    drmcs_unlock_with_readers_inside(l);
 }
 
 
@@ -112,17 +195,120 @@ void * drmcs_delegate_or_lock(void * lock, unsigned int messageSize){
 }
 
 
-DRMCSLock * plain_drmcs_create(){
+bool drmcs_lock_timed(void * lock, uint64_t timeoutNanos) {
+    DRMCSLock *l = (DRMCSLock*)lock;
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_acquire)){
+        if(ll_deadline_passed(deadline)){
+            return false;
+        }
+        thread_yield();
+    }
+    MCSAcquireStatus status = mcs_lock_status_until(&l->lock, deadline);
+    if(status == MCS_TIMED_OUT){
+        return false;
+    }else if((status == MCS_ACQUIRED || drmcs_take_readers_may_be_inside(l)) &&
+             !ri_wait_all_readers_gone_until(&l->readIndicator, deadline)){
+        drmcs_unlock_with_readers_inside(l);
+        return false;
+    }
+    return true;
+}
+
+
+bool drmcs_try_delegate(void * lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress){
+    DRMCSLock *l = (DRMCSLock*)lock;
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0 ||
+       !mcs_try_lock(&l->lock)){
+        return false;
+    }
+    ri_wait_all_readers_gone(&l->readIndicator);
+    funPtr(messageSize, messageAddress);
+    drmcs_unlock(l);
+    return true;
+}
+
+
+bool drmcs_delegate_timed(void * lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress,
+                          uint64_t timeoutNanos){
+    DRMCSLock *l = (DRMCSLock*)lock;
+    if(!drmcs_lock_timed(l, timeoutNanos)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    drmcs_unlock(l);
+    return true;
+}
+
+
+void drmcs_destroy(DRMCSLock * lock){
+    ri_destroy(&lock->readIndicator);
+}
+
+
+void drmcs_free(void * lock){
+    drmcs_destroy((DRMCSLock *)lock);
+    free(lock);
+}
+
+
+DRMCSLock * plain_drmcs_create_with_read_indicator(LL_read_indicator_type readIndicatorType){
     DRMCSLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(DRMCSLock));
-    drmcs_initialize(l);
+    drmcs_initialize_with_read_indicator(l, readIndicatorType);
     return l;
 }
 
 
-OOLock * oo_drmcs_create(){
-    DRMCSLock * l = plain_drmcs_create();
+static OOLock * oo_drmcs_wrap(DRMCSLock * l){
     OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
     ool->lock = l;
     ool->m = &DRMCS_LOCK_METHOD_TABLE;
     return ool;
 }
+
+
+OOLock * oo_drmcs_create_with_read_indicator(LL_read_indicator_type readIndicatorType){
+    return oo_drmcs_wrap(plain_drmcs_create_with_read_indicator(readIndicatorType));
+}
+
+
+DRMCSLock * plain_drmcs_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                         int width){
+    DRMCSLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(DRMCSLock));
+    drmcs_initialize_with_read_indicator_width(l, readIndicatorType, width);
+    return l;
+}
+
+
+OOLock * oo_drmcs_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                   int width){
+    return oo_drmcs_wrap(plain_drmcs_create_with_read_indicator_width(readIndicatorType, width));
+}
+
+
+DRMCSLock * plain_drmcs_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator){
+    DRMCSLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(DRMCSLock));
+    drmcs_initialize_with_shared_read_indicator(l, sharedReadIndicator);
+    return l;
+}
+
+
+OOLock * oo_drmcs_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator){
+    return oo_drmcs_wrap(plain_drmcs_create_with_shared_read_indicator(sharedReadIndicator));
+}
+
+
+DRMCSLock * plain_drmcs_create(){
+    return plain_drmcs_create_with_read_indicator(DRMCS_LOCK_READ_INDICATOR_TYPE);
+}
+
+
+OOLock * oo_drmcs_create(){
+    return oo_drmcs_create_with_read_indicator(DRMCS_LOCK_READ_INDICATOR_TYPE);
+}
@@ -4,7 +4,7 @@
 #include "locks/oo_lock_interface.h"
 #include "locks/mcs_lock.h"
 #include "misc/padded_types.h"
-#include "read_indicators/reader_groups_read_indicator.h"
+#include "read_indicators/read_indicator.h"
 
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
 #include "misc/thread_includes.h"//Until c11 thread.h is available
@@ -12,10 +12,21 @@
 
 #define DRMCS_READ_PATIENCE_LIMIT 130000
 
+#ifndef DRMCS_LOCK_READ_INDICATOR_TYPE
+#    define DRMCS_LOCK_READ_INDICATOR_TYPE READER_GROUPS_READ_INDICATOR
+#endif
+
+// A writer that gets the MCS lock from its predecessor does not wait
+// for readers, since readers can not enter while the lock is held and
+// the first writer in the queue has waited for them. A holder that
+// releases the lock while readers may be inside (after a downgrade or
+// when drmcs_lock_timed gives up waiting for readers) sets
+// readersMayBeInside so that the next writer waits for them.
 typedef struct {
     MCSLock lock;
     LLPaddedInt writeBarrier;
-    ReaderGroupsReadIndicator readIndicator;
+    LLPaddedBool readersMayBeInside; //Only accessed by the lock holder
+    ReadIndicator readIndicator;
 } DRMCSLock;
 
 extern
@@ -24,19 +35,58 @@ OOLockMethodTable DRMCS_LOCK_METHOD_TABLE;
 
 
 void drmcs_initialize(DRMCSLock * lock);
+void drmcs_initialize_with_read_indicator(DRMCSLock * lock,
+                                          LL_read_indicator_type readIndicatorType);
+// width is the number of reader groups, see ri_initialize_with_width
+void drmcs_initialize_with_read_indicator_width(DRMCSLock * lock,
+                                                LL_read_indicator_type readIndicatorType,
+                                                int width);
+// The lock uses sharedReadIndicator, which has to be destroyed after
+// the lock. See read_indicators/read_indicator.h for the restrictions.
+void drmcs_initialize_with_shared_read_indicator(DRMCSLock * lock,
+                                                 ReadIndicator * sharedReadIndicator);
+// Frees the read indicator allocated by drmcs_initialize
+void drmcs_destroy(DRMCSLock * lock);
+// Destroys and frees a lock created with plain_drmcs_create
+void drmcs_free(void * lock);
 void drmcs_lock(void * lock);
 void drmcs_unlock(void * lock);
 bool drmcs_is_locked(void * lock);
 bool drmcs_try_lock(void * lock);
 void drmcs_rlock(void * lock);
 void drmcs_runlock(void * lock);
+// Upgrades and downgrades, see LL_upgrade in locks/locks.h
+bool drmcs_upgrade(void * lock);
+bool drmcs_upgrade_or_delegate(void * lock,
+                               void (*funPtr)(unsigned int, void *),
+                               unsigned int messageSize,
+                               void * messageAddress);
+void drmcs_downgrade(void * lock);
 void drmcs_delegate(void * lock,
                     void (*funPtr)(unsigned int, void *), 
                     unsigned int messageSize,
                     void * messageAddress);
 void * drmcs_delegate_or_lock(void * lock, unsigned int messageSize);
+bool drmcs_lock_timed(void * lock, uint64_t timeoutNanos);
+bool drmcs_try_delegate(void * lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress);
+bool drmcs_delegate_timed(void * lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress,
+                          uint64_t timeoutNanos);
 DRMCSLock * plain_drmcs_create();
 OOLock * oo_drmcs_create();
+DRMCSLock * plain_drmcs_create_with_read_indicator(LL_read_indicator_type readIndicatorType);
+OOLock * oo_drmcs_create_with_read_indicator(LL_read_indicator_type readIndicatorType);
+DRMCSLock * plain_drmcs_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                         int width);
+OOLock * oo_drmcs_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                   int width);
+DRMCSLock * plain_drmcs_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator);
+OOLock * oo_drmcs_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator);
 
 
 #endif
@@ -0,0 +1,177 @@
+#include "lock_table.h"
+
+#include "misc/error_help.h"
+
+
+/* Fills in the size and method table of the lock type. Plain lock
+   types are mapped to the corresponding OO lock types. */
+static void lock_table_lock_type_info(LL_lock_type_name lockType,
+                                      LL_lock_type_name * ooLockType,
+                                      size_t * size,
+                                      OOLockMethodTable ** methodTable){
+    if(TATAS_LOCK == lockType || PLAIN_TATAS_LOCK == lockType){
+        *ooLockType = TATAS_LOCK;
+        *size = sizeof(TATASLock);
+        *methodTable = &TATAS_LOCK_METHOD_TABLE;
+    }else if(QD_LOCK == lockType || PLAIN_QD_LOCK == lockType){
+        *ooLockType = QD_LOCK;
+        *size = sizeof(QDLock);
+        *methodTable = &QD_LOCK_METHOD_TABLE;
+    }else if(MRQD_LOCK == lockType || PLAIN_MRQD_LOCK == lockType){
+        *ooLockType = MRQD_LOCK;
+        *size = sizeof(MRQDLock);
+        *methodTable = &MRQD_LOCK_METHOD_TABLE;
+    }else if(ADAPTIVE_LOCK == lockType || PLAIN_ADAPTIVE_LOCK == lockType){
+        *ooLockType = ADAPTIVE_LOCK;
+        *size = sizeof(AdaptiveLock);
+        *methodTable = &ADAPTIVE_LOCK_METHOD_TABLE;
+    }else if(BIASED_LOCK == lockType || PLAIN_BIASED_LOCK == lockType){
+        *ooLockType = BIASED_LOCK;
+        *size = sizeof(BiasedLock);
+        *methodTable = &BIASED_LOCK_METHOD_TABLE;
+    }else if(COMPACT_QD_LOCK == lockType || PLAIN_COMPACT_QD_LOCK == lockType){
+        *ooLockType = COMPACT_QD_LOCK;
+        *size = sizeof(CompactQDLock);
+        *methodTable = &COMPACT_QD_LOCK_METHOD_TABLE;
+    }else if(PRIORITY_QD_LOCK == lockType || PLAIN_PRIORITY_QD_LOCK == lockType){
+        *ooLockType = PRIORITY_QD_LOCK;
+        *size = sizeof(PriorityQDLock);
+        *methodTable = &PRIORITY_QD_LOCK_METHOD_TABLE;
+    }else if(CCSYNCH_LOCK == lockType || PLAIN_CCSYNCH_LOCK == lockType){
+        *ooLockType = CCSYNCH_LOCK;
+        *size = sizeof(CCSynchLock);
+        *methodTable = &CCSYNCH_LOCK_METHOD_TABLE;
+    }else if(MCS_LOCK == lockType || PLAIN_MCS_LOCK == lockType){
+        *ooLockType = MCS_LOCK;
+        *size = sizeof(MCSLock);
+        *methodTable = &MCS_LOCK_METHOD_TABLE;
+    }else if(DRMCS_LOCK == lockType || PLAIN_DRMCS_LOCK == lockType){
+        *ooLockType = DRMCS_LOCK;
+        *size = sizeof(DRMCSLock);
+        *methodTable = &DRMCS_LOCK_METHOD_TABLE;
+    }else{
+        LL_error_and_exit("Lock type not supported\n");
+    }
+}
+
+
+static void lock_table_initialize_lock(LL_lock_type_name lockType, void * lock){
+    switch(lockType){
+    case TATAS_LOCK:
+        tatas_initialize(lock);
+        break;
+    case QD_LOCK:
+        qd_initialize(lock);
+        break;
+    case MRQD_LOCK:
+        mrqd_initialize(lock);
+        break;
+    case ADAPTIVE_LOCK:
+        adaptive_initialize(lock);
+        break;
+    case BIASED_LOCK:
+        biased_initialize(lock);
+        break;
+    case COMPACT_QD_LOCK:
+        cqd_initialize(lock);
+        break;
+    case PRIORITY_QD_LOCK:
+        pqd_initialize(lock);
+        break;
+    case CCSYNCH_LOCK:
+        ccsynch_initialize(lock);
+        break;
+    case MCS_LOCK:
+        mcs_initialize(lock);
+        break;
+    case DRMCS_LOCK:
+        drmcs_initialize(lock);
+        break;
+    default:
+        LL_error_and_exit("Lock type not supported\n");
+    }
+}
+
+
+static void lock_table_destroy_lock(LL_lock_type_name lockType, void * lock){
+    switch(lockType){
+    case MRQD_LOCK:
+        mrqd_destroy(lock);
+        break;
+    case COMPACT_QD_LOCK:
+        cqd_destroy(lock);
+        break;
+    case DRMCS_LOCK:
+        drmcs_destroy(lock);
+        break;
+    default:
+        break;
+    }
+}
+
+
+LLLockTable * LL_lock_table_create(LL_lock_type_name lockType,
+                                   unsigned long numberOfStripes){
+    LLLockTable * table = aligned_alloc(CACHE_LINE_SIZE, sizeof(LLLockTable));
+    size_t size;
+    lock_table_lock_type_info(lockType, &table->lockType, &size, &table->m);
+    table->stride = ((size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE;
+    unsigned long stripes = 1;
+    while(stripes < numberOfStripes){
+        stripes = stripes * 2;
+    }
+    table->stripeMask = stripes - 1;
+    table->locks = aligned_alloc(CACHE_LINE_SIZE, table->stride * stripes);
+    if(table->locks == NULL){
+        LL_error_and_exit("Could not allocate the lock table\n");
+    }
+    for(unsigned long i = 0; i < stripes; i++){
+        lock_table_initialize_lock(table->lockType, LL_table_stripe_lock(table, i));
+    }
+    return table;
+}
+
+
+void LL_lock_table_free(LLLockTable * table){
+    for(unsigned long i = 0; i < LL_table_number_of_stripes(table); i++){
+        lock_table_destroy_lock(table->lockType, LL_table_stripe_lock(table, i));
+    }
+    free(table->locks);
+    free(table);
+}
+
+
+static int lock_table_compare_stripes(const void * a, const void * b){
+    unsigned long stripeA = *(const unsigned long *)a;
+    unsigned long stripeB = *(const unsigned long *)b;
+    return (stripeA > stripeB) - (stripeA < stripeB);
+}
+
+
+unsigned long LL_table_lock_keys(LLLockTable * table,
+                                 const uintptr_t * keys,
+                                 unsigned long numberOfKeys,
+                                 unsigned long * stripes){
+    for(unsigned long i = 0; i < numberOfKeys; i++){
+        stripes[i] = LL_table_stripe(table, keys[i]);
+    }
+    qsort(stripes, numberOfKeys, sizeof(unsigned long), lock_table_compare_stripes);
+    unsigned long numberOfStripes = 0;
+    for(unsigned long i = 0; i < numberOfKeys; i++){
+        if(numberOfStripes == 0 || stripes[numberOfStripes - 1] != stripes[i]){
+            stripes[numberOfStripes] = stripes[i];
+            numberOfStripes = numberOfStripes + 1;
+        }
+    }
+    if(CCSYNCH_LOCK == table->lockType && numberOfStripes > 1){
+        LL_error_and_exit("CC-Synch lock tables can only lock one stripe at a time\n");
+    }
+    if((MCS_LOCK == table->lockType || DRMCS_LOCK == table->lockType) &&
+       numberOfStripes > MCS_NODE_POOL_SIZE){
+        LL_error_and_exit("MCS and DR-MCS lock tables can lock at most MCS_NODE_POOL_SIZE stripes at a time\n");
+    }
+    for(unsigned long i = 0; i < numberOfStripes; i++){
+        table->m->lock(LL_table_stripe_lock(table, stripes[i]));
+    }
+    return numberOfStripes;
+}
@@ -0,0 +1,179 @@
+#ifndef LOCK_TABLE_H
+#define LOCK_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "locks/locks.h"
+
+/* Striped Lock Table */
+
+// A lock table protects a large number of objects with a fixed number
+// of locks (stripes). A key, for example the address of an object, is
+// hashed to one of the stripes. The locks of all stripes are stored in
+// one cache line aligned array, so a table with N stripes costs one
+// allocation and N times the (cache line rounded) size of the lock
+// type. The operations are dispatched through the method table of the
+// lock type, in the same way as for an `OOLock`.
+
+// The number of stripes is rounded up to a power of two. The lock type
+// can be any type accepted by `LL_create`. The plain lock types give
+// the same table as the corresponding OO lock types. Note that
+// `COMPACT_QD_LOCK` uses one cache line per stripe while `QD_LOCK`,
+// `MRQD_LOCK` and `DRMCS_LOCK` use several kilobytes per stripe.
+
+typedef union {
+    struct {
+        OOLockMethodTable * m;
+        char * locks;
+        size_t stride;
+        unsigned long stripeMask;
+        LL_lock_type_name lockType;
+    };
+    char pad[CACHE_LINE_SIZE];
+} LLLockTable;
+
+// ## LL_lock_table_create
+
+// `LL_lock_table_create(lockType, numberOfStripes)` allocates and
+// initializes a lock table. Use `LL_lock_table_free` to free it.
+
+// *Example:*
+
+//     LLLockTable * table = LL_lock_table_create(COMPACT_QD_LOCK, 4096);
+//     LL_table_delegate(table, LL_table_key(record), update_record, sizeof(record), &record);
+LLLockTable * LL_lock_table_create(LL_lock_type_name lockType,
+                                   unsigned long numberOfStripes);
+void LL_lock_table_free(LLLockTable * table);
+
+// Converts an object address to a key
+#define LL_table_key(address) ((uintptr_t)(address))
+
+static inline
+unsigned long LL_table_number_of_stripes(LLLockTable * table){
+    return table->stripeMask + 1;
+}
+
+// Returns the stripe of the key
+static inline
+unsigned long LL_table_stripe(LLLockTable * table, uintptr_t key){
+    uint64_t hash = key;
+    hash = hash ^ (hash >> 33);
+    hash = hash * 0xff51afd7ed558ccdull;
+    hash = hash ^ (hash >> 33);
+    return hash & table->stripeMask;
+}
+
+// Returns the lock of a stripe. The lock can be used with the method
+// table `table->m`.
+static inline
+void * LL_table_stripe_lock(LLLockTable * table, unsigned long stripe){
+    return table->locks + stripe * table->stride;
+}
+
+static inline
+void * LL_table_key_lock(LLLockTable * table, uintptr_t key){
+    return LL_table_stripe_lock(table, LL_table_stripe(table, key));
+}
+
+// ## Single key operations
+
+// Work like the `LL_` functions with the same name on the lock of the
+// stripe that `key` is mapped to.
+
+static inline
+void LL_table_lock(LLLockTable * table, uintptr_t key){
+    table->m->lock(LL_table_key_lock(table, key));
+}
+
+static inline
+void LL_table_unlock(LLLockTable * table, uintptr_t key){
+    table->m->unlock(LL_table_key_lock(table, key));
+}
+
+static inline
+bool LL_table_try_lock(LLLockTable * table, uintptr_t key){
+    return table->m->try_lock(LL_table_key_lock(table, key));
+}
+
+static inline
+bool LL_table_lock_timed(LLLockTable * table, uintptr_t key, uint64_t timeoutNanos){
+    return table->m->lock_timed(LL_table_key_lock(table, key), timeoutNanos);
+}
+
+static inline
+void LL_table_rlock(LLLockTable * table, uintptr_t key){
+    table->m->rlock(LL_table_key_lock(table, key));
+}
+
+static inline
+void LL_table_runlock(LLLockTable * table, uintptr_t key){
+    table->m->runlock(LL_table_key_lock(table, key));
+}
+
+static inline
+void LL_table_delegate(LLLockTable * table,
+                       uintptr_t key,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress){
+    table->m->delegate(LL_table_key_lock(table, key), funPtr, messageSize, messageAddress);
+}
+
+static inline
+void LL_table_delegate_wait(LLLockTable * table,
+                            uintptr_t key,
+                            void (*funPtr)(unsigned int, void *),
+                            unsigned int messageSize,
+                            void * messageAddress){
+    table->m->delegate_wait(LL_table_key_lock(table, key), funPtr, messageSize, messageAddress);
+}
+
+static inline
+bool LL_table_try_delegate(LLLockTable * table,
+                           uintptr_t key,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress){
+    return table->m->try_delegate(LL_table_key_lock(table, key), funPtr, messageSize, messageAddress);
+}
+
+// ## Multiple key operations
+
+// `LL_table_lock_keys(table, keys, numberOfKeys, stripes)` acquires the
+// stripes of all the keys. Every stripe is acquired once, in
+// increasing stripe order, so threads that lock overlapping key sets
+// can not deadlock. The acquired stripes are written to `stripes`,
+// which needs room for `numberOfKeys` entries, and the number of
+// acquired stripes is returned. Release them with
+// `LL_table_unlock_stripes`. `CCSYNCH_LOCK` tables only support one
+// key at a time since a thread can only hold one CC-Synch lock.
+// `MCS_LOCK` and `DRMCS_LOCK` tables can lock at most
+// `MCS_NODE_POOL_SIZE` (8 by default) stripes at a time since a
+// thread takes one queue node per held MCS lock from a pool of that
+// size (see locks/mcs_lock.h). Other MCS locks that the thread holds
+// use nodes from the same pool.
+
+// *Example:*
+
+//     uintptr_t keys[2] = {LL_table_key(from), LL_table_key(to)};
+//     unsigned long stripes[2];
+//     unsigned long n = LL_table_lock_keys(table, keys, 2, stripes);
+//     transfer(from, to);
+//     LL_table_unlock_stripes(table, stripes, n);
+unsigned long LL_table_lock_keys(LLLockTable * table,
+                                 const uintptr_t * keys,
+                                 unsigned long numberOfKeys,
+                                 unsigned long * stripes);
+
+static inline
+void LL_table_unlock_stripes(LLLockTable * table,
+                             const unsigned long * stripes,
+                             unsigned long numberOfStripes){
+    for(unsigned long i = numberOfStripes; i > 0; i--){
+        table->m->unlock(LL_table_stripe_lock(table, stripes[i - 1]));
+    }
+}
+
+#endif
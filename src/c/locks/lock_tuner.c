@@ -0,0 +1,247 @@
+#include "lock_tuner.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "misc/random.h"
+#include "misc/timing.h"
+
+#define LOCK_TUNER_SHARED_CACHE_LINES 64
+#define LOCK_TUNER_MAX_LINE_LENGTH 256
+
+typedef struct {
+    LL_lock_type_name type;
+    const char * name;
+} LockTunerCandidate;
+
+static const LockTunerCandidate lockTunerCandidates[] = {
+    {TATAS_LOCK, "TATAS_LOCK"},
+    {QD_LOCK, "QD_LOCK"},
+    {MRQD_LOCK, "MRQD_LOCK"},
+    {ADAPTIVE_LOCK, "ADAPTIVE_LOCK"},
+    {BIASED_LOCK, "BIASED_LOCK"},
+    {COMPACT_QD_LOCK, "COMPACT_QD_LOCK"},
+    {CCSYNCH_LOCK, "CCSYNCH_LOCK"},
+    {MCS_LOCK, "MCS_LOCK"},
+    {DRMCS_LOCK, "DRMCS_LOCK"}
+};
+
+#define LOCK_TUNER_NUMBER_OF_CANDIDATES \
+    (sizeof(lockTunerCandidates) / sizeof(LockTunerCandidate))
+
+typedef struct {
+    OOLock * lock;
+    LLWorkloadProfile * profile;
+    LLPaddedBool stop;
+    LLPaddedULong sharedData[LOCK_TUNER_SHARED_CACHE_LINES];
+} LockTunerBenchmark;
+
+typedef struct {
+    LockTunerBenchmark * benchmark;
+    unsigned int seed;
+    unsigned long operations;
+    char pad[CACHE_LINE_SIZE];
+} LockTunerThreadData;
+
+
+const char * lock_tuner_lock_type_name(LL_lock_type_name lockType){
+    for(unsigned int i = 0; i < LOCK_TUNER_NUMBER_OF_CANDIDATES; i++){
+        if(lockTunerCandidates[i].type == lockType){
+            return lockTunerCandidates[i].name;
+        }
+    }
+    return NULL;
+}
+
+bool lock_tuner_parse_lock_type_name(const char * name,
+                                     LL_lock_type_name * lockTypeResult){
+    for(unsigned int i = 0; i < LOCK_TUNER_NUMBER_OF_CANDIDATES; i++){
+        if(strcmp(lockTunerCandidates[i].name, name) == 0){
+            *lockTypeResult = lockTunerCandidates[i].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline
+void lock_tuner_write_shared_data(LockTunerBenchmark * benchmark){
+    unsigned int work = benchmark->profile->criticalSectionWork;
+    for(unsigned int i = 0; i < work; i++){
+        LLPaddedULong * line = &benchmark->sharedData[i % LOCK_TUNER_SHARED_CACHE_LINES];
+        atomic_store_explicit(&line->value,
+                              atomic_load_explicit(&line->value, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+    }
+}
+
+static inline
+void lock_tuner_read_shared_data(LockTunerBenchmark * benchmark){
+    unsigned int work = benchmark->profile->criticalSectionWork;
+    unsigned long sum = 0;
+    for(unsigned int i = 0; i < work; i++){
+        LLPaddedULong * line = &benchmark->sharedData[i % LOCK_TUNER_SHARED_CACHE_LINES];
+        sum = sum + atomic_load_explicit(&line->value, memory_order_relaxed);
+    }
+    __asm__ __volatile__("" : : "r"(sum) : "memory");
+}
+
+static void lock_tuner_delegated_critical_section(unsigned int messageSize,
+                                                  void * messageAddress){
+    UNUSED(messageSize);
+    lock_tuner_write_shared_data(*(LockTunerBenchmark **)messageAddress);
+}
+
+static void * lock_tuner_benchmark_thread(void * threadDataVPtr){
+    LockTunerThreadData * threadData = threadDataVPtr;
+    LockTunerBenchmark * benchmark = threadData->benchmark;
+    OOLock * lock = benchmark->lock;
+    double delegatePercentage = benchmark->profile->delegatePercentage;
+    double delegatePlusReadPercentage =
+        delegatePercentage + benchmark->profile->readPercentage;
+    unsigned int nonCriticalSectionWork = benchmark->profile->nonCriticalSectionWork;
+    unsigned long operations = 0;
+    while(!atomic_load_explicit(&benchmark->stop.value, memory_order_acquire)){
+        double randomNumber = random_double(&threadData->seed);
+        if(randomNumber < delegatePercentage){
+            LL_delegate(lock,
+                        lock_tuner_delegated_critical_section,
+                        sizeof(LockTunerBenchmark *),
+                        &benchmark);
+        }else if(randomNumber < delegatePlusReadPercentage){
+            LL_rlock(lock);
+            lock_tuner_read_shared_data(benchmark);
+            LL_runlock(lock);
+        }else{
+            LL_lock(lock);
+            lock_tuner_write_shared_data(benchmark);
+            LL_unlock(lock);
+        }
+        for(unsigned int i = 0; i < nonCriticalSectionWork; i++){
+            __asm__ __volatile__("" : : : "memory");
+        }
+        operations = operations + 1;
+    }
+    threadData->operations = operations;
+    return NULL;
+}
+
+static unsigned int lock_tuner_number_of_threads(LLWorkloadProfile * profile){
+    if(profile->numberOfThreads > 0){
+        return profile->numberOfThreads;
+    }
+    long numberOfProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    return numberOfProcessors > 0 ? (unsigned int)numberOfProcessors : 1;
+}
+
+double lock_tuner_benchmark(LL_lock_type_name lockType,
+                            LLWorkloadProfile * profile){
+    unsigned int numberOfThreads = lock_tuner_number_of_threads(profile);
+    LockTunerBenchmark * benchmark =
+        aligned_alloc(CACHE_LINE_SIZE, sizeof(LockTunerBenchmark));
+    LockTunerThreadData * threadData =
+        aligned_alloc(CACHE_LINE_SIZE, sizeof(LockTunerThreadData) * numberOfThreads);
+    pthread_t * threads = malloc(sizeof(pthread_t) * numberOfThreads);
+    benchmark->lock = LL_create(lockType);
+    benchmark->profile = profile;
+    atomic_store_explicit(&benchmark->stop.value, false, memory_order_relaxed);
+    for(int i = 0; i < LOCK_TUNER_SHARED_CACHE_LINES; i++){
+        atomic_store_explicit(&benchmark->sharedData[i].value, 0, memory_order_relaxed);
+    }
+    for(unsigned int i = 0; i < numberOfThreads; i++){
+        threadData[i].benchmark = benchmark;
+        threadData[i].seed = i + 1;
+        threadData[i].operations = 0;
+    }
+    uint64_t startTime = ll_now_nanos();
+    for(unsigned int i = 0; i < numberOfThreads; i++){
+        pthread_create(&threads[i], NULL, &lock_tuner_benchmark_thread, &threadData[i]);
+    }
+    struct timespec runTime = {.tv_sec = LOCK_TUNER_RUN_MILLIS / 1000,
+                               .tv_nsec = (LOCK_TUNER_RUN_MILLIS % 1000) * 1000000};
+    nanosleep(&runTime, NULL);
+    atomic_store_explicit(&benchmark->stop.value, true, memory_order_release);
+    unsigned long operations = 0;
+    for(unsigned int i = 0; i < numberOfThreads; i++){
+        pthread_join(threads[i], NULL);
+        operations = operations + threadData[i].operations;
+    }
+    uint64_t elapsedNanos = ll_now_nanos() - startTime;
+    LL_free(benchmark->lock);
+    free(threads);
+    free(threadData);
+    free(benchmark);
+    return ((double)operations * 1000000000.0) / (double)elapsedNanos;
+}
+
+/* Writes the cache key of the profile to keyBuffer. The number of
+   threads is resolved so that the key is only valid for this
+   machine. */
+static void lock_tuner_cache_key(LLWorkloadProfile * profile,
+                                 char * keyBuffer,
+                                 size_t keyBufferSize){
+    snprintf(keyBuffer,
+             keyBufferSize,
+             "%.4f %.4f %u %u %u",
+             profile->delegatePercentage,
+             profile->readPercentage,
+             lock_tuner_number_of_threads(profile),
+             profile->criticalSectionWork,
+             profile->nonCriticalSectionWork);
+}
+
+static bool lock_tuner_cache_lookup(const char * cacheFile,
+                                    const char * key,
+                                    LL_lock_type_name * lockTypeResult){
+    FILE * file = fopen(cacheFile, "r");
+    if(file == NULL){
+        return false;
+    }
+    char line[LOCK_TUNER_MAX_LINE_LENGTH];
+    size_t keyLength = strlen(key);
+    bool found = false;
+    while(!found && fgets(line, sizeof(line), file) != NULL){
+        if(strncmp(line, key, keyLength) == 0 && line[keyLength] == ' '){
+            char * name = &line[keyLength + 1];
+            name[strcspn(name, "\n")] = '\0';
+            found = lock_tuner_parse_lock_type_name(name, lockTypeResult);
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+static void lock_tuner_cache_store(const char * cacheFile,
+                                   const char * key,
+                                   LL_lock_type_name lockType){
+    FILE * file = fopen(cacheFile, "a");
+    if(file == NULL){
+        return;
+    }
+    fprintf(file, "%s %s\n", key, lock_tuner_lock_type_name(lockType));
+    fclose(file);
+}
+
+LL_lock_type_name lock_tuner_select(LLWorkloadProfile * profile,
+                                    const char * cacheFile){
+    char key[LOCK_TUNER_MAX_LINE_LENGTH];
+    LL_lock_type_name bestLockType = lockTunerCandidates[0].type;
+    lock_tuner_cache_key(profile, key, sizeof(key));
+    if(cacheFile != NULL &&
+       lock_tuner_cache_lookup(cacheFile, key, &bestLockType)){
+        return bestLockType;
+    }
+    double bestThroughput = -1.0;
+    for(unsigned int i = 0; i < LOCK_TUNER_NUMBER_OF_CANDIDATES; i++){
+        double throughput = lock_tuner_benchmark(lockTunerCandidates[i].type, profile);
+        if(throughput > bestThroughput){
+            bestThroughput = throughput;
+            bestLockType = lockTunerCandidates[i].type;
+        }
+    }
+    if(cacheFile != NULL){
+        lock_tuner_cache_store(cacheFile, key, bestLockType);
+    }
+    return bestLockType;
+}
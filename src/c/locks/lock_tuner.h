@@ -0,0 +1,73 @@
+#ifndef LOCK_TUNER_H
+#define LOCK_TUNER_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "locks/locks.h"
+
+/* Lock Tuner */
+
+// The lock tuner selects the lock type that gives the highest
+// throughput for a workload profile on the current machine. The
+// selection is done by running a short microbenchmark with the same
+// operation mix as the lock tests (LL_delegate, LL_rlock and LL_lock)
+// for every candidate lock type. The result can be stored in a cache
+// file so the benchmark only has to run once per machine and profile.
+
+// The time in milliseconds that every candidate lock is benchmarked
+#ifndef LOCK_TUNER_RUN_MILLIS
+#    define LOCK_TUNER_RUN_MILLIS 50
+#endif
+
+// Environment variable that can be set to the path of the cache file
+// used by LL_create_auto
+#define LOCK_TUNER_CACHE_ENV_VAR "LL_LOCK_TUNER_CACHE"
+
+typedef struct {
+    // Fraction of the operations that are done with LL_delegate
+    double delegatePercentage;
+    // Fraction of the operations that are done with LL_rlock. The
+    // remaining operations are done with LL_lock.
+    double readPercentage;
+    // Number of threads, 0 means the number of online processors
+    unsigned int numberOfThreads;
+    // Number of shared cache lines accessed in a critical section
+    unsigned int criticalSectionWork;
+    // Number of local work iterations between two critical sections
+    unsigned int nonCriticalSectionWork;
+} LLWorkloadProfile;
+
+// Returns the name of an OO lock type (e.g. "QD_LOCK") or NULL
+const char * lock_tuner_lock_type_name(LL_lock_type_name lockType);
+// Parses a lock type name. Returns false if the name is unknown.
+bool lock_tuner_parse_lock_type_name(const char * name,
+                                     LL_lock_type_name * lockTypeResult);
+// Runs the microbenchmark for the given OO lock type and returns the
+// throughput in operations per second
+double lock_tuner_benchmark(LL_lock_type_name lockType,
+                            LLWorkloadProfile * profile);
+// Returns the best OO lock type for the profile. If cacheFile is not
+// NULL the result is first looked up in the file and written to the
+// file if it is not found.
+LL_lock_type_name lock_tuner_select(LLWorkloadProfile * profile,
+                                    const char * cacheFile);
+
+// ## LL_create_auto
+
+// `LL_create_auto(profile)` creates an `OOLock *` of the lock type
+// that performs best for the workload profile on this machine. The
+// cache file given by the environment variable `LL_LOCK_TUNER_CACHE`
+// is used if it is set.
+
+// *Example:*
+
+//     LLWorkloadProfile profile = {.delegatePercentage = 0.8,
+//                                  .readPercentage = 0.1};
+//     OOLock * lock = LL_create_auto(profile);
+static inline OOLock * LL_create_auto(LLWorkloadProfile profile){
+    return LL_create(lock_tuner_select(&profile,
+                                       getenv(LOCK_TUNER_CACHE_ENV_VAR)));
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef LOCK_TYPE_NAME_H
+#define LOCK_TYPE_NAME_H
+
+// The names of the lock types that can be given to `LL_create` (see
+// locks/locks.h). This file can be included from both C and C++.
+
+typedef enum {
+    DRMCS_LOCK,
+    MCS_LOCK,
+    TATAS_LOCK,
+    QD_LOCK,
+    CCSYNCH_LOCK,
+    MRQD_LOCK,
+    ADAPTIVE_LOCK,
+    BIASED_LOCK,
+    COMPACT_QD_LOCK,
+    PRIORITY_QD_LOCK,
+    PLAIN_MCS_LOCK,
+    PLAIN_DRMCS_LOCK,
+    PLAIN_TATAS_LOCK,
+    PLAIN_QD_LOCK,
+    PLAIN_CCSYNCH_LOCK,
+    PLAIN_MRQD_LOCK,
+    PLAIN_ADAPTIVE_LOCK,
+    PLAIN_BIASED_LOCK,
+    PLAIN_COMPACT_QD_LOCK,
+    PLAIN_PRIORITY_QD_LOCK
+} LL_lock_type_name;
+
+#endif
@@ -18,6 +18,13 @@
 #include "locks/qd_lock.h"
 #include "locks/mrqd_lock.h"
 #include "locks/ccsynch_lock.h"
+#include "locks/adaptive_lock.h"
+#include "locks/biased_lock.h"
+#include "locks/compact_qd_lock.h"
+#include "locks/priority_qd_lock.h"
+#include "locks/delegate_deadline.h"
+#include "locks/delegate_async.h"
+#include "locks/lock_type_name.h"
 #include "misc/misc_utils.h"
 #include "misc/error_help.h"
 
@@ -28,6 +35,10 @@
 // * `TATASLock*`
 // * `QDLock*`
 // * `MRQDLock*`
+// * `AdaptiveLock*`
+// * `BiasedLock*`
+// * `CompactQDLock*`
+// * `PriorityQDLock*`
 // * `CCSynch*`
 // * `TATASLock*`
 // * `MCSLock`
@@ -44,7 +55,12 @@
      QDLock * : qd_initialize((QDLock *)X), \
      CCSynchLock * : ccsynch_initialize((CCSynchLock * )X), \
      MCSLock * : mcs_initialize((MCSLock * )X), \
-     MRQDLock * : mrqd_initialize((MRQDLock *)X) \
+     MRQDLock * : mrqd_initialize((MRQDLock *)X), \
+     DRMCSLock * : drmcs_initialize((DRMCSLock *)X), \
+     AdaptiveLock * : adaptive_initialize((AdaptiveLock *)X), \
+     BiasedLock * : biased_initialize((BiasedLock *)X), \
+     CompactQDLock * : cqd_initialize((CompactQDLock *)X), \
+     PriorityQDLock * : pqd_initialize((PriorityQDLock *)X) \
                                 )
 // ## LL_destroy
 // 
@@ -52,7 +68,10 @@
 // is a pointer to a lock value. This call can free resources
 // allocated by `LL_initialize(X)`.
 #define LL_destroy(X) _Generic((X),      \
-     default : UNUSED(X), \
+     MRQDLock * : mrqd_destroy((MRQDLock *)X), \
+     DRMCSLock * : drmcs_destroy((DRMCSLock *)X), \
+     CompactQDLock * : cqd_destroy((CompactQDLock *)X), \
+     default : UNUSED(X) \
                                )
 
 // ## LL_create
@@ -65,30 +84,25 @@
 // * `TATAS_LOCK` gives the return type `OOLock *`
 // * `QD_LOCK` gives the return type `OOLock *`
 // * `MRQD_LOCK` gives the return type `OOLock *`
+// * `ADAPTIVE_LOCK` gives the return type `OOLock *`
+// * `BIASED_LOCK` gives the return type `OOLock *`
+// * `COMPACT_QD_LOCK` gives the return type `OOLock *`
+// * `PRIORITY_QD_LOCK` gives the return type `OOLock *`
 // * `CCSYNCH_LOCK` gives the return type `OOLock *`
 // * `MCS_LOCK` gives the return type `OOLock *`
 // * `DRMCS_LOCK` gives the return type `OOLock *`
 // * `PLAIN_TATAS_LOCK` gives the return type `TATASLock *`
 // * `PLAIN_QD_LOCK` gives the return type `QDLock *`
 // * `PLAIN_MRQD_LOCK` gives the return type `MRQDLock *`
+// * `PLAIN_ADAPTIVE_LOCK` gives the return type `AdaptiveLock *`
+// * `PLAIN_BIASED_LOCK` gives the return type `BiasedLock *`
+// * `PLAIN_COMPACT_QD_LOCK` gives the return type `CompactQDLock *`
+// * `PLAIN_PRIORITY_QD_LOCK` gives the return type `PriorityQDLock *`
 // * `PLAIN_CCSYNCH_LOCK` gives the return type `CCSynchLock *`
 // * `PLAIN_MCS_LOCK` gives the return type `MCSLock *`
 // * `PLAIN_DRMCS_LOCK` gives the return type `DRMCSLock *`
 
-typedef enum {
-    DRMCS_LOCK,
-    MCS_LOCK,
-    TATAS_LOCK,
-    QD_LOCK,
-    CCSYNCH_LOCK,
-    MRQD_LOCK,
-    PLAIN_MCS_LOCK, 
-    PLAIN_DRMCS_LOCK, 
-    PLAIN_TATAS_LOCK, 
-    PLAIN_QD_LOCK,
-    PLAIN_CCSYNCH_LOCK,
-    PLAIN_MRQD_LOCK
-} LL_lock_type_name;
+// The names are defined in locks/lock_type_name.h.
 
 // When calling `LL_*` functions the parameter must be of the correct
 // lock type.
@@ -101,6 +115,14 @@ static inline void * LL_create(LL_lock_type_name llLockType){
         return oo_ccsynch_create();
     } else if (MRQD_LOCK == llLockType){
         return oo_mrqd_create();
+    } else if (ADAPTIVE_LOCK == llLockType){
+        return oo_adaptive_create();
+    } else if (BIASED_LOCK == llLockType){
+        return oo_biased_create();
+    } else if (COMPACT_QD_LOCK == llLockType){
+        return oo_cqd_create();
+    } else if (PRIORITY_QD_LOCK == llLockType){
+        return oo_pqd_create();
     }else if (MCS_LOCK == llLockType){
         return oo_mcs_create();
     }else if (DRMCS_LOCK == llLockType){
@@ -113,6 +135,14 @@ static inline void * LL_create(LL_lock_type_name llLockType){
         return plain_ccsynch_create();
     } else if (PLAIN_MRQD_LOCK == llLockType){
         return plain_mrqd_create();
+    } else if (PLAIN_ADAPTIVE_LOCK == llLockType){
+        return plain_adaptive_create();
+    } else if (PLAIN_BIASED_LOCK == llLockType){
+        return plain_biased_create();
+    } else if (PLAIN_COMPACT_QD_LOCK == llLockType){
+        return plain_cqd_create();
+    } else if (PLAIN_PRIORITY_QD_LOCK == llLockType){
+        return plain_pqd_create();
     }else if (PLAIN_MCS_LOCK == llLockType){
         return plain_mcs_create();
     }else if (PLAIN_DRMCS_LOCK == llLockType){
@@ -123,6 +153,94 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     return NULL;/* Should not be reachable */
 }
 
+// ## LL_create\_with\_read\_indicator
+
+// `LL_create_with_read_indicator(X, readIndicatorType)` works like
+// `LL_create(X)` for the reader-writer locks (`MRQD_LOCK`,
+// `DRMCS_LOCK` and their `PLAIN_` variants) but also selects the read
+// indicator implementation used by the lock. See
+// `read_indicators/read_indicator.h` for the available types.
+
+// *Example:*
+
+//     OOLock * lock = LL_create_with_read_indicator(MRQD_LOCK, SNZI_READ_INDICATOR);
+static inline void * LL_create_with_read_indicator(LL_lock_type_name llLockType,
+                                                   LL_read_indicator_type readIndicatorType){
+    if(MRQD_LOCK == llLockType){
+        return oo_mrqd_create_with_read_indicator(readIndicatorType);
+    }else if (DRMCS_LOCK == llLockType){
+        return oo_drmcs_create_with_read_indicator(readIndicatorType);
+    }else if (PLAIN_MRQD_LOCK == llLockType){
+        return plain_mrqd_create_with_read_indicator(readIndicatorType);
+    }else if (PLAIN_DRMCS_LOCK == llLockType){
+        return plain_drmcs_create_with_read_indicator(readIndicatorType);
+    }
+
+    LL_error_and_exit("Lock type does not have a read indicator\n");
+    return NULL;/* Should not be reachable */
+}
+
+// ## LL_create\_with\_read\_indicator\_width
+
+// `LL_create_with_read_indicator_width(X, readIndicatorType, width)`
+// works like `LL_create_with_read_indicator` but also sets the number
+// of reader groups of the reader group indicators. `width` has to be a
+// power of two not larger than `MRQD_LOCK_NUMBER_OF_READER_GROUPS`.
+// Each group takes a cache line, so a small width saves memory when a
+// program has many locks.
+
+// *Example:*
+
+//     OOLock * lock = LL_create_with_read_indicator_width(MRQD_LOCK, READER_GROUPS_READ_INDICATOR, 4);
+static inline void * LL_create_with_read_indicator_width(LL_lock_type_name llLockType,
+                                                         LL_read_indicator_type readIndicatorType,
+                                                         int width){
+    if(MRQD_LOCK == llLockType){
+        return oo_mrqd_create_with_read_indicator_width(readIndicatorType, width);
+    }else if (DRMCS_LOCK == llLockType){
+        return oo_drmcs_create_with_read_indicator_width(readIndicatorType, width);
+    }else if (PLAIN_MRQD_LOCK == llLockType){
+        return plain_mrqd_create_with_read_indicator_width(readIndicatorType, width);
+    }else if (PLAIN_DRMCS_LOCK == llLockType){
+        return plain_drmcs_create_with_read_indicator_width(readIndicatorType, width);
+    }
+
+    LL_error_and_exit("Lock type does not have a read indicator\n");
+    return NULL;/* Should not be reachable */
+}
+
+// ## LL_create\_with\_shared\_read\_indicator
+
+// `LL_create_with_shared_read_indicator(X, readIndicator)` creates a
+// reader-writer lock that uses an already initialized read indicator
+// instead of allocating its own. Many locks can share one indicator to
+// save memory, but a writer then waits for the readers of all the
+// locks, and a thread must not take a read lock on one of the locks
+// while it holds a read lock on another. The indicator has to be
+// destroyed with `ri_destroy` after all locks using it are freed.
+
+// *Example:*
+
+//     ReadIndicator indicator;
+//     ri_initialize(&indicator, READER_GROUPS_READ_INDICATOR);
+//     OOLock * lock1 = LL_create_with_shared_read_indicator(MRQD_LOCK, &indicator);
+//     OOLock * lock2 = LL_create_with_shared_read_indicator(MRQD_LOCK, &indicator);
+static inline void * LL_create_with_shared_read_indicator(LL_lock_type_name llLockType,
+                                                          ReadIndicator * readIndicator){
+    if(MRQD_LOCK == llLockType){
+        return oo_mrqd_create_with_shared_read_indicator(readIndicator);
+    }else if (DRMCS_LOCK == llLockType){
+        return oo_drmcs_create_with_shared_read_indicator(readIndicator);
+    }else if (PLAIN_MRQD_LOCK == llLockType){
+        return plain_mrqd_create_with_shared_read_indicator(readIndicator);
+    }else if (PLAIN_DRMCS_LOCK == llLockType){
+        return plain_drmcs_create_with_shared_read_indicator(readIndicator);
+    }
+
+    LL_error_and_exit("Lock type does not have a read indicator\n");
+    return NULL;/* Should not be reachable */
+}
+
 // ## LL_free
 
 // `LL_free(X)` frees the memory of a lock created with `LL_create(X)`.
@@ -133,6 +251,9 @@ static inline void * LL_create(LL_lock_type_name llLockType){
 //     LL_free(lock)
 #define LL_free(X) _Generic((X),\
     OOLock * : oolock_free((OOLock *)X),        \
+    MRQDLock * : mrqd_free(X),        \
+    DRMCSLock * : drmcs_free(X),        \
+    CompactQDLock * : cqd_free(X),        \
     default : free(X)           \
                             )
 
@@ -143,9 +264,13 @@ static inline void * LL_create(LL_lock_type_name llLockType){
 // pointer to a value of a lock type.
 #define LL_lock(X) _Generic((X),         \
     TATASLock *: tatas_lock((TATASLock *)X),                \
-    QDLock * : tatas_lock(&((QDLock *)X)->mutexLock),       \
+    QDLock * : qd_lock((QDLock *)X),       \
     CCSynchLock * : ccsynch_lock(X),       \
     MRQDLock * : mrqd_lock((MRQDLock *)X),       \
+    AdaptiveLock * : adaptive_lock((AdaptiveLock *)X),       \
+    BiasedLock * : biased_lock((BiasedLock *)X), \
+    CompactQDLock * : cqd_lock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_lock((PriorityQDLock *)X), \
     MCSLock * : mcs_lock((MCSLock *)X),       \
     DRMCSLock * : drmcs_lock((DRMCSLock *)X),       \
     OOLock * : ((OOLock *)X)->m->lock(((OOLock *)X)->lock) \
@@ -165,9 +290,13 @@ static inline void * LL_create(LL_lock_type_name llLockType){
 //     LL_unlock(lock)
 #define LL_unlock(X) _Generic((X),    \
     TATASLock *: tatas_unlock((TATASLock *)X), \
-    QDLock * : tatas_unlock(&((QDLock *)X)->mutexLock), \
+    QDLock * : qd_unlock((QDLock *)X), \
     CCSynchLock * : ccsynch_unlock(X), \
-    MRQDLock * : tatas_unlock(&((MRQDLock *)X)->mutexLock), \
+    MRQDLock * : mrqd_unlock((MRQDLock *)X), \
+    AdaptiveLock * : tatas_unlock(&((AdaptiveLock *)X)->mutexLock), \
+    BiasedLock * : biased_unlock((BiasedLock *)X), \
+    CompactQDLock * : cqd_unlock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_unlock((PriorityQDLock *)X), \
     MCSLock * : mcs_unlock(X), \
     DRMCSLock * : drmcs_unlock(X), \
     OOLock * : ((OOLock *)X)->m->unlock(((OOLock *)X)->lock)      \
@@ -184,6 +313,10 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : mcs_is_locked(X), \
     DRMCSLock * : drmcs_is_locked(X), \
     MRQDLock * : tatas_is_locked(&((MRQDLock *)X)->mutexLock), \
+    AdaptiveLock * : tatas_is_locked(&((AdaptiveLock *)X)->mutexLock), \
+    BiasedLock * : biased_is_locked((BiasedLock *)X), \
+    CompactQDLock * : cqd_is_locked((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_is_locked((PriorityQDLock *)X), \
     OOLock * : ((OOLock *)X)->m->is_locked(((OOLock *)X)->lock)      \
     )
 
@@ -194,23 +327,53 @@ static inline void * LL_create(LL_lock_type_name llLockType){
 // value of a lock type.
 #define LL_try_lock(X) _Generic((X),    \
     TATASLock *: tatas_try_lock(X), \
-    MRQDLock * : tatas_try_lock(&((MRQDLock *)X)->mutexLock), \
-    QDLock * : tatas_try_lock(&((QDLock *)X)->mutexLock), \
+    MRQDLock * : mrqd_try_lock((MRQDLock *)X), \
+    AdaptiveLock * : tatas_try_lock(&((AdaptiveLock *)X)->mutexLock), \
+    BiasedLock * : biased_try_lock((BiasedLock *)X), \
+    CompactQDLock * : cqd_try_lock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_try_lock((PriorityQDLock *)X), \
+    QDLock * : qd_try_lock((QDLock *)X), \
     CCSynchLock * : ccsynch_try_lock(X), \
     MCSLock * : mcs_try_lock(X), \
     DRMCSLock * : drmcs_try_lock(X), \
     OOLock * : ((OOLock *)X)->m->try_lock(((OOLock *)X)->lock)      \
     )
 
+// ## LL_lock\_timed
+
+// `LL_lock_timed(X, timeoutNanos)` works like `LL_lock(X)` but gives
+// up after waiting `timeoutNanos` nanoseconds. The function returns
+// true if `X` was locked and false if the timeout expired. The queue
+// based locks (MCS, DR-MCS and CC-Synch) abandon their place in the
+// queue when the timeout expires so the lock is never handed over to
+// a thread that has stopped waiting.
+#define LL_lock_timed(X, timeoutNanos) _Generic((X),    \
+    TATASLock *: tatas_lock_timed((TATASLock *)X, timeoutNanos), \
+    QDLock * : qd_lock_timed((QDLock *)X, timeoutNanos), \
+    CCSynchLock * : ccsynch_lock_timed(X, timeoutNanos), \
+    MCSLock * : mcs_lock_timed(X, timeoutNanos), \
+    DRMCSLock * : drmcs_lock_timed(X, timeoutNanos), \
+    MRQDLock * : mrqd_lock_timed((MRQDLock *)X, timeoutNanos), \
+    AdaptiveLock * : adaptive_lock_timed((AdaptiveLock *)X, timeoutNanos), \
+    BiasedLock * : biased_lock_timed((BiasedLock *)X, timeoutNanos), \
+    CompactQDLock * : cqd_lock_timed((CompactQDLock *)X, timeoutNanos), \
+    PriorityQDLock * : pqd_lock_timed((PriorityQDLock *)X, timeoutNanos), \
+    OOLock * : ((OOLock *)X)->m->lock_timed(((OOLock *)X)->lock, timeoutNanos) \
+    )
+
 // ## LL_rlock
 
 #define LL_rlock(X) _Generic((X),         \
     TATASLock *: tatas_lock((TATASLock *)X),                \
-    QDLock * : tatas_lock(&((QDLock *)X)->mutexLock),       \
+    QDLock * : qd_rlock((QDLock *)X),       \
     CCSynchLock * : ccsynch_lock(X),       \
     MCSLock * : mcs_lock(X),       \
     DRMCSLock * : drmcs_lock(X),       \
     MRQDLock * : mrqd_rlock((MRQDLock *)X),       \
+    AdaptiveLock * : adaptive_lock((AdaptiveLock *)X),       \
+    BiasedLock * : biased_lock((BiasedLock *)X), \
+    CompactQDLock * : cqd_lock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_rlock((PriorityQDLock *)X), \
     OOLock * : ((OOLock *)X)->m->rlock(((OOLock *)X)->lock) \
                                 )                
 
@@ -218,14 +381,121 @@ static inline void * LL_create(LL_lock_type_name llLockType){
 
 #define LL_runlock(X) _Generic((X),    \
     TATASLock *: tatas_unlock((TATASLock *)X), \
-    QDLock * : tatas_unlock(&((QDLock *)X)->mutexLock), \
+    QDLock * : qd_runlock((QDLock *)X), \
     CCSynchLock * : ccsynch_unlock(X), \
     MCSLock * : mcs_unlock(X), \
     DRMCSLock * : drmcs_unlock(X), \
     MRQDLock * : mrqd_runlock((MRQDLock *)X), \
+    AdaptiveLock * : adaptive_unlock((AdaptiveLock *)X), \
+    BiasedLock * : biased_unlock((BiasedLock *)X), \
+    CompactQDLock * : cqd_unlock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_runlock((PriorityQDLock *)X), \
     OOLock * : ((OOLock *)X)->m->runlock(((OOLock *)X)->lock)      \
     )
 
+// ## LL_oread\_begin and LL_oread\_validate
+
+// Optimistic reads do not write to shared memory. `LL_oread_begin(X)`
+// returns the current version of the lock `X` and
+// `LL_oread_validate(X, version)` returns true if no thread has held
+// `X` for writing since the version was read. The version is
+// incremented around every critical section and every batch of
+// delegated critical sections that the holder executes, so values
+// read between a begin and a successful validate are consistent.
+
+// The reads in an optimistic read section may observe a critical
+// section that is in progress. They must not fail on inconsistent
+// values and must not dereference pointers that a critical section
+// may free. Only values that have been validated may be used. A
+// section that fails to validate can be retried and should fall back
+// to `LL_rlock` after a few attempts, since a lock that is held most
+// of the time rarely validates.
+
+// Supported for `QDLock*`, `MRQDLock*` and `OOLock*`. An `OOLock` of a
+// type that does not have a version never validates.
+
+// *Example:*
+
+//     for(int i = 0; i < 3; i++){
+//         unsigned long version = LL_oread_begin(lock);
+//         value = sharedValue;
+//         if(LL_oread_validate(lock, version)){
+//             return value;
+//         }
+//     }
+//     LL_rlock(lock);
+//     value = sharedValue;
+//     LL_runlock(lock);
+//     return value;
+#define LL_oread_begin(X) _Generic((X),    \
+    QDLock * : qd_oread_begin(X), \
+    MRQDLock * : mrqd_oread_begin(X), \
+    OOLock * : oolock_oread_begin((OOLock *)X) \
+    )
+
+#define LL_oread_validate(X, version) _Generic((X),    \
+    QDLock * : qd_oread_validate(X, version), \
+    MRQDLock * : mrqd_oread_validate(X, version), \
+    OOLock * : oolock_oread_validate((OOLock *)X, version) \
+    )
+
+// ## LL_upgrade and LL_downgrade
+
+// `LL_upgrade(X)` turns a read lock on `X` that is held by the
+// calling thread into a write lock without letting other writers in
+// between, so values read under the read lock are still valid after
+// a successful upgrade. The upgrade fails when another thread holds or
+// is waiting for the write lock, since that thread is waiting for the
+// readers to leave, or when readers have raised the write barrier.
+// The function returns true if the upgrade succeeded. The read lock
+// is released when the upgrade fails, so the caller has to take the
+// lock again and repeat its reads.
+
+// `LL_upgrade_or_delegate(X, funPtr, messageSize, messageAddress)`
+// works like `LL_upgrade(X)` but delegates the function when the
+// upgrade fails (see `LL_delegate`). The delegated function runs
+// after the read lock is released, so it has to check again the
+// condition that the reader checked. The function returns true if
+// the caller holds the write lock and false if it has delegated.
+
+// `LL_downgrade(X)` turns a write lock on `X` that was taken with
+// `LL_lock` or `LL_upgrade` into a read lock. No writer can get the
+// lock in between. The read lock is released with `LL_runlock`.
+
+// Supported for `MRQDLock*`, `DRMCSLock*` and `OOLock*`. For an
+// `OOLock` of a type without read locks `LL_upgrade` always fails and
+// `LL_downgrade` exits with an error.
+
+// *Example:*
+
+//     LL_rlock(lock);
+//     Entry * entry = lookup(table, key);
+//     if(entry == NULL){
+//         if(LL_upgrade_or_delegate(lock, insert_if_absent, sizeof(key), &key)){
+//             insert(table, key);
+//             LL_unlock(lock);
+//         }
+//     }else{
+//         LL_runlock(lock);
+//     }
+#define LL_upgrade(X) _Generic((X),    \
+    MRQDLock * : mrqd_upgrade(X), \
+    DRMCSLock * : drmcs_upgrade(X), \
+    OOLock * : oolock_upgrade((OOLock *)X) \
+    )
+
+#define LL_upgrade_or_delegate(X, funPtr, messageSize, messageAddress) _Generic((X), \
+    MRQDLock * : mrqd_upgrade_or_delegate(X, funPtr, messageSize, messageAddress), \
+    DRMCSLock * : drmcs_upgrade_or_delegate(X, funPtr, messageSize, messageAddress), \
+    OOLock * : oolock_upgrade_or_delegate((OOLock *)X, funPtr, messageSize, messageAddress) \
+    )
+
+#define LL_downgrade(X) _Generic((X),    \
+    MRQDLock * : mrqd_downgrade(X), \
+    DRMCSLock * : drmcs_downgrade(X), \
+    OOLock * : oolock_downgrade((OOLock *)X) \
+    )
+
 
 // ## LL_delegate
 
@@ -278,9 +548,40 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : mcs_delegate(X, funPtr, messageSize, messageAddress), \
     DRMCSLock * : drmcs_delegate(X, funPtr, messageSize, messageAddress), \
     MRQDLock * : mrqd_delegate((MRQDLock *)X, funPtr, messageSize, messageAddress), \
+    AdaptiveLock * : adaptive_delegate((AdaptiveLock *)X, funPtr, messageSize, messageAddress), \
+    BiasedLock * : biased_delegate((BiasedLock *)X, funPtr, messageSize, messageAddress), \
+    CompactQDLock * : cqd_delegate((CompactQDLock *)X, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : pqd_delegate((PriorityQDLock *)X, funPtr, messageSize, messageAddress), \
     OOLock * : ((OOLock *)X)->m->delegate(((OOLock *)X)->lock, funPtr, messageSize, messageAddress) \
     )
 
+// ## LL_delegate_read
+
+// `LL_delegate_read(X, funPtr, messageSize, messageAddress)` executes
+// a read only critical section and returns when it has been executed.
+// For `MRQDLock*` the function runs in the calling thread under the
+// read indicator when no writer holds the lock. When a writer holds
+// the lock in a delegate operation, the function is instead put in the
+// delegation queue and executed by the writer together with the
+// delegated writes, so the reader does not have to wait for the whole
+// write batch. If the writer holds the lock with `LL_lock` the reader
+// waits as in `LL_rlock`.
+
+// The function may be executed by another thread, so results have to
+// be passed back through pointers in the message. The function must
+// not modify the data protected by `X`. For other lock types the
+// function is executed under `LL_rlock`.
+
+// *Example:*
+
+//     int * resultPtr = &result;
+//     LL_delegate_read(lock, read_value, sizeof(int *), &resultPtr);
+#define LL_delegate_read(X, funPtr, messageSize, messageAddress) _Generic((X), \
+    MRQDLock * : mrqd_delegate_read(X, funPtr, messageSize, messageAddress), \
+    OOLock * : oolock_delegate_read((OOLock *)X, funPtr, messageSize, messageAddress), \
+    default : (LL_rlock(X), funPtr(messageSize, messageAddress), LL_runlock(X)) \
+    )
+
 // ## LL_delegate_wait
 
 // Works in the same way as LL_delegate but the function will not
@@ -293,9 +594,253 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : mcs_delegate(X, funPtr, messageSize, messageAddress), \
     DRMCSLock * : drmcs_delegate(X, funPtr, messageSize, messageAddress), \
     MRQDLock * : mrqd_delegate_wait((MRQDLock *)X, funPtr, messageSize, messageAddress), \
+    AdaptiveLock * : adaptive_delegate_wait((AdaptiveLock *)X, funPtr, messageSize, messageAddress), \
+    BiasedLock * : biased_delegate((BiasedLock *)X, funPtr, messageSize, messageAddress), \
+    CompactQDLock * : cqd_delegate_wait((CompactQDLock *)X, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : pqd_delegate_wait((PriorityQDLock *)X, funPtr, messageSize, messageAddress), \
     OOLock * : ((OOLock *)X)->m->delegate_wait(((OOLock *)X)->lock, funPtr, messageSize, messageAddress) \
     )
 
+// ## LL_delegate\_fence and LL_delegate\_fence\_all
+
+// `LL_delegate_fence(X)` returns when all critical sections that the
+// calling thread has delegated to `X` have been executed.
+// `LL_delegate_fence_all()` does the same for all QD, MRQD, priority
+// QD, adaptive and compact QD locks the thread has delegated to.
+// These locks track the delegations of each thread without sending
+// anything to the lock (see locks/delegate_fence.h). For the other
+// lock types a delegated critical section has always been executed
+// when `LL_delegate` returns.
+
+// *Example:*
+
+//     LL_delegate(accountLock, deposit, sizeof(amount), &amount);
+//     LL_delegate(logLock, append_log, sizeof(entry), &entry);
+//     LL_delegate_fence_all();
+//     reply_to_client();
+#define LL_delegate_fence(X) _Generic((X), \
+    QDLock * : qd_delegate_fence(X), \
+    MRQDLock * : mrqd_delegate_fence(X), \
+    AdaptiveLock * : adaptive_delegate_fence(X), \
+    CompactQDLock * : cqd_delegate_fence(X), \
+    PriorityQDLock * : pqd_delegate_fence(X), \
+    OOLock * : oolock_delegate_fence((OOLock *)X), \
+    default : (void)(X) \
+    )
+
+// ## LL_delegate\_forward
+
+// `LL_delegate_forward(X, funPtr, messageSize, messageAddress)` is
+// used inside a critical section of a QD, MRQD or priority QD lock to
+// delegate a follow-up critical section to the lock `X` without
+// waiting for `X`. The follow-up is put in the queue of `X` if a
+// holder of `X` has opened it and is otherwise delegated when the
+// current lock has been released. This avoids stalling the batch of
+// the current lock and the deadlock that occurs when two holders wait
+// for each other's locks. The follow-ups of a thread are delegated in
+// the order they were forwarded. A delegation fence on a lock (see
+// `LL_delegate_fence`) also waits for the follow-ups that have been
+// forwarded from its critical sections. Follow-ups forwarded by a
+// critical section that the calling thread executes itself are
+// covered by `LL_delegate_fence_all`. `X` has to be a QD, MRQD or
+// priority QD lock. The program exits with an error if `X` is an
+// `OOLock` of another type. See locks/delegate_forward.h.
+
+// *Example:*
+
+//     void withdraw(unsigned int messageSize, void * messageAddress){
+//         Transfer * transfer = messageAddress;
+//         transfer->from->balance -= transfer->amount;
+//         LL_delegate_forward(transfer->to->lock, deposit, messageSize, messageAddress);
+//     }
+#define LL_delegate_forward(X, funPtr, messageSize, messageAddress) _Generic((X), \
+    QDLock * : ll_delegate_forward(X, qd_delegate, qd_try_enqueue, funPtr, messageSize, messageAddress), \
+    MRQDLock * : ll_delegate_forward(X, mrqd_delegate, mrqd_try_enqueue, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : ll_delegate_forward(X, pqd_delegate, pqd_try_enqueue, funPtr, messageSize, messageAddress), \
+    OOLock * : oolock_delegate_forward((OOLock *)X, funPtr, messageSize, messageAddress) \
+    )
+
+// ## LL_delegate\_priority and LL_delegate\_wait\_priority
+
+// `LL_delegate_priority(X, priority, funPtr, messageSize,
+// messageAddress)` and `LL_delegate_wait_priority(...)` work like
+// `LL_delegate` and `LL_delegate_wait` but give the critical section a
+// priority. A `PriorityQDLock` has `PQD_LOCK_NUMBER_OF_LANES` priority
+// lanes where 0 is the highest priority, and the holder executes the
+// high priority lanes first within a fairness bound (see
+// locks/priority_qd_lock.h). The normal delegate operations use the
+// lowest priority. Other lock types ignore the priority.
+
+// *Example:*
+
+//     OOLock * lock = LL_create(PRIORITY_QD_LOCK);
+//     LL_delegate(lock, bulk_update, sizeof(update), &update);
+//     LL_delegate_wait_priority(lock, 0, health_check, sizeof(statusPtr), &statusPtr);
+#define LL_delegate_priority(X, priority, funPtr, messageSize, messageAddress) _Generic((X), \
+    PriorityQDLock * : pqd_delegate_priority(X, priority, funPtr, messageSize, messageAddress), \
+    OOLock * : oolock_delegate_priority((OOLock *)X, priority, funPtr, messageSize, messageAddress), \
+    default : LL_delegate(X, funPtr, messageSize, messageAddress) \
+    )
+
+#define LL_delegate_wait_priority(X, priority, funPtr, messageSize, messageAddress) _Generic((X), \
+    PriorityQDLock * : pqd_delegate_wait_priority(X, priority, funPtr, messageSize, messageAddress), \
+    OOLock * : oolock_delegate_wait_priority((OOLock *)X, priority, funPtr, messageSize, messageAddress), \
+    default : LL_delegate_wait(X, funPtr, messageSize, messageAddress) \
+    )
+
+// ## LL_delegate\_deadline
+
+// `LL_delegate_deadline(X, deadline, cancelFunPtr, funPtr, messageSize,
+// messageAddress)` works like `LL_delegate` but the critical section
+// is only executed if the deadline has not passed when the executing
+// thread gets to it. The deadline is a time from `ll_now_nanos` (see
+// misc/timing.h). If the deadline has passed, `cancelFunPtr` is called
+// with the message instead, unless it is NULL. Both functions are
+// called with the lock held. With delegating locks this makes a holder
+// that has fallen behind skip the requests that have expired in the
+// queue (see locks/delegate_deadline.h).
+
+// *Example:*
+
+//     uint64_t deadline = ll_deadline_from_timeout(request->timeoutNanos);
+//     LL_delegate_deadline(lock, deadline, reply_timeout, handle_request, sizeof(request), &request);
+#define LL_delegate_deadline(X, deadline, cancelFunPtr, funPtr, messageSize, messageAddress) _Generic((X), \
+    TATASLock * : ll_delegate_deadline(X, tatas_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    QDLock * : ll_delegate_deadline(X, qd_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    CCSynchLock * : ll_delegate_deadline(X, ccsynch_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    MCSLock * : ll_delegate_deadline(X, mcs_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    DRMCSLock * : ll_delegate_deadline(X, drmcs_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    MRQDLock * : ll_delegate_deadline(X, mrqd_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    AdaptiveLock * : ll_delegate_deadline(X, adaptive_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    BiasedLock * : ll_delegate_deadline(X, biased_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    CompactQDLock * : ll_delegate_deadline(X, cqd_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : ll_delegate_deadline(X, pqd_delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress), \
+    OOLock * : ll_delegate_deadline(((OOLock *)X)->lock, ((OOLock *)X)->m->delegate, deadline, cancelFunPtr, funPtr, messageSize, messageAddress) \
+    )
+
+// ## LL_delegate\_async
+
+// `LL_delegate_async(X, ring, tag, funPtr, messageSize, messageAddress)`
+// works like `LL_delegate` but writes `tag` to the completion ring
+// `ring` after the critical section has been executed. The ring has a
+// file descriptor that becomes readable when there are completions, so
+// an event loop can poll it together with its sockets and call
+// `ll_completion_ring_harvest` to get the tags (see
+// locks/delegate_async.h). Returns false without delegating when all
+// slots of the ring are reserved by delegations that have not been
+// harvested.
+
+// *Example:*
+
+//     LLCompletionRing * ring = ll_completion_ring_create(1024);
+//     LL_delegate_async(lock, ring, request, handle_request, sizeof(request), &request);
+//     ...
+//     //When ll_completion_ring_fd(ring) is readable
+//     void * tags[64];
+//     unsigned int n = ll_completion_ring_harvest(ring, tags, 64);
+//     for(unsigned int i = 0; i < n; i++){
+//         send_reply(tags[i]);
+//     }
+#define LL_delegate_async(X, ring, tag, funPtr, messageSize, messageAddress) _Generic((X), \
+    TATASLock * : ll_delegate_async(X, tatas_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    QDLock * : ll_delegate_async(X, qd_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    CCSynchLock * : ll_delegate_async(X, ccsynch_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    MCSLock * : ll_delegate_async(X, mcs_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    DRMCSLock * : ll_delegate_async(X, drmcs_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    MRQDLock * : ll_delegate_async(X, mrqd_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    AdaptiveLock * : ll_delegate_async(X, adaptive_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    BiasedLock * : ll_delegate_async(X, biased_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    CompactQDLock * : ll_delegate_async(X, cqd_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : ll_delegate_async(X, pqd_delegate, ring, tag, funPtr, messageSize, messageAddress), \
+    OOLock * : ll_delegate_async(((OOLock *)X)->lock, ((OOLock *)X)->m->delegate, ring, tag, funPtr, messageSize, messageAddress) \
+    )
+
+// ## LL_wait\_until
+
+// `LL_wait_until(X, predicate, arg)` blocks until `predicate(arg)`
+// returns true. The predicate has the type `bool (*)(void *)` and is
+// always called with the lock held, so it can read the state
+// protected by the lock. It can also change the state when it returns
+// true, for example to take an element from a queue that has become
+// non-empty. It must not take the lock X.
+
+// With QD, MRQD and priority QD locks the waiting thread does not
+// take the lock. It registers the predicate in the lock and the lock
+// holders evaluate it every time they release the lock after writing
+// (see locks/wait_until.h). With the other lock types the waiting
+// thread takes the lock and evaluates the predicate until it is
+// satisfied.
+
+// *Example:*
+
+//     bool take_if_not_empty(void * arg){
+//         Take * take = arg;
+//         if(queue_is_empty(take->queue)){
+//             return false;
+//         }
+//         take->element = queue_dequeue(take->queue);
+//         return true;
+//     }
+//     ...
+//     Take take = {.queue = queue};
+//     LL_wait_until(lock, take_if_not_empty, &take);
+#define LL_wait_until(X, predicate, arg) _Generic((X), \
+    TATASLock * : ll_wait_until_polling(X, tatas_lock, tatas_unlock, predicate, arg), \
+    QDLock * : qd_wait_until(X, predicate, arg), \
+    CCSynchLock * : ll_wait_until_polling(X, ccsynch_lock, ccsynch_unlock, predicate, arg), \
+    MCSLock * : ll_wait_until_polling(X, mcs_lock, mcs_unlock, predicate, arg), \
+    DRMCSLock * : ll_wait_until_polling(X, drmcs_lock, drmcs_unlock, predicate, arg), \
+    MRQDLock * : mrqd_wait_until(X, predicate, arg), \
+    AdaptiveLock * : ll_wait_until_polling(X, adaptive_lock, adaptive_unlock, predicate, arg), \
+    BiasedLock * : ll_wait_until_polling(X, biased_lock, biased_unlock, predicate, arg), \
+    CompactQDLock * : ll_wait_until_polling(X, cqd_lock, cqd_unlock, predicate, arg), \
+    PriorityQDLock * : pqd_wait_until(X, predicate, arg), \
+    OOLock * : oolock_wait_until((OOLock *)X, predicate, arg) \
+    )
+
+
+// ## LL_try\_delegate
+
+// `LL_try_delegate(X, funPtr, messageSize, messageAddress)` works like
+// `LL_delegate` but never waits. The function returns true if the
+// critical section was executed or handed over to the current lock
+// holder and false if neither was possible right away. Nothing is
+// executed when false is returned.
+
+#define LL_try_delegate(X, funPtr, messageSize, messageAddress) _Generic((X),      \
+    TATASLock *: tatas_try_delegate((TATASLock *)X, funPtr, messageSize, messageAddress), \
+    QDLock * : qd_try_delegate((QDLock *)X, funPtr, messageSize, messageAddress), \
+    CCSynchLock * : ccsynch_try_delegate(X, funPtr, messageSize, messageAddress), \
+    MCSLock * : mcs_try_delegate(X, funPtr, messageSize, messageAddress), \
+    DRMCSLock * : drmcs_try_delegate(X, funPtr, messageSize, messageAddress), \
+    MRQDLock * : mrqd_try_delegate((MRQDLock *)X, funPtr, messageSize, messageAddress), \
+    AdaptiveLock * : adaptive_try_delegate((AdaptiveLock *)X, funPtr, messageSize, messageAddress), \
+    BiasedLock * : biased_try_delegate((BiasedLock *)X, funPtr, messageSize, messageAddress), \
+    CompactQDLock * : cqd_try_delegate((CompactQDLock *)X, funPtr, messageSize, messageAddress), \
+    PriorityQDLock * : pqd_try_delegate((PriorityQDLock *)X, funPtr, messageSize, messageAddress), \
+    OOLock * : ((OOLock *)X)->m->try_delegate(((OOLock *)X)->lock, funPtr, messageSize, messageAddress) \
+    )
+
+// ## LL_delegate\_timed
+
+// `LL_delegate_timed(X, funPtr, messageSize, messageAddress,
+// timeoutNanos)` works like `LL_try_delegate` but keeps trying for
+// at most `timeoutNanos` nanoseconds. A request thread can use it to
+// shed load instead of blocking when the lock is overloaded.
+
+#define LL_delegate_timed(X, funPtr, messageSize, messageAddress, timeoutNanos) _Generic((X), \
+    TATASLock *: tatas_delegate_timed((TATASLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    QDLock * : qd_delegate_timed((QDLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    CCSynchLock * : ccsynch_delegate_timed(X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    MCSLock * : mcs_delegate_timed(X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    DRMCSLock * : drmcs_delegate_timed(X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    MRQDLock * : mrqd_delegate_timed((MRQDLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    AdaptiveLock * : adaptive_delegate_timed((AdaptiveLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    BiasedLock * : biased_delegate_timed((BiasedLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    CompactQDLock * : cqd_delegate_timed((CompactQDLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    PriorityQDLock * : pqd_delegate_timed((PriorityQDLock *)X, funPtr, messageSize, messageAddress, timeoutNanos), \
+    OOLock * : ((OOLock *)X)->m->delegate_timed(((OOLock *)X)->lock, funPtr, messageSize, messageAddress, timeoutNanos) \
+    )
 
 // ## LL_delegate_or_lock
 
@@ -311,6 +856,10 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : mcs_delegate_or_lock(X, messageSize), \
     DRMCSLock * : drmcs_delegate_or_lock(X, messageSize), \
     MRQDLock * : mrqd_delegate_or_lock((MRQDLock *)X, messageSize), \
+    AdaptiveLock * : adaptive_delegate_or_lock((AdaptiveLock *)X, messageSize), \
+    BiasedLock * : biased_delegate_or_lock((BiasedLock *)X, messageSize), \
+    CompactQDLock * : cqd_delegate_or_lock((CompactQDLock *)X, messageSize), \
+    PriorityQDLock * : pqd_delegate_or_lock((PriorityQDLock *)X, messageSize), \
     OOLock * : ((OOLock *)X)->m->delegate_or_lock(((OOLock *)X)->lock, messageSize) \
     )
 
@@ -321,6 +870,10 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : printf("Can not be called\n"), \
     DRMCSLock * : printf("Can not be called\n"), \
     MRQDLock * : mrqd_close_delegate_buffer(buffer, funPtr), \
+    AdaptiveLock * : adaptive_close_delegate_buffer(buffer, funPtr), \
+    BiasedLock * : printf("Can not be called\n"), \
+    CompactQDLock * : cqd_close_delegate_buffer(buffer, funPtr), \
+    PriorityQDLock * : pqd_close_delegate_buffer(buffer, funPtr), \
     OOLock * : ((OOLock *)X)->m->close_delegate_buffer(buffer, funPtr) \
     )
 
@@ -332,6 +885,10 @@ static inline void * LL_create(LL_lock_type_name llLockType){
     MCSLock * : mcs_unlock(((QDLock *)X)), \
     DRMCSLock * : drmcs_unlock(((QDLock *)X)), \
     MRQDLock * : mrqd_delegate_unlock((MRQDLock *)X),       \
+    AdaptiveLock * : adaptive_delegate_unlock((AdaptiveLock *)X),       \
+    BiasedLock * : biased_unlock((BiasedLock *)X), \
+    CompactQDLock * : cqd_delegate_unlock((CompactQDLock *)X), \
+    PriorityQDLock * : pqd_delegate_unlock((PriorityQDLock *)X), \
     OOLock * : ((OOLock *)X)->m->delegate_unlock(((OOLock *)X)->lock) \
                                 )
 
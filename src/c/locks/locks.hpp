@@ -0,0 +1,303 @@
+#ifndef LOCKS_HPP
+#define LOCKS_HPP
+
+// C++ Lock API
+// ============
+//
+// A header-only C++11 layer over the OO locks. It adds RAII guards
+// and delegation of lambdas, so critical sections can be delegated
+// without writing a `void (*)(unsigned int, void *)` function and
+// packing its arguments into a message by hand. The locks are created
+// and called through locks/oo_lock_api.h, so the program has to be
+// linked with the static or shared library as described in README.md.
+
+// To include this file:
+
+//     #include "locks/locks.hpp"
+
+// *Example:*
+
+//     ll::Lock lock(QD_LOCK);
+//     long counter = 0;
+//     ll::delegate(lock, [&counter]{ counter++; });
+//     long value = ll::delegate_wait(lock, [&counter]{ return counter; });
+//     {
+//         ll::LockGuard guard(lock);
+//         counter = 0;
+//     }
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "locks/oo_lock_api.h"
+
+namespace ll {
+
+// ## ll::Lock
+
+// Owns an `OOLock` of one of the types without the `PLAIN_` prefix in
+// locks/lock_type_name.h. The class has the member functions of the
+// standard Lockable and SharedLockable concepts, so it can also be used
+// with `std::lock_guard` and `std::unique_lock`.
+class Lock {
+public:
+    explicit Lock(LL_lock_type_name lockType = QD_LOCK)
+        : lock_(ll_oo_create(lockType)) {}
+    ~Lock() { ll_oo_free(lock_); }
+    Lock(const Lock &) = delete;
+    Lock & operator=(const Lock &) = delete;
+
+    void lock() { ll_oo_lock(lock_); }
+    void unlock() { ll_oo_unlock(lock_); }
+    bool try_lock() { return ll_oo_try_lock(lock_); }
+    void lock_shared() { ll_oo_rlock(lock_); }
+    void unlock_shared() { ll_oo_runlock(lock_); }
+
+    // See LL_delegate_fence in locks/locks.h
+    void delegate_fence() { ll_oo_delegate_fence(lock_); }
+
+    // The `OOLock *` for calls to the C API
+    void * native_handle() { return lock_; }
+
+private:
+    void * lock_;
+};
+
+// ## ll::LockGuard and ll::ReadGuard
+
+// Take the lock for writing (`LockGuard`) or reading (`ReadGuard`) in
+// the constructor and release it in the destructor.
+class LockGuard {
+public:
+    explicit LockGuard(Lock & lock) : lock_(lock) { lock_.lock(); }
+    ~LockGuard() { lock_.unlock(); }
+    LockGuard(const LockGuard &) = delete;
+    LockGuard & operator=(const LockGuard &) = delete;
+
+private:
+    Lock & lock_;
+};
+
+class ReadGuard {
+public:
+    explicit ReadGuard(Lock & lock) : lock_(lock) { lock_.lock_shared(); }
+    ~ReadGuard() { lock_.unlock_shared(); }
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard & operator=(const ReadGuard &) = delete;
+
+private:
+    Lock & lock_;
+};
+
+// ## ll::Future
+
+// Receives the return value of a delegated function (see
+// `ll::delegate(lock, function, future)` below). The value is written
+// by the thread that executes the function, so the future is neither
+// copyable nor movable and has to outlive the delegation. The
+// destructor waits for a pending delegation.
+template<class R> class Future;
+
+namespace detail {
+
+enum FutureState { FUTURE_EMPTY, FUTURE_PENDING, FUTURE_READY };
+
+class FutureBase {
+public:
+    FutureBase() : state_(FUTURE_EMPTY) {}
+    FutureBase(const FutureBase &) = delete;
+    FutureBase & operator=(const FutureBase &) = delete;
+
+    bool is_ready() const {
+        return state_.load(std::memory_order_acquire) == FUTURE_READY;
+    }
+    void wait() const {
+        while(state_.load(std::memory_order_acquire) == FUTURE_PENDING){
+            std::this_thread::yield();
+        }
+    }
+
+protected:
+    void set_pending() { state_.store(FUTURE_PENDING, std::memory_order_relaxed); }
+    void set_ready() { state_.store(FUTURE_READY, std::memory_order_release); }
+
+    std::atomic<int> state_;
+};
+
+template<class F> using ResultOf = decltype(std::declval<F &>()());
+
+template<class F, class R> struct FutureMessage;
+
+} // namespace detail
+
+template<class R>
+class Future : public detail::FutureBase {
+public:
+    Future() {}
+    ~Future() {
+        wait();
+        if(is_ready()){
+            value()->~R();
+        }
+    }
+
+    // Waits for the value and moves it out of the future
+    R get() {
+        wait();
+        return std::move(*value());
+    }
+
+private:
+    template<class F, class R2> friend struct detail::FutureMessage;
+
+    R * value() { return reinterpret_cast<R *>(&storage_); }
+
+    template<class F> void set_from(F & function) {
+        new (&storage_) R(function());
+        set_ready();
+    }
+
+    typename std::aligned_storage<sizeof(R), alignof(R)>::type storage_;
+};
+
+template<>
+class Future<void> : public detail::FutureBase {
+public:
+    Future() {}
+    ~Future() { wait(); }
+
+    void get() { wait(); }
+
+private:
+    template<class F, class R2> friend struct detail::FutureMessage;
+
+    template<class F> void set_from(F & function) {
+        function();
+        set_ready();
+    }
+};
+
+// ## ll::delegate
+
+// `ll::delegate(lock, function)` delegates the execution of
+// `function()` to the lock in the same way as `LL_delegate`. The
+// function object, including the state captured by a lambda, is
+// constructed directly in the buffer that the lock gives to the
+// delegating thread (see `LL_delegate_or_lock`), and the function that
+// the lock holder calls is generated for the type of the function
+// object, so the call of the lambda can be inlined into it.
+
+// The function may be executed by another thread after `ll::delegate`
+// has returned, so references that a lambda captures have to stay
+// valid until then (see `Lock::delegate_fence`). The function object
+// must fit in the delegation buffer of all lock types
+// (`ll::MAX_MESSAGE_SIZE` bytes) and must not be over-aligned.
+// Exceptions can not be passed on to the delegating thread, so the
+// program terminates if the function throws or if copying it into the
+// buffer throws.
+
+// The delegation buffer of CCSynch (8 cache lines) is the smallest one
+static const std::size_t MAX_MESSAGE_SIZE = 512;
+
+namespace detail {
+
+template<class F>
+void execute(unsigned int messageSize, void * messageAddress) noexcept {
+    (void)messageSize;
+    F * function = static_cast<F *>(messageAddress);
+    (*function)();
+    function->~F();
+}
+
+template<class F, class G>
+void construct(void * buffer, G && function) noexcept {
+    new (buffer) F(std::forward<G>(function));
+}
+
+// Releases the lock when the delegating thread got the lock instead
+// of a buffer
+class DelegateUnlock {
+public:
+    explicit DelegateUnlock(void * lock) : lock_(lock) {}
+    ~DelegateUnlock() { ll_oo_delegate_unlock(lock_); }
+
+private:
+    void * lock_;
+};
+
+template<class F, class R>
+struct FutureMessage {
+    F function;
+    Future<R> * future;
+    static void prepare(Future<R> & future) { future.set_pending(); }
+    void operator()() { future->set_from(function); }
+};
+
+// Returns a buffer for a function object of type F or NULL if the
+// calling thread got the lock instead
+template<class F>
+void * delegate_buffer(Lock & lock) {
+    static_assert(sizeof(F) <= MAX_MESSAGE_SIZE,
+                  "The function object is too big for the delegation buffer");
+    static_assert(alignof(F) <= alignof(void *),
+                  "The function object is over-aligned");
+    return ll_oo_delegate_or_lock(lock.native_handle(), sizeof(F));
+}
+
+// Constructs the function object in a buffer from delegate_buffer and
+// hands it over to the lock holder
+template<class F, class G>
+void close_delegate_buffer(Lock & lock, void * buffer, G && function) {
+    construct<F>(buffer, std::forward<G>(function));
+    ll_oo_close_delegate_buffer(lock.native_handle(), buffer, &execute<F>);
+}
+
+template<class F, class G>
+void delegate_function(Lock & lock, G && function) {
+    void * buffer = delegate_buffer<F>(lock);
+    if(buffer == NULL){
+        DelegateUnlock unlock(lock.native_handle());
+        function();
+        return;
+    }
+    close_delegate_buffer<F>(lock, buffer, std::forward<G>(function));
+}
+
+} // namespace detail
+
+template<class F>
+void delegate(Lock & lock, F && function) {
+    typedef typename std::decay<F>::type Function;
+    detail::delegate_function<Function>(lock, std::forward<F>(function));
+}
+
+// `ll::delegate(lock, function, future)` delegates `function()` and
+// writes its return value to `future` when it has been executed
+template<class F>
+void delegate(Lock & lock,
+              F && function,
+              Future<detail::ResultOf<F>> & future) {
+    typedef typename std::decay<F>::type Function;
+    typedef detail::ResultOf<F> R;
+    typedef detail::FutureMessage<Function, R> Message;
+    Message::prepare(future);
+    Message message = {std::forward<F>(function), &future};
+    detail::delegate_function<Message>(lock, std::move(message));
+}
+
+// `ll::delegate_wait(lock, function)` delegates `function()`, waits
+// until it has been executed and returns its return value
+template<class F>
+detail::ResultOf<F> delegate_wait(Lock & lock, F && function) {
+    Future<detail::ResultOf<F>> future;
+    delegate(lock, std::forward<F>(function), future);
+    return future.get();
+}
+
+} // namespace ll
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef LOCKS_COROUTINE_HPP
+#define LOCKS_COROUTINE_HPP
+
+// C++20 Coroutine Lock API
+// ========================
+//
+// Awaitable delegation for C++20 coroutines on top of
+// locks/locks.hpp. A coroutine that awaits a delegated critical
+// section is suspended instead of blocking its thread. The coroutine
+// handle is put in the delegation queue together with the critical
+// section, and the lock holder posts the handle to a scheduler after
+// it has executed the critical section. Many operations can therefore
+// be in flight at the same time on a few threads.
+
+// To include this file (requires `-std=c++20`):
+
+//     #include "locks/locks_coroutine.hpp"
+
+// *Example:*
+
+//     ll::DetachedCoroutine add(ll::Lock & lock, ll::ThreadPool & pool, long & counter){
+//         co_await pool.schedule();
+//         long value = co_await ll::delegate_await(lock, [&counter]{ return ++counter; }, pool);
+//         ...
+//     }
+
+#if !defined(__cpp_impl_coroutine)
+#    error "locks/locks_coroutine.hpp requires C++20 coroutines"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "locks/locks.hpp"
+
+namespace ll {
+
+// ## ll::ThreadPool
+
+// A scheduler that resumes the coroutines posted to it on a fixed
+// number of threads. Any type with a `post(std::coroutine_handle<>)`
+// member function can be used as scheduler for `ll::delegate_await`.
+// `post` is called by the lock holder, so it should be short. The
+// coroutines that use the pool must have completed before the pool is
+// destroyed.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int numberOfThreads) : stopping_(false) {
+        for(unsigned int i = 0; i < numberOfThreads; i++){
+            threads_.emplace_back([this]{ run(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        for(std::thread & thread : threads_){
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            ready_.push_back(handle);
+        }
+        condition_.notify_one();
+    }
+
+    // `co_await pool.schedule()` continues the coroutine in the pool
+    auto schedule() {
+        struct ScheduleAwaitable {
+            ThreadPool & pool;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { pool.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return ScheduleAwaitable{*this};
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> guard(mutex_);
+        while(true){
+            condition_.wait(guard, [this]{ return stopping_ || !ready_.empty(); });
+            if(ready_.empty()){
+                return;
+            }
+            std::coroutine_handle<> handle = ready_.front();
+            ready_.pop_front();
+            guard.unlock();
+            handle.resume();
+            guard.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::coroutine_handle<>> ready_;
+    bool stopping_;
+    std::vector<std::thread> threads_;
+};
+
+// ## ll::DetachedCoroutine
+
+// The return type of a coroutine that runs to completion on its own
+// and is not awaited by anyone. The coroutine starts in the calling
+// thread and its frame is freed when it returns.
+struct DetachedCoroutine {
+    struct promise_type {
+        DetachedCoroutine get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+// ## ll::delegate_await
+
+// `co_await ll::delegate_await(lock, function, scheduler)` delegates
+// `function()` in the same way as `ll::delegate` and suspends the
+// coroutine until the critical section has been executed. The lock
+// holder writes the return value of `function()` to the awaitable in
+// the coroutine frame and then posts the coroutine to `scheduler`,
+// which resumes it on one of its threads. The value of the `co_await`
+// expression is the return value of `function()`.
+
+// If the calling thread gets the lock instead of a delegation buffer,
+// it executes `function()` itself and the coroutine continues without
+// being suspended. This is always the case for the TATAS, MCS,
+// DR-MCS and biased locks. CCSynch waits for the critical section
+// before the coroutine is suspended, so only the QD based locks let
+// the thread continue with other coroutines while the critical
+// section is waiting in the queue.
+
+// The scheduler must not resume the coroutine in `post`, since the
+// lock holder calls `post` inside its critical section.
+template<class F, class Scheduler>
+class DelegateAwaitable {
+public:
+    typedef detail::ResultOf<F> Result;
+
+    template<class G>
+    DelegateAwaitable(Lock & lock, G && function, Scheduler & scheduler)
+        : lock_(lock), function_(std::forward<G>(function)), scheduler_(scheduler) {}
+
+    DelegateAwaitable(const DelegateAwaitable &) = delete;
+    DelegateAwaitable & operator=(const DelegateAwaitable &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        Call::prepare(future_);
+        void * buffer = detail::delegate_buffer<Message>(lock_);
+        if(buffer == nullptr){
+            detail::DelegateUnlock unlock(lock_.native_handle());
+            Call call = {std::move(function_), &future_};
+            call();
+            return false;
+        }
+        // The coroutine may be resumed, and this awaitable destroyed,
+        // as soon as the buffer has been closed
+        detail::close_delegate_buffer<Message>(
+            lock_, buffer, Message{{std::move(function_), &future_}, &scheduler_, handle});
+        return true;
+    }
+
+    Result await_resume() { return future_.get(); }
+
+private:
+    typedef detail::FutureMessage<F, Result> Call;
+
+    struct Message {
+        Call call;
+        Scheduler * scheduler;
+        std::coroutine_handle<> handle;
+        void operator()() {
+            call();
+            scheduler->post(handle);
+        }
+    };
+
+    Lock & lock_;
+    F function_;
+    Scheduler & scheduler_;
+    Future<Result> future_;
+};
+
+template<class F, class Scheduler>
+DelegateAwaitable<std::decay_t<F>, Scheduler> delegate_await(Lock & lock,
+                                                             F && function,
+                                                             Scheduler & scheduler) {
+    return DelegateAwaitable<std::decay_t<F>, Scheduler>(lock, std::forward<F>(function), scheduler);
+}
+
+} // namespace ll
+
+#endif
@@ -1,10 +1,8 @@
 #include "mcs_lock.h"
+#include "misc/error_help.h"
 
-_Alignas(CACHE_LINE_SIZE) 
-__thread MCSNode myMCSNode = {
-    .next.value = ATOMIC_VAR_INIT((intptr_t)NULL),
-    .locked.value = ATOMIC_VAR_INIT(0)
-};
+_Alignas(CACHE_LINE_SIZE)
+__thread MCSNodePool mcsNodePool = {.inUse = 0};
 
 
 _Alignas(CACHE_LINE_SIZE)
@@ -21,66 +19,166 @@ OOLockMethodTable MCS_LOCK_METHOD_TABLE =
      .delegate_wait = &mcs_delegate,
      .delegate_or_lock = &mcs_delegate_or_lock,
      .close_delegate_buffer = NULL, /* Should never be called */
-     .delegate_unlock = &mcs_unlock
+     .delegate_unlock = &mcs_unlock,
+     .lock_timed = &mcs_lock_timed,
+     .try_delegate = &mcs_try_delegate,
+     .delegate_timed = &mcs_delegate_timed
 };
 
 
+static inline
+MCSNode * mcs_acquire_node(){
+    if(mcsNodePool.inUse == (1u << MCS_NODE_POOL_SIZE) - 1){
+        LL_error_and_exit("Too many nested MCS locks, increase MCS_NODE_POOL_SIZE\n");
+    }
+    int index = __builtin_ctz(~mcsNodePool.inUse);
+    MCSNode * node = mcsNodePool.nodes[index];
+    if(node == NULL){
+        node = aligned_alloc(CACHE_LINE_SIZE, sizeof(MCSNode));
+        atomic_store_explicit(&node->next.value, (intptr_t)NULL, memory_order_relaxed);
+        atomic_store_explicit(&node->locked.value, MCS_NODE_GRANTED, memory_order_relaxed);
+        mcsNodePool.nodes[index] = node;
+    }
+    mcsNodePool.inUse = mcsNodePool.inUse | (1u << index);
+    return node;
+}
+
+static inline
+int mcs_node_pool_index(MCSNode * node){
+    int index = 0;
+    while(mcsNodePool.nodes[index] != node){
+        index = index + 1;
+    }
+    return index;
+}
+
+static inline
+void mcs_release_node(MCSNode * node){
+    mcsNodePool.inUse = mcsNodePool.inUse & ~(1u << mcs_node_pool_index(node));
+}
+
+/* Gives the ownership of an abandoned node to the queue */
+static inline
+void mcs_give_away_node(MCSNode * node){
+    int index = mcs_node_pool_index(node);
+    mcsNodePool.nodes[index] = NULL;
+    mcsNodePool.inUse = mcsNodePool.inUse & ~(1u << index);
+}
+
+
 void mcs_initialize(MCSLock * lock){
     volatile atomic_intptr_t tmp = ATOMIC_VAR_INIT((intptr_t)NULL); 
-    lock->endOfQueue.value = tmp;
+    lock->endOfQueue = tmp;
+    lock->holderNode = NULL;
 }
 
 bool mcs_lock_status(void * lock) {
     MCSLock * l = lock;
-    MCSNode * node = &myMCSNode;
+    MCSNode * node = mcs_acquire_node();
     atomic_store_explicit(&node->next.value, (intptr_t)NULL, memory_order_relaxed);
-    MCSNode * predecessor = (MCSNode *)atomic_exchange_explicit( &l->endOfQueue.value, (intptr_t)node, memory_order_release);
+    MCSNode * predecessor = (MCSNode *)atomic_exchange_explicit( &l->endOfQueue, (intptr_t)node, memory_order_release);
     if (predecessor != NULL) {
-        atomic_store_explicit(&node->locked.value, 1, memory_order_relaxed);
+        atomic_store_explicit(&node->locked.value, MCS_NODE_WAITING, memory_order_relaxed);
         atomic_store_explicit(&predecessor->next.value, (intptr_t)node, memory_order_release);
         //Wait
-        while (atomic_load_explicit(&node->locked.value, memory_order_acquire)) {
+        while (atomic_load_explicit(&node->locked.value, memory_order_acquire) == MCS_NODE_WAITING) {
             thread_yield();
         }
+        l->holderNode = node;
         return true;
     }else{
+        l->holderNode = node;
         return false;
     }
 }
 
+MCSAcquireStatus mcs_lock_status_until(void * lock, uint64_t deadline) {
+    MCSLock * l = lock;
+    MCSNode * node = mcs_acquire_node();
+    atomic_store_explicit(&node->next.value, (intptr_t)NULL, memory_order_relaxed);
+    MCSNode * predecessor = (MCSNode *)atomic_exchange_explicit( &l->endOfQueue, (intptr_t)node, memory_order_release);
+    if (predecessor == NULL) {
+        l->holderNode = node;
+        return MCS_ACQUIRED;
+    }
+    atomic_store_explicit(&node->locked.value, MCS_NODE_WAITING, memory_order_relaxed);
+    atomic_store_explicit(&predecessor->next.value, (intptr_t)node, memory_order_release);
+    //Wait
+    while (atomic_load_explicit(&node->locked.value, memory_order_acquire) == MCS_NODE_WAITING) {
+        if(ll_deadline_passed(deadline)){
+            int expected = MCS_NODE_WAITING;
+            if(atomic_compare_exchange_strong(&node->locked.value,
+                                              &expected,
+                                              MCS_NODE_ABANDONED)){
+                //The node is now owned by the queue
+                mcs_give_away_node(node);
+                return MCS_TIMED_OUT;
+            }
+            break;
+        }
+        thread_yield();
+    }
+    l->holderNode = node;
+    return MCS_ACQUIRED_FROM_PREDECESSOR;
+}
+
 void mcs_lock(void * lock) {
     mcs_lock_status(lock);
 }
 
 void mcs_unlock(void * lock) {
     MCSLock * l = lock;
-    MCSNode * node = &myMCSNode;
-    MCSNode * nodeConst = &myMCSNode;
-    if (NULL == (MCSNode *)atomic_load_explicit(&node->next.value, memory_order_acquire)) {
-        if (atomic_compare_exchange_strong(&l->endOfQueue.value,
-                                           (intptr_t*)&node,
-                                           (intptr_t)NULL)){
-            return;
+    MCSNode * node = l->holderNode;
+    bool nodeAbandoned = false;
+    mcs_release_node(node);
+    while(true){
+        MCSNode * nextNode = (MCSNode*)atomic_load_explicit(&node->next.value, memory_order_acquire);
+        if (NULL == nextNode) {
+            intptr_t expected = (intptr_t)node;
+            if (atomic_compare_exchange_strong(&l->endOfQueue,
+                                               &expected,
+                                               (intptr_t)NULL)){
+                if(nodeAbandoned){
+                    free(node);
+                }
+                return;
+            }
+            //wait
+            while (NULL == (nextNode = (MCSNode*)atomic_load_explicit(&node->next.value, memory_order_acquire))) {
+                thread_yield();
+            }
         }
-        //wait
-        while ((intptr_t)NULL == atomic_load_explicit(&nodeConst->next.value, memory_order_acquire)) {
-            thread_yield();
+        if(nodeAbandoned){
+            free(node);
+        }
+        int expected = MCS_NODE_WAITING;
+        if(atomic_compare_exchange_strong(&nextNode->locked.value,
+                                          &expected,
+                                          MCS_NODE_GRANTED)){
+            return;
         }
+        //The next node has been abandoned so we pass the lock on to its successor
+        node = nextNode;
+        nodeAbandoned = true;
     }
-    MCSNode * nextNode = (MCSNode*)atomic_load_explicit(&nodeConst->next.value, memory_order_relaxed);
-    atomic_store_explicit(&nextNode->locked.value, 0, memory_order_release);
 }
 
 bool mcs_try_lock(void * lock) {
     MCSLock * l = lock;
-    MCSNode * node = &myMCSNode;
-    if(atomic_load_explicit(&l->endOfQueue.value, memory_order_acquire) != (intptr_t)NULL){
+    if(atomic_load_explicit(&l->endOfQueue, memory_order_acquire) != (intptr_t)NULL){
         return false;
     }else{
+        MCSNode * node = mcs_acquire_node();
+        intptr_t expected = (intptr_t)NULL;
         atomic_store_explicit(&node->next.value, (intptr_t) NULL, memory_order_relaxed);
-        return atomic_compare_exchange_strong(&l->endOfQueue.value,
-                                              (intptr_t *)node,
-                                              (intptr_t)NULL);
+        if(atomic_compare_exchange_strong(&l->endOfQueue,
+                                          &expected,
+                                          (intptr_t)node)){
+            l->holderNode = node;
+            return true;
+        }
+        mcs_release_node(node);
+        return false;
     }
 }
 
@@ -101,6 +199,38 @@ void * mcs_delegate_or_lock(void * lock, unsigned int messageSize){
     return NULL;
 }
 
+bool mcs_lock_timed(void * lock, uint64_t timeoutNanos){
+    return MCS_TIMED_OUT !=
+        mcs_lock_status_until(lock, ll_deadline_from_timeout(timeoutNanos));
+}
+
+bool mcs_try_delegate(void * lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress){
+    MCSLock *l = (MCSLock*)lock;
+    if(!mcs_try_lock(l)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    mcs_unlock(l);
+    return true;
+}
+
+bool mcs_delegate_timed(void * lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos){
+    MCSLock *l = (MCSLock*)lock;
+    if(!mcs_lock_timed(l, timeoutNanos)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    mcs_unlock(l);
+    return true;
+}
+
 MCSLock * plain_mcs_create(){
     MCSLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(MCSLock));
     mcs_initialize(l);
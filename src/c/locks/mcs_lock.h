@@ -6,9 +6,25 @@
 
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
 #include "misc/thread_includes.h"//Until c11 thread.h is available
+#include "misc/timing.h"
 #include <stdbool.h>
 
-// WARNING: DOES NOT WORK FOR NESTED LOCKS
+// Each thread takes its queue nodes from a small thread local pool so
+// a thread can hold up to MCS_NODE_POOL_SIZE MCS (or DR-MCS) locks at
+// the same time. The locks can be released in any order. Nodes are
+// only allocated the first time a pool slot is used.
+
+#ifndef MCS_NODE_POOL_SIZE
+#    define MCS_NODE_POOL_SIZE 8
+#endif
+
+// The locked field of a node is in one of the following states. A
+// waiting thread that times out moves its node from waiting to
+// abandoned. The node then belongs to the queue and is skipped (and
+// freed) by the thread that releases the lock to it.
+#define MCS_NODE_GRANTED 0
+#define MCS_NODE_WAITING 1
+#define MCS_NODE_ABANDONED 2
 
 typedef struct {
     LLPaddedPointer next;
@@ -16,18 +32,40 @@ typedef struct {
 } MCSNode;
 
 typedef struct {
-    LLPaddedPointer endOfQueue;
+    volatile atomic_intptr_t endOfQueue;
+    char pad1[CACHE_LINE_SIZE_PAD(sizeof(atomic_intptr_t))];
+    // Only accessed by the lock holder. It has its own cache line so
+    // that a handoff does not write to the line of endOfQueue that all
+    // enqueuing threads exchange on.
+    MCSNode * holderNode;
+    char pad2[CACHE_LINE_SIZE_PAD(sizeof(MCSNode *))];
 } MCSLock;
 
+typedef struct {
+    MCSNode * nodes[MCS_NODE_POOL_SIZE];
+    unsigned int inUse;
+} MCSNodePool;
+
+typedef enum {
+    MCS_ACQUIRED,
+    MCS_ACQUIRED_FROM_PREDECESSOR,
+    MCS_TIMED_OUT
+} MCSAcquireStatus;
+
+
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable MCS_LOCK_METHOD_TABLE;
 
 void mcs_initialize(MCSLock * lock);
 bool mcs_lock_status(void * lock); //Not part of public API but is used by DRMCS
+MCSAcquireStatus mcs_lock_status_until(void * lock, uint64_t deadline); //Not part of public API but is used by DRMCS
 void mcs_lock(void * lock);
 void mcs_unlock(void * lock);
 static inline
 bool mcs_is_locked(void * lock){
     MCSLock * l = lock;
-    return atomic_load(&l->endOfQueue.value) != (intptr_t)NULL;
+    return atomic_load(&l->endOfQueue) != (intptr_t)NULL;
 }
 bool mcs_try_lock(void * lock);
 void mcs_delegate(void * lock,
@@ -35,6 +73,16 @@ void mcs_delegate(void * lock,
                   unsigned int messageSize,
                   void * messageAddress);
 void * mcs_delegate_or_lock(void * lock, unsigned int messageSize);
+bool mcs_lock_timed(void * lock, uint64_t timeoutNanos);
+bool mcs_try_delegate(void * lock,
+                      void (*funPtr)(unsigned int, void *), 
+                      unsigned int messageSize,
+                      void * messageAddress);
+bool mcs_delegate_timed(void * lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos);
 MCSLock * plain_mcs_create();
 OOLock * oo_mcs_create();
 
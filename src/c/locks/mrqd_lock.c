@@ -3,7 +3,7 @@
 _Alignas(CACHE_LINE_SIZE)
 OOLockMethodTable MRQD_LOCK_METHOD_TABLE = 
 {
-    .free = &free,
+    .free = &mrqd_free,
     .lock = &mrqd_lock,
     .unlock = &mrqd_unlock,
     .is_locked = &mrqd_is_locked,
@@ -14,28 +14,141 @@ OOLockMethodTable MRQD_LOCK_METHOD_TABLE =
     .delegate_wait = &mrqd_delegate_wait,
     .delegate_or_lock = &mrqd_delegate_or_lock,
     .close_delegate_buffer = &mrqd_close_delegate_buffer,
-    .delegate_unlock = &mrqd_delegate_unlock
+    .delegate_unlock = &mrqd_delegate_unlock,
+    .lock_timed = &mrqd_lock_timed,
+    .try_delegate = &mrqd_try_delegate,
+    .delegate_timed = &mrqd_delegate_timed,
+    .oread_begin = &mrqd_oread_begin,
+    .oread_validate = &mrqd_oread_validate,
+    .upgrade = &mrqd_upgrade,
+    .downgrade = &mrqd_downgrade,
+    .delegate_read = &mrqd_delegate_read,
+    .delegate_fence = &mrqd_delegate_fence,
+    .try_enqueue = &mrqd_try_enqueue,
+    .wait_until = &mrqd_wait_until
 };
 
+// Called by the lock holder before it writes or opens the queue
+static inline void mrqd_begin_write(MRQDLock * l){
+    ll_forward_count_begin_write(&l->forwards);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Adjusts the read patience from the waits that have been registered
+// since the last release, see mrqd_lock.h
+static inline void mrqd_adjust_read_patience(MRQDLock * l, unsigned long batchSize){
+    MRQDHolderData * h = &l->holderData;
+    h->value.writeHolds++;
+    h->value.delegatedOperations = h->value.delegatedOperations + batchSize;
+    unsigned long blockedReads =
+        atomic_load_explicit(&l->waitCounters.value.blockedReads, memory_order_relaxed);
+    unsigned long blockedWrites =
+        atomic_load_explicit(&l->waitCounters.value.blockedWrites, memory_order_relaxed);
+    bool readersBlocked = blockedReads != h->value.seenBlockedReads;
+    bool writersBlocked = blockedWrites != h->value.seenBlockedWrites;
+    h->value.seenBlockedReads = blockedReads;
+    h->value.seenBlockedWrites = blockedWrites;
+    unsigned int patience =
+        atomic_load_explicit(&h->value.readPatience, memory_order_relaxed);
+    unsigned int newPatience = patience;
+    if(readersBlocked && (!writersBlocked || batchSize >= MRQD_LARGE_WRITE_BATCH)){
+        newPatience = patience / 2;
+        if(newPatience < MRQD_MIN_READ_PATIENCE){
+            newPatience = MRQD_MIN_READ_PATIENCE;
+        }
+    }else if(writersBlocked && !readersBlocked){
+        newPatience = patience * 2;
+        if(newPatience > MRQD_MAX_READ_PATIENCE){
+            newPatience = MRQD_MAX_READ_PATIENCE;
+        }
+    }
+    if(newPatience != patience){
+        atomic_store_explicit(&h->value.readPatience, newPatience, memory_order_relaxed);
+        h->value.patienceAdjustments++;
+    }
+}
+
+// Called by the lock holder before the lock is released. batchSize is
+// the number of delegated critical sections executed during the hold.
+static inline void mrqd_end_write(MRQDLock * l, unsigned long batchSize){
+    ll_wake_waiters(&l->waiters);
+    mrqd_adjust_read_patience(l, batchSize);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_release);
+}
+
+static inline void mrqd_register_blocked_write(MRQDLock * l){
+    atomic_fetch_add_explicit(&l->waitCounters.value.blockedWrites, 1, memory_order_relaxed);
+}
+
+static inline void mrqd_wait_for_write_barrier(MRQDLock * l){
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+        mrqd_register_blocked_write(l);
+        while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+            thread_yield();
+        }
+    }
+}
+
 void mrqd_initialize(MRQDLock * lock){
+    mrqd_initialize_with_read_indicator(lock, MRQD_LOCK_READ_INDICATOR_TYPE);
+}
+
+static void mrqd_initialize_except_read_indicator(MRQDLock * lock){
     tatas_initialize(&lock->mutexLock);
+    atomic_store(&lock->version.value, 0);
+    ll_forward_count_initialize(&lock->forwards);
+    ll_waiters_initialize(&lock->waiters);
     qdq_initialize(&lock->queue);
     atomic_store(&lock->writeBarrier.value, 0);
-    reader_groups_initialize(&lock->readIndicator);
+    atomic_store(&lock->holderData.value.readPatience, MRQD_READ_PATIENCE_LIMIT);
+    lock->holderData.value.patienceAdjustments = 0;
+    lock->holderData.value.writeHolds = 0;
+    lock->holderData.value.delegatedOperations = 0;
+    lock->holderData.value.seenBlockedReads = 0;
+    lock->holderData.value.seenBlockedWrites = 0;
+    atomic_store(&lock->waitCounters.value.blockedReads, 0);
+    atomic_store(&lock->waitCounters.value.blockedReadYields, 0);
+    atomic_store(&lock->waitCounters.value.barrierRaises, 0);
+    atomic_store(&lock->waitCounters.value.blockedWrites, 0);
+}
+
+void mrqd_initialize_with_read_indicator(MRQDLock * lock,
+                                         LL_read_indicator_type readIndicatorType){
+    mrqd_initialize_except_read_indicator(lock);
+    ri_initialize(&lock->readIndicator, readIndicatorType);
+}
+
+void mrqd_initialize_with_read_indicator_width(MRQDLock * lock,
+                                               LL_read_indicator_type readIndicatorType,
+                                               int width){
+    mrqd_initialize_except_read_indicator(lock);
+    ri_initialize_with_width(&lock->readIndicator, readIndicatorType, width);
+}
+
+void mrqd_initialize_with_shared_read_indicator(MRQDLock * lock,
+                                                ReadIndicator * sharedReadIndicator){
+    mrqd_initialize_except_read_indicator(lock);
+    ri_initialize_shared(&lock->readIndicator, sharedReadIndicator);
 }
 
 void mrqd_lock(void * lock) {
     MRQDLock *l = (MRQDLock*)lock;
-    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
-        thread_yield();
-    }
+    mrqd_wait_for_write_barrier(l);
     tatas_lock(&l->mutexLock);
-    rgri_wait_all_readers_gone(&l->readIndicator);
+    ri_wait_all_readers_gone(&l->readIndicator);
+    mrqd_begin_write(l);
 }
 
 void mrqd_unlock(void * lock) {
     MRQDLock *l = (MRQDLock*)lock;
+    mrqd_end_write(l, 0);
     tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
 }
 
 bool mrqd_is_locked(void * lock){
@@ -45,11 +158,10 @@ bool mrqd_is_locked(void * lock){
 
 bool mrqd_try_lock(void * lock) {
     MRQDLock *l = (MRQDLock*)lock;
-    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
-        thread_yield();
-    }
+    mrqd_wait_for_write_barrier(l);
     if(tatas_try_lock(&l->mutexLock)){
-        rgri_wait_all_readers_gone(&l->readIndicator);
+        ri_wait_all_readers_gone(&l->readIndicator);
+        mrqd_begin_write(l);
         return true;
     }else{
         return false;
@@ -59,14 +171,19 @@ bool mrqd_try_lock(void * lock) {
 void mrqd_rlock(void * lock) {
     MRQDLock *l = (MRQDLock*)lock;
     bool bRaised = false;
-    int readPatience = 0;
+    unsigned int readPatience = 0;
+    unsigned int readPatienceLimit = 0;
  start:
-    rgri_arrive(&l->readIndicator);
+    ri_arrive(&l->readIndicator);
     if(tatas_is_locked(&l->mutexLock)) {
-        rgri_depart(&l->readIndicator);
+        ri_depart(&l->readIndicator);
+        if(readPatience == 0) {
+            readPatienceLimit =
+                atomic_load_explicit(&l->holderData.value.readPatience, memory_order_relaxed);
+        }
         while(tatas_is_locked(&l->mutexLock)) {
             thread_yield();
-            if((readPatience == MRQD_READ_PATIENCE_LIMIT) && !bRaised) {
+            if((readPatience == readPatienceLimit) && !bRaised) {
                 atomic_fetch_add_explicit(&l->writeBarrier.value, 1, memory_order_seq_cst);
                 bRaised = true;
             }
@@ -74,6 +191,14 @@ void mrqd_rlock(void * lock) {
         }
         goto start;
     }
+    if(readPatience > 0) {
+        MRQDWaitCounters * c = &l->waitCounters;
+        atomic_fetch_add_explicit(&c->value.blockedReads, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&c->value.blockedReadYields, readPatience, memory_order_relaxed);
+        if(bRaised) {
+            atomic_fetch_add_explicit(&c->value.barrierRaises, 1, memory_order_relaxed);
+        }
+    }
     if(bRaised) {
         atomic_fetch_sub_explicit(&l->writeBarrier.value, 1, memory_order_seq_cst);
     }
@@ -81,7 +206,39 @@ void mrqd_rlock(void * lock) {
 
 void mrqd_runlock(void * lock) {
     MRQDLock *l = (MRQDLock*)lock;
-    rgri_depart(&l->readIndicator);
+    ri_depart(&l->readIndicator);
+}
+
+bool mrqd_upgrade(void * lock) {
+    MRQDLock *l = (MRQDLock*)lock;
+    // A writer that holds the mutex lock waits for this reader, so the
+    // read lock has to be released if the mutex lock is taken
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0 ||
+       !tatas_try_lock(&l->mutexLock)){
+        ri_depart(&l->readIndicator);
+        return false;
+    }
+    ri_depart(&l->readIndicator);
+    ri_wait_all_readers_gone(&l->readIndicator);
+    mrqd_begin_write(l);
+    return true;
+}
+
+bool mrqd_upgrade_or_delegate(void * lock,
+                              void (*funPtr)(unsigned int, void *),
+                              unsigned int messageSize,
+                              void * messageAddress) {
+    if(mrqd_upgrade(lock)){
+        return true;
+    }
+    mrqd_delegate(lock, funPtr, messageSize, messageAddress);
+    return false;
+}
+
+void mrqd_downgrade(void * lock) {
+    MRQDLock *l = (MRQDLock*)lock;
+    ri_arrive(&l->readIndicator);
+    mrqd_unlock(l);
 }
 
 void mrqd_delegate(void* lock,
@@ -89,21 +246,24 @@ void mrqd_delegate(void* lock,
                    unsigned int messageSize,
                    void * messageAddress) {
     MRQDLock *l = (MRQDLock*)lock;
-    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
-        thread_yield();
-    }
+    mrqd_wait_for_write_barrier(l);
     while(true) {
         if(tatas_try_lock(&l->mutexLock)) {
+            mrqd_begin_write(l);
             qdq_open(&l->queue);
-            rgri_wait_all_readers_gone(&l->readIndicator);
+            ri_wait_all_readers_gone(&l->readIndicator);
             funPtr(messageSize, messageAddress);
-            qdq_flush(&l->queue);
+            mrqd_end_write(l, ll_forwarding_flush(&l->queue, &l->forwards));
             tatas_unlock(&l->mutexLock);
+            ll_send_deferred_forwards();
             return;
-        } else if(qdq_enqueue(&l->queue,
-                              funPtr,
-                              messageSize,
-                              messageAddress)){
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(qdq_enqueue(&l->queue,
+                       funPtr,
+                       messageSize,
+                       messageAddress)){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
             return;
         }
         thread_yield();
@@ -114,16 +274,17 @@ void * mrqd_delegate_or_lock(void* lock,
                              unsigned int messageSize) {
     MRQDLock *l = (MRQDLock*)lock;
     void * buffer;
-    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
-        thread_yield();
-    }
+    mrqd_wait_for_write_barrier(l);
     while(true) {
         if(tatas_try_lock(&l->mutexLock)) {
+            mrqd_begin_write(l);
             qdq_open(&l->queue);
-            rgri_wait_all_readers_gone(&l->readIndicator);
+            ri_wait_all_readers_gone(&l->readIndicator);
             return NULL;
-        } else if(NULL != (buffer = qdq_enqueue_get_buffer(&l->queue,
-                                                           messageSize))){
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(NULL != (buffer = qdq_enqueue_get_buffer(&l->queue, messageSize))){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
             return buffer;
         }
         thread_yield();
@@ -137,8 +298,9 @@ void mrqd_close_delegate_buffer(void * buffer,
 
 void mrqd_delegate_unlock(void* lock) {
     MRQDLock *l = (MRQDLock*)lock;
-    qdq_flush(&l->queue);
+    mrqd_end_write(l, ll_forwarding_flush(&l->queue, &l->forwards));
     tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
 }
 
 void mrqd_executeAndWaitCS(unsigned int size, void * data){
@@ -153,6 +315,30 @@ void mrqd_executeAndWaitCS(unsigned int size, void * data){
     atomic_store_explicit(writeBackAddress, 0, memory_order_release);
 }
 
+// Fills in a buffer from the delegation queue so the critical section
+// is executed with mrqd_executeAndWaitCS and waits until it has been
+// executed
+static void mrqd_close_and_wait(char * buff,
+                                volatile atomic_int * waitVar,
+                                void (*funPtr)(unsigned int, void *),
+                                unsigned int messageSize,
+                                void * messageAddress){
+    volatile atomic_int ** waitVarPtrAddress = (volatile atomic_int **)buff;
+    *waitVarPtrAddress = waitVar;
+    void (**funPtrAdress)(unsigned int, void *) = (void (**)(unsigned int, void *))&buff[sizeof(volatile atomic_int *)];
+    *funPtrAdress = funPtr;
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) + 
+        sizeof(void (*)(unsigned int, void *));
+    char * msgBuffer = (char *)messageAddress;
+    for(unsigned int i = metaDataSize; i < (messageSize + metaDataSize); i++){
+        buff[i] = msgBuffer[i - metaDataSize];
+    }
+    mrqd_close_delegate_buffer((void *)buff, mrqd_executeAndWaitCS);
+    while(atomic_load_explicit(waitVar, memory_order_acquire)){
+        thread_yield();
+    }
+}
+
 void mrqd_delegate_wait(void* lock,
                       void (*funPtr)(unsigned int, void *), 
                       unsigned int messageSize,
@@ -166,33 +352,189 @@ void mrqd_delegate_wait(void* lock,
         funPtr(messageSize, messageAddress);
         mrqd_delegate_unlock(lock);
     }else{
-        volatile atomic_int ** waitVarPtrAddress = (volatile atomic_int **)buff;
-        *waitVarPtrAddress = &waitVar;
-        void (**funPtrAdress)(unsigned int, void *) = (void (**)(unsigned int, void *))&buff[sizeof(volatile atomic_int *)];
-        *funPtrAdress = funPtr;
-        unsigned int metaDataSize = sizeof(volatile atomic_int *) + 
-            sizeof(void (*)(unsigned int, void *));
-        char * msgBuffer = (char *)messageAddress;
-        for(unsigned int i = metaDataSize; i < (messageSize + metaDataSize); i++){
-            buff[i] = msgBuffer[i - metaDataSize];
+        mrqd_close_and_wait(buff, &waitVar, funPtr, messageSize, messageAddress);
+    }
+}
+
+void mrqd_delegate_read(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress) {
+    MRQDLock *l = (MRQDLock*)lock;
+    volatile atomic_int waitVar = ATOMIC_VAR_INIT(1);
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) + 
+        sizeof(void (*)(unsigned int, void *));
+    ri_arrive(&l->readIndicator);
+    if(!tatas_is_locked(&l->mutexLock)) {
+        funPtr(messageSize, messageAddress);
+        ri_depart(&l->readIndicator);
+        return;
+    }
+    ri_depart(&l->readIndicator);
+    // The queue is only open when the writer holds the lock in a
+    // delegate operation. Otherwise the read waits as in mrqd_rlock.
+    char * buff = qdq_enqueue_get_buffer(&l->queue, metaDataSize + messageSize);
+    if(buff != NULL){
+        mrqd_close_and_wait(buff, &waitVar, funPtr, messageSize, messageAddress);
+    }else{
+        mrqd_rlock(l);
+        funPtr(messageSize, messageAddress);
+        mrqd_runlock(l);
+    }
+}
+
+bool mrqd_lock_timed(void * lock, uint64_t timeoutNanos) {
+    MRQDLock *l = (MRQDLock*)lock;
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+        mrqd_register_blocked_write(l);
+    }
+    while(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+        if(ll_deadline_passed(deadline)){
+            return false;
         }
-        mrqd_close_delegate_buffer((void *)buff, mrqd_executeAndWaitCS);
-        while(atomic_load_explicit(&waitVar, memory_order_acquire)){
-            thread_yield();
+        thread_yield();
+    }
+    if(!tatas_lock_until(&l->mutexLock, deadline)){
+        return false;
+    }
+    if(!ri_wait_all_readers_gone_until(&l->readIndicator, deadline)){
+        tatas_unlock(&l->mutexLock);
+        return false;
+    }
+    mrqd_begin_write(l);
+    return true;
+}
+
+bool mrqd_try_delegate(void* lock,
+                       void (*funPtr)(unsigned int, void *), 
+                       unsigned int messageSize,
+                       void * messageAddress) {
+    MRQDLock *l = (MRQDLock*)lock;
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+        mrqd_register_blocked_write(l);
+        return false;
+    }
+    if(tatas_try_lock(&l->mutexLock)) {
+        mrqd_begin_write(l);
+        qdq_open(&l->queue);
+        ri_wait_all_readers_gone(&l->readIndicator);
+        funPtr(messageSize, messageAddress);
+        mrqd_end_write(l, ll_forwarding_flush(&l->queue, &l->forwards));
+        tatas_unlock(&l->mutexLock);
+        ll_send_deferred_forwards();
+        return true;
+    }
+    unsigned long version = ll_delegate_fence_observe(&l->version.value);
+    if(qdq_enqueue(&l->queue,
+                   funPtr,
+                   messageSize,
+                   messageAddress)){
+        ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+        return true;
+    }
+    return false;
+}
+
+bool mrqd_try_enqueue(void* lock,
+                      void (*funPtr)(unsigned int, void *), 
+                      unsigned int messageSize,
+                      void * messageAddress) {
+    MRQDLock *l = (MRQDLock*)lock;
+    if(atomic_load_explicit(&l->writeBarrier.value, memory_order_seq_cst) > 0){
+        mrqd_register_blocked_write(l);
+        return false;
+    }
+    unsigned long version = ll_delegate_fence_observe(&l->version.value);
+    if(qdq_enqueue(&l->queue,
+                   funPtr,
+                   messageSize,
+                   messageAddress)){
+        ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+        return true;
+    }
+    return false;
+}
+
+bool mrqd_delegate_timed(void* lock,
+                         void (*funPtr)(unsigned int, void *), 
+                         unsigned int messageSize,
+                         void * messageAddress,
+                         uint64_t timeoutNanos) {
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(true) {
+        if(mrqd_try_delegate(lock, funPtr, messageSize, messageAddress)) {
+            return true;
+        } else if(ll_deadline_passed(deadline)) {
+            return false;
         }
+        thread_yield();
     }
 }
 
-MRQDLock * plain_mrqd_create(){
-    MRQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(MRQDLock));
-    mrqd_initialize(l);
-    return l;
+MRQDFairnessStats mrqd_fairness_stats(MRQDLock * lock){
+    MRQDHolderData * h = &lock->holderData;
+    MRQDWaitCounters * c = &lock->waitCounters;
+    MRQDFairnessStats stats = {
+        .readPatience = atomic_load(&h->value.readPatience),
+        .patienceAdjustments = h->value.patienceAdjustments,
+        .writeHolds = h->value.writeHolds,
+        .delegatedOperations = h->value.delegatedOperations,
+        .blockedReads = atomic_load(&c->value.blockedReads),
+        .blockedReadYields = atomic_load(&c->value.blockedReadYields),
+        .barrierRaises = atomic_load(&c->value.barrierRaises),
+        .blockedWrites = atomic_load(&c->value.blockedWrites)
+    };
+    return stats;
 }
 
-OOLock * oo_mrqd_create(){
-    MRQDLock * l = plain_mrqd_create();
+void mrqd_wait_until(void * lock, bool (*predicate)(void *), void * arg){
+    MRQDLock *l = (MRQDLock*)lock;
+    ll_wait_until(l, &l->waiters, mrqd_delegate, predicate, arg);
+}
+
+void mrqd_destroy(MRQDLock * lock){
+    ri_destroy(&lock->readIndicator);
+}
+void mrqd_free(void * lock){
+    mrqd_destroy((MRQDLock *)lock);
+    free(lock);
+}
+static OOLock * oo_mrqd_wrap(MRQDLock * l){
     OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
     ool->lock = l;
     ool->m = &MRQD_LOCK_METHOD_TABLE;
     return ool;
 }
+MRQDLock * plain_mrqd_create_with_read_indicator(LL_read_indicator_type readIndicatorType){
+    MRQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(MRQDLock));
+    mrqd_initialize_with_read_indicator(l, readIndicatorType);
+    return l;
+}
+OOLock * oo_mrqd_create_with_read_indicator(LL_read_indicator_type readIndicatorType){
+    return oo_mrqd_wrap(plain_mrqd_create_with_read_indicator(readIndicatorType));
+}
+MRQDLock * plain_mrqd_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                       int width){
+    MRQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(MRQDLock));
+    mrqd_initialize_with_read_indicator_width(l, readIndicatorType, width);
+    return l;
+}
+OOLock * oo_mrqd_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                  int width){
+    return oo_mrqd_wrap(plain_mrqd_create_with_read_indicator_width(readIndicatorType, width));
+}
+MRQDLock * plain_mrqd_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator){
+    MRQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(MRQDLock));
+    mrqd_initialize_with_shared_read_indicator(l, sharedReadIndicator);
+    return l;
+}
+OOLock * oo_mrqd_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator){
+    return oo_mrqd_wrap(plain_mrqd_create_with_shared_read_indicator(sharedReadIndicator));
+}
+MRQDLock * plain_mrqd_create(){
+    return plain_mrqd_create_with_read_indicator(MRQD_LOCK_READ_INDICATOR_TYPE);
+}
+OOLock * oo_mrqd_create(){
+    return oo_mrqd_create_with_read_indicator(MRQD_LOCK_READ_INDICATOR_TYPE);
+}
@@ -7,30 +7,140 @@
 
 #include "misc/padded_types.h"
 #include "locks/tatas_lock.h"
+#include "locks/delegate_fence.h"
+#include "locks/wait_until.h"
 #include "qd_queues/qd_queue.h"
-#include "read_indicators/reader_groups_read_indicator.h"
+#include "read_indicators/read_indicator.h"
 #include "locks/oo_lock_interface.h"
 
 /* Multiple Reader Queue Delegation Lock */
 
+#ifndef MRQD_LOCK_READ_INDICATOR_TYPE
+#    define MRQD_LOCK_READ_INDICATOR_TYPE READER_GROUPS_READ_INDICATOR
+#endif
+
+// A reader that has waited for the write lock for the read patience
+// (a number of yields) raises the write barrier, which stops new
+// writers until the reader has entered. The patience of each lock is
+// adjusted by the write lock holder when it releases the lock:
+//
+// * If readers were blocked since the last release and no writer was
+//   stopped by the barrier, or the holder executed a large batch of
+//   delegated critical sections, the patience is halved.
+// * If writers were stopped by the barrier and no readers were
+//   blocked, the patience is doubled.
+//
+// The patience starts at MRQD_READ_PATIENCE_LIMIT and stays between
+// MRQD_MIN_READ_PATIENCE and MRQD_MAX_READ_PATIENCE. Setting both to
+// the same value gives a fixed patience.
+
 #ifndef MRQD_READ_PATIENCE_LIMIT
 #    define MRQD_READ_PATIENCE_LIMIT 1000
 #endif
+#ifndef MRQD_MIN_READ_PATIENCE
+#    define MRQD_MIN_READ_PATIENCE 16
+#endif
+#ifndef MRQD_MAX_READ_PATIENCE
+#    define MRQD_MAX_READ_PATIENCE 65536
+#endif
+#ifndef MRQD_LARGE_WRITE_BATCH
+#    define MRQD_LARGE_WRITE_BATCH 64
+#endif
+
+typedef struct {
+    unsigned int readPatience;
+    unsigned long patienceAdjustments;
+    unsigned long writeHolds;
+    unsigned long delegatedOperations;
+    // Readers that had to wait for a writer and their total yields
+    unsigned long blockedReads;
+    unsigned long blockedReadYields;
+    unsigned long barrierRaises;
+    // Writers that had to wait for the write barrier
+    unsigned long blockedWrites;
+} MRQDFairnessStats;
+
+typedef union {
+    struct {
+        volatile atomic_uint readPatience;
+        unsigned long patienceAdjustments;
+        unsigned long writeHolds;
+        unsigned long delegatedOperations;
+        unsigned long seenBlockedReads;
+        unsigned long seenBlockedWrites;
+    } value;
+    char pad[CACHE_LINE_SIZE];
+} MRQDHolderData;
 
+// Only written by threads that had to wait
+typedef union {
+    struct {
+        volatile atomic_ulong blockedReads;
+        volatile atomic_ulong blockedReadYields;
+        volatile atomic_ulong barrierRaises;
+        volatile atomic_ulong blockedWrites;
+    } value;
+    char pad[CACHE_LINE_SIZE];
+} MRQDWaitCounters;
+
+// The version and the forward count work as in the QD lock (see
+// locks/qd_lock.h).
 typedef struct {
     TATASLock mutexLock;
+    LLPaddedULong version;
+    LLForwardCount forwards;
+    LLPaddedPointer waiters; //See locks/wait_until.h
     QDQueue queue;
-    ReaderGroupsReadIndicator readIndicator;
+    ReadIndicator readIndicator;
     LLPaddedUInt writeBarrier;
+    MRQDHolderData holderData; //Only written by the lock holder
+    MRQDWaitCounters waitCounters;
 } MRQDLock;
 
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable MRQD_LOCK_METHOD_TABLE;
+
 void mrqd_initialize(MRQDLock * lock);
+void mrqd_initialize_with_read_indicator(MRQDLock * lock,
+                                         LL_read_indicator_type readIndicatorType);
+// width is the number of reader groups, see ri_initialize_with_width
+void mrqd_initialize_with_read_indicator_width(MRQDLock * lock,
+                                               LL_read_indicator_type readIndicatorType,
+                                               int width);
+// The lock uses sharedReadIndicator, which has to be destroyed after
+// the lock. See read_indicators/read_indicator.h for the restrictions.
+void mrqd_initialize_with_shared_read_indicator(MRQDLock * lock,
+                                                ReadIndicator * sharedReadIndicator);
+// Frees the read indicator allocated by mrqd_initialize
+void mrqd_destroy(MRQDLock * lock);
+// Destroys and frees a lock created with plain_mrqd_create
+void mrqd_free(void * lock);
 void mrqd_lock(void * lock);
 void mrqd_unlock(void * lock);
 bool mrqd_is_locked(void * lock);
 bool mrqd_try_lock(void * lock);
 void mrqd_rlock(void * lock);
 void mrqd_runlock(void * lock);
+// Upgrades and downgrades, see LL_upgrade in locks/locks.h
+bool mrqd_upgrade(void * lock);
+bool mrqd_upgrade_or_delegate(void * lock,
+                              void (*funPtr)(unsigned int, void *),
+                              unsigned int messageSize,
+                              void * messageAddress);
+void mrqd_downgrade(void * lock);
+static inline
+unsigned long mrqd_oread_begin(void * lock){
+    MRQDLock *l = (MRQDLock*)lock;
+    return atomic_load_explicit(&l->version.value, memory_order_acquire);
+}
+static inline
+bool mrqd_oread_validate(void * lock, unsigned long version){
+    MRQDLock *l = (MRQDLock*)lock;
+    atomic_thread_fence(memory_order_acquire);
+    return (version & 1) == 0 &&
+        version == atomic_load_explicit(&l->version.value, memory_order_relaxed);
+}
 void mrqd_delegate(void* lock,
                    void (*funPtr)(unsigned int, void *), 
                    unsigned int messageSize,
@@ -41,11 +151,51 @@ void mrqd_close_delegate_buffer(void * buffer,
                                 void (*funPtr)(unsigned int, void *));
 void mrqd_delegate_unlock(void* lock);
 void mrqd_executeAndWaitCS(unsigned int size, void * data);
+static inline
+void mrqd_delegate_fence(void * lock){
+    MRQDLock *l = (MRQDLock*)lock;
+    ll_delegate_fence_version(&l->version.value);
+}
+// See LL_wait_until in locks/locks.h
+void mrqd_wait_until(void * lock, bool (*predicate)(void *), void * arg);
 void mrqd_delegate_wait(void* lock,
                         void (*funPtr)(unsigned int, void *), 
                         unsigned int messageSize,
                         void * messageAddress);
+// See LL_delegate_read in locks/locks.h
+void mrqd_delegate_read(void* lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress);
+bool mrqd_lock_timed(void * lock, uint64_t timeoutNanos);
+bool mrqd_try_delegate(void* lock,
+                       void (*funPtr)(unsigned int, void *), 
+                       unsigned int messageSize,
+                       void * messageAddress);
+// Puts the critical section in the queue if a holder has opened it
+// and writers are not blocked by readers. Never takes the lock (see
+// locks/delegate_forward.h).
+bool mrqd_try_enqueue(void* lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress);
+bool mrqd_delegate_timed(void* lock,
+                         void (*funPtr)(unsigned int, void *), 
+                         unsigned int messageSize,
+                         void * messageAddress,
+                         uint64_t timeoutNanos);
+// Returns a snapshot of the fairness statistics of the lock. The
+// values are only exact when no thread is using the lock.
+MRQDFairnessStats mrqd_fairness_stats(MRQDLock * lock);
 MRQDLock * plain_mrqd_create();
 OOLock * oo_mrqd_create();
+MRQDLock * plain_mrqd_create_with_read_indicator(LL_read_indicator_type readIndicatorType);
+OOLock * oo_mrqd_create_with_read_indicator(LL_read_indicator_type readIndicatorType);
+MRQDLock * plain_mrqd_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                       int width);
+OOLock * oo_mrqd_create_with_read_indicator_width(LL_read_indicator_type readIndicatorType,
+                                                  int width);
+MRQDLock * plain_mrqd_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator);
+OOLock * oo_mrqd_create_with_shared_read_indicator(ReadIndicator * sharedReadIndicator);
 
 #endif
@@ -0,0 +1,66 @@
+#include "oo_lock_api.h"
+
+#include "locks/locks.h"
+
+void * ll_oo_create(LL_lock_type_name lockType){
+    if(lockType >= PLAIN_MCS_LOCK){
+        LL_error_and_exit("ll_oo_create can only create OO lock types\n");
+    }
+    return LL_create(lockType);
+}
+
+void ll_oo_free(void * lock){
+    LL_free((OOLock *)lock);
+}
+
+void ll_oo_lock(void * lock){
+    LL_lock((OOLock *)lock);
+}
+
+void ll_oo_unlock(void * lock){
+    LL_unlock((OOLock *)lock);
+}
+
+bool ll_oo_try_lock(void * lock){
+    return LL_try_lock((OOLock *)lock);
+}
+
+void ll_oo_rlock(void * lock){
+    LL_rlock((OOLock *)lock);
+}
+
+void ll_oo_runlock(void * lock){
+    LL_runlock((OOLock *)lock);
+}
+
+void ll_oo_delegate(void * lock,
+                    void (*funPtr)(unsigned int, void *),
+                    unsigned int messageSize,
+                    void * messageAddress){
+    LL_delegate((OOLock *)lock, funPtr, messageSize, messageAddress);
+}
+
+void ll_oo_delegate_wait(void * lock,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress){
+    LL_delegate_wait((OOLock *)lock, funPtr, messageSize, messageAddress);
+}
+
+void ll_oo_delegate_fence(void * lock){
+    LL_delegate_fence((OOLock *)lock);
+}
+
+void * ll_oo_delegate_or_lock(void * lock, unsigned int messageSize){
+    return LL_delegate_or_lock((OOLock *)lock, messageSize);
+}
+
+void ll_oo_close_delegate_buffer(void * lock,
+                                 void * buffer,
+                                 void (*funPtr)(unsigned int, void *)){
+    LL_close_delegate_buffer((OOLock *)lock, buffer, funPtr);
+}
+
+void ll_oo_delegate_unlock(void * lock){
+    LL_delegate_unlock((OOLock *)lock);
+}
@@ -0,0 +1,51 @@
+#ifndef OO_LOCK_API_H
+#define OO_LOCK_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "locks/lock_type_name.h"
+
+/* Linkable OOLock API */
+
+// The functions in locks/locks.h are macros and inline functions that
+// need a C11 compiler. This file declares ordinary functions for the
+// most common operations on an `OOLock`, so the locks can be used from
+// C++ (see locks/locks.hpp) and from other languages that can call C
+// functions. The lock is passed as a `void *` that points to an
+// `OOLock`. The functions do the same as the `LL_*` function with the
+// same suffix.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only the OO lock types (the ones without the PLAIN_ prefix) can be
+// created with this function
+void * ll_oo_create(LL_lock_type_name lockType);
+void ll_oo_free(void * lock);
+void ll_oo_lock(void * lock);
+void ll_oo_unlock(void * lock);
+bool ll_oo_try_lock(void * lock);
+void ll_oo_rlock(void * lock);
+void ll_oo_runlock(void * lock);
+void ll_oo_delegate(void * lock,
+                    void (*funPtr)(unsigned int, void *),
+                    unsigned int messageSize,
+                    void * messageAddress);
+void ll_oo_delegate_wait(void * lock,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress);
+void ll_oo_delegate_fence(void * lock);
+void * ll_oo_delegate_or_lock(void * lock, unsigned int messageSize);
+void ll_oo_close_delegate_buffer(void * lock,
+                                 void * buffer,
+                                 void (*funPtr)(unsigned int, void *));
+void ll_oo_delegate_unlock(void * lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,8 +2,11 @@
 #define OO_LOCK_INTERFACE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include "misc/padded_types.h"
+#include "misc/error_help.h"
+#include "locks/wait_until.h"
 
 typedef struct {
     void (*free)(void*);
@@ -26,7 +29,51 @@ typedef struct {
     void (*close_delegate_buffer)(void * buffer,
                                   void (*funPtr)(unsigned int, void *));
     void (*delegate_unlock)(void* lock);
-    char pad[CACHE_LINE_SIZE -  (8 * sizeof(void*)) % CACHE_LINE_SIZE];
+    bool (*lock_timed)(void* lock, uint64_t timeoutNanos);
+    bool (*try_delegate)(void*,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress);
+    bool (*delegate_timed)(void*,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress,
+                           uint64_t timeoutNanos);
+    // NULL for lock types without optimistic reads
+    unsigned long (*oread_begin)(void* lock);
+    bool (*oread_validate)(void* lock, unsigned long version);
+    // NULL for lock types without upgradable read locks
+    bool (*upgrade)(void* lock);
+    void (*downgrade)(void* lock);
+    // NULL for lock types that execute read delegations under rlock
+    void (*delegate_read)(void* lock,
+                          void (*funPtr)(unsigned int, void *),
+                          unsigned int messageSize,
+                          void * messageAddress);
+    // NULL for lock types that execute delegated critical sections
+    // before the delegate call returns
+    void (*delegate_fence)(void* lock);
+    // NULL for lock types that can not be the target of a forwarded
+    // follow-up (see locks/delegate_forward.h)
+    bool (*try_enqueue)(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress);
+    // NULL for lock types without priority lanes
+    void (*delegate_priority)(void* lock,
+                              unsigned int priority,
+                              void (*funPtr)(unsigned int, void *),
+                              unsigned int messageSize,
+                              void * messageAddress);
+    void (*delegate_wait_priority)(void* lock,
+                                   unsigned int priority,
+                                   void (*funPtr)(unsigned int, void *),
+                                   unsigned int messageSize,
+                                   void * messageAddress);
+    // NULL for lock types that evaluate the predicate of a waiter by
+    // taking the lock
+    void (*wait_until)(void* lock, bool (*predicate)(void *), void * arg);
+    char pad[CACHE_LINE_SIZE -  (25 * sizeof(void*)) % CACHE_LINE_SIZE];
 } OOLockMethodTable;
 
 typedef struct {
@@ -40,4 +87,101 @@ static inline void oolock_free(OOLock * lock){
     free(lock);
 }
 
+// Lock types without optimistic reads return an odd version, which
+// never validates
+static inline unsigned long oolock_oread_begin(OOLock * lock){
+    if(lock->m->oread_begin == NULL){
+        return 1;
+    }
+    return lock->m->oread_begin(lock->lock);
+}
+
+static inline bool oolock_oread_validate(OOLock * lock, unsigned long version){
+    if(lock->m->oread_validate == NULL){
+        return false;
+    }
+    return lock->m->oread_validate(lock->lock, version);
+}
+
+// Lock types without upgradable read locks always fail to upgrade
+static inline bool oolock_upgrade(OOLock * lock){
+    if(lock->m->upgrade == NULL){
+        lock->m->runlock(lock->lock);
+        return false;
+    }
+    return lock->m->upgrade(lock->lock);
+}
+
+static inline bool oolock_upgrade_or_delegate(OOLock * lock,
+                                              void (*funPtr)(unsigned int, void *),
+                                              unsigned int messageSize,
+                                              void * messageAddress){
+    if(oolock_upgrade(lock)){
+        return true;
+    }
+    lock->m->delegate(lock->lock, funPtr, messageSize, messageAddress);
+    return false;
+}
+
+static inline void oolock_delegate_read(OOLock * lock,
+                                        void (*funPtr)(unsigned int, void *),
+                                        unsigned int messageSize,
+                                        void * messageAddress){
+    if(lock->m->delegate_read == NULL){
+        lock->m->rlock(lock->lock);
+        funPtr(messageSize, messageAddress);
+        lock->m->runlock(lock->lock);
+    }else{
+        lock->m->delegate_read(lock->lock, funPtr, messageSize, messageAddress);
+    }
+}
+
+static inline void oolock_delegate_fence(OOLock * lock){
+    if(lock->m->delegate_fence != NULL){
+        lock->m->delegate_fence(lock->lock);
+    }
+}
+
+// Lock types without priority lanes ignore the priority
+static inline void oolock_delegate_priority(OOLock * lock,
+                                            unsigned int priority,
+                                            void (*funPtr)(unsigned int, void *),
+                                            unsigned int messageSize,
+                                            void * messageAddress){
+    if(lock->m->delegate_priority == NULL){
+        lock->m->delegate(lock->lock, funPtr, messageSize, messageAddress);
+    }else{
+        lock->m->delegate_priority(lock->lock, priority, funPtr, messageSize, messageAddress);
+    }
+}
+
+static inline void oolock_delegate_wait_priority(OOLock * lock,
+                                                 unsigned int priority,
+                                                 void (*funPtr)(unsigned int, void *),
+                                                 unsigned int messageSize,
+                                                 void * messageAddress){
+    if(lock->m->delegate_wait_priority == NULL){
+        lock->m->delegate_wait(lock->lock, funPtr, messageSize, messageAddress);
+    }else{
+        lock->m->delegate_wait_priority(lock->lock, priority, funPtr, messageSize, messageAddress);
+    }
+}
+
+static inline void oolock_wait_until(OOLock * lock,
+                                     bool (*predicate)(void *),
+                                     void * arg){
+    if(lock->m->wait_until == NULL){
+        ll_wait_until_polling(lock->lock, lock->m->lock, lock->m->unlock, predicate, arg);
+    }else{
+        lock->m->wait_until(lock->lock, predicate, arg);
+    }
+}
+
+static inline void oolock_downgrade(OOLock * lock){
+    if(lock->m->downgrade == NULL){
+        LL_error_and_exit("Downgrade is not supported by the lock type\n");
+    }
+    lock->m->downgrade(lock->lock);
+}
+
 #endif
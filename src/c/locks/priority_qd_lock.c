@@ -0,0 +1,336 @@
+#include "priority_qd_lock.h"
+
+
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable PRIORITY_QD_LOCK_METHOD_TABLE =
+{
+     .free = &free,
+     .lock = &pqd_lock,
+     .unlock = &pqd_unlock,
+     .is_locked = &pqd_is_locked,
+     .try_lock = &pqd_try_lock,
+     .rlock = &pqd_rlock,
+     .runlock = &pqd_runlock,
+     .delegate = &pqd_delegate,
+     .delegate_wait = &pqd_delegate_wait,
+     .delegate_or_lock = &pqd_delegate_or_lock,
+     .close_delegate_buffer = &pqd_close_delegate_buffer,
+     .delegate_unlock = &pqd_delegate_unlock,
+     .lock_timed = &pqd_lock_timed,
+     .try_delegate = &pqd_try_delegate,
+     .delegate_timed = &pqd_delegate_timed,
+     .delegate_fence = &pqd_delegate_fence,
+     .try_enqueue = &pqd_try_enqueue,
+     .delegate_priority = &pqd_delegate_priority,
+     .delegate_wait_priority = &pqd_delegate_wait_priority,
+     .wait_until = &pqd_wait_until
+};
+
+
+// Called by the lock holder after the lock has been taken for writing
+static inline void pqd_begin_write(PriorityQDLock * l){
+    ll_forward_count_begin_write(&l->forwards);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Called by the lock holder before the lock is released
+static inline void pqd_end_write(PriorityQDLock * l){
+    ll_wake_waiters(&l->waiters);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_release);
+}
+
+static inline void pqd_open(PriorityQDLock * l){
+    for(int i = 0; i < PQD_LOCK_NUMBER_OF_LANES; i++){
+        qdq_open(&l->lanes[i]);
+    }
+}
+
+static inline unsigned int pqd_lane(unsigned int priority){
+    return priority < PQD_LOCK_NUMBER_OF_LANES ? priority : PQD_LOCK_DEFAULT_PRIORITY;
+}
+
+// Executes the requests in the lanes (see the description in
+// priority_qd_lock.h) and closes them
+static void pqd_flush(PriorityQDLock * l){
+    unsigned long done[PQD_LOCK_NUMBER_OF_LANES] = {0};
+    int openLanes = PQD_LOCK_NUMBER_OF_LANES;
+    volatile atomic_ulong * previousForwards =
+        ll_forwarding_enter(ll_forward_count_current(&l->forwards));
+    while(openLanes > 0){
+        bool executedSome = false;
+        for(int i = 0; i < PQD_LOCK_NUMBER_OF_LANES; i++){
+            if(done[i] == QD_QUEUE_BUFFER_SIZE){
+                continue;
+            }
+            unsigned long executed = qdq_flush_available(&l->lanes[i],
+                                                         &done[i],
+                                                         PQD_LOCK_FAIRNESS_BOUND);
+            if(done[i] == QD_QUEUE_BUFFER_SIZE){
+                openLanes--;
+            }
+            if(executed > 0){
+                executedSome = true;
+            }
+        }
+        if(!executedSome){
+            for(int i = PQD_LOCK_NUMBER_OF_LANES - 1; i >= 0; i--){
+                if(done[i] == QD_QUEUE_BUFFER_SIZE){
+                    continue;
+                }else if(qdq_try_close(&l->lanes[i], &done[i])){
+                    openLanes--;
+                }else{
+                    break;
+                }
+            }
+        }
+    }
+    ll_forwarding_exit(previousForwards);
+}
+
+static inline void pqd_release(PriorityQDLock * l){
+    pqd_flush(l);
+    pqd_end_write(l);
+    tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
+}
+
+
+void pqd_initialize(PriorityQDLock * lock){
+    tatas_initialize(&lock->mutexLock);
+    atomic_store(&lock->version.value, 0);
+    ll_forward_count_initialize(&lock->forwards);
+    ll_waiters_initialize(&lock->waiters);
+    for(int i = 0; i < PQD_LOCK_NUMBER_OF_LANES; i++){
+        qdq_initialize(&lock->lanes[i]);
+    }
+}
+
+void pqd_lock(void * lock) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    tatas_lock(&l->mutexLock);
+    pqd_begin_write(l);
+}
+
+void pqd_unlock(void * lock) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    pqd_end_write(l);
+    tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
+}
+
+bool pqd_try_lock(void * lock) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    if(tatas_try_lock(&l->mutexLock)){
+        pqd_begin_write(l);
+        return true;
+    }
+    return false;
+}
+
+void pqd_rlock(void * lock) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    tatas_lock(&l->mutexLock);
+}
+
+void pqd_runlock(void * lock) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    tatas_unlock(&l->mutexLock);
+}
+
+void pqd_delegate_priority(void* lock,
+                           unsigned int priority,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    QDQueue * lane = &l->lanes[pqd_lane(priority)];
+    while(true) {
+        if(tatas_try_lock(&l->mutexLock)) {
+            pqd_begin_write(l);
+            pqd_open(l);
+            funPtr(messageSize, messageAddress);
+            pqd_release(l);
+            return;
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(qdq_enqueue(lane,
+                       funPtr,
+                       messageSize,
+                       messageAddress)){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+            return;
+        }
+        thread_yield();
+    }
+}
+
+void pqd_delegate(void* lock,
+                  void (*funPtr)(unsigned int, void *),
+                  unsigned int messageSize,
+                  void * messageAddress) {
+    pqd_delegate_priority(lock, PQD_LOCK_DEFAULT_PRIORITY, funPtr, messageSize, messageAddress);
+}
+
+void * pqd_delegate_or_lock_priority(void* lock,
+                                     unsigned int priority,
+                                     unsigned int messageSize) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    QDQueue * lane = &l->lanes[pqd_lane(priority)];
+    void * buffer;
+    while(true) {
+        if(tatas_try_lock(&l->mutexLock)) {
+            pqd_begin_write(l);
+            pqd_open(l);
+            return NULL;
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(NULL != (buffer = qdq_enqueue_get_buffer(lane, messageSize))){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+            return buffer;
+        }
+        thread_yield();
+    }
+}
+
+void * pqd_delegate_or_lock(void* lock,
+                            unsigned int messageSize) {
+    return pqd_delegate_or_lock_priority(lock, PQD_LOCK_DEFAULT_PRIORITY, messageSize);
+}
+
+void pqd_close_delegate_buffer(void * buffer,
+                               void (*funPtr)(unsigned int, void *)){
+    qdq_enqueue_close_buffer(buffer, funPtr);
+}
+
+void pqd_delegate_unlock(void* lock) {
+    pqd_release((PriorityQDLock*)lock);
+}
+
+static void pqd_executeAndWaitCS(unsigned int size, void * data){
+    char * buff = data;
+    volatile atomic_int * writeBackAddress = *((volatile atomic_int **)buff);
+    void (*csFunc)(unsigned int, void *) =
+        *((void (**)(unsigned int, void *))&(buff[sizeof(volatile atomic_int *)]));
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    void * csData = (void*)&(buff[metaDataSize]);
+    csFunc(size - metaDataSize, csData);
+    atomic_store_explicit(writeBackAddress, 0, memory_order_release);
+}
+
+void pqd_delegate_wait_priority(void* lock,
+                                unsigned int priority,
+                                void (*funPtr)(unsigned int, void *),
+                                unsigned int messageSize,
+                                void * messageAddress) {
+    volatile atomic_int waitVar = ATOMIC_VAR_INIT(1);
+    unsigned int metaDataSize = sizeof(volatile atomic_int *) +
+        sizeof(void (*)(unsigned int, void *));
+    char * buff = pqd_delegate_or_lock_priority(lock,
+                                                priority,
+                                                metaDataSize + messageSize);
+    if(buff==NULL){
+        funPtr(messageSize, messageAddress);
+        pqd_delegate_unlock(lock);
+    }else{
+        volatile atomic_int ** waitVarPtrAddress = (volatile atomic_int **)buff;
+        *waitVarPtrAddress = &waitVar;
+        void (**funPtrAdress)(unsigned int, void *) = (void (**)(unsigned int, void *))&buff[sizeof(volatile atomic_int *)];
+        *funPtrAdress = funPtr;
+        char * msgBuffer = (char *)messageAddress;
+        for(unsigned int i = metaDataSize; i < (messageSize + metaDataSize); i++){
+            buff[i] = msgBuffer[i - metaDataSize];
+        }
+        pqd_close_delegate_buffer((void *)buff, pqd_executeAndWaitCS);
+        while(atomic_load_explicit(&waitVar, memory_order_acquire)){
+            thread_yield();
+        }
+    }
+}
+
+void pqd_delegate_wait(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress) {
+    pqd_delegate_wait_priority(lock, PQD_LOCK_DEFAULT_PRIORITY, funPtr, messageSize, messageAddress);
+}
+
+bool pqd_lock_timed(void * lock, uint64_t timeoutNanos) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    if(tatas_lock_timed(&l->mutexLock, timeoutNanos)){
+        pqd_begin_write(l);
+        return true;
+    }
+    return false;
+}
+
+bool pqd_try_delegate(void* lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    if(tatas_try_lock(&l->mutexLock)) {
+        pqd_begin_write(l);
+        pqd_open(l);
+        funPtr(messageSize, messageAddress);
+        pqd_release(l);
+        return true;
+    }
+    return pqd_try_enqueue(lock, funPtr, messageSize, messageAddress);
+}
+
+bool pqd_try_enqueue(void* lock,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress) {
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    unsigned long version = ll_delegate_fence_observe(&l->version.value);
+    if(qdq_enqueue(&l->lanes[PQD_LOCK_DEFAULT_PRIORITY],
+                   funPtr,
+                   messageSize,
+                   messageAddress)){
+        ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+        return true;
+    }
+    return false;
+}
+
+bool pqd_delegate_timed(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos) {
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(true) {
+        if(pqd_try_delegate(lock, funPtr, messageSize, messageAddress)) {
+            return true;
+        } else if(ll_deadline_passed(deadline)) {
+            return false;
+        }
+        thread_yield();
+    }
+}
+
+void pqd_wait_until(void * lock, bool (*predicate)(void *), void * arg){
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    ll_wait_until(l, &l->waiters, pqd_delegate, predicate, arg);
+}
+
+PriorityQDLock * plain_pqd_create(){
+    PriorityQDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(PriorityQDLock));
+    pqd_initialize(l);
+    return l;
+}
+
+OOLock * oo_pqd_create(){
+    PriorityQDLock * l = plain_pqd_create();
+    OOLock * ool = aligned_alloc(CACHE_LINE_SIZE, sizeof(OOLock));
+    ool->lock = l;
+    ool->m = &PRIORITY_QD_LOCK_METHOD_TABLE;
+    return ool;
+}
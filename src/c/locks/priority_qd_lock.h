@@ -0,0 +1,126 @@
+#ifndef PRIORITY_QD_LOCK_H
+#define PRIORITY_QD_LOCK_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "misc/padded_types.h"
+#include "misc/timing.h"
+#include "locks/tatas_lock.h"
+#include "locks/delegate_fence.h"
+#include "locks/delegate_forward.h"
+#include "locks/wait_until.h"
+#include "locks/oo_lock_interface.h"
+#include "qd_queues/qd_queue.h"
+
+/* Priority Queue Delegation Lock */
+
+// A queue delegation lock with one queue (lane) per priority level.
+// Priority 0 is the highest. Delegated critical sections that do not
+// give a priority go to the lowest priority lane, so a few latency
+// critical requests can be delegated with a high priority while bulk
+// requests use the normal operations.
+//
+// The holder executes the requests in rounds. In each round it goes
+// through the lanes from the highest priority to the lowest and
+// executes up to PQD_LOCK_FAIRNESS_BOUND requests from each lane. A
+// request in the highest priority lane therefore waits for at most
+// PQD_LOCK_FAIRNESS_BOUND requests from each of the other lanes, and
+// the lower priority lanes are not starved. When all lanes are empty
+// the holder closes them, from the lowest priority lane up, so the
+// high priority lanes stay open the longest.
+//
+// The version, the forward count and the waiters work as in the QD
+// lock (see locks/qd_lock.h).
+
+#ifndef PQD_LOCK_NUMBER_OF_LANES
+#    define PQD_LOCK_NUMBER_OF_LANES 2
+#endif
+
+#ifndef PQD_LOCK_FAIRNESS_BOUND
+#    define PQD_LOCK_FAIRNESS_BOUND 64
+#endif
+
+#define PQD_LOCK_DEFAULT_PRIORITY (PQD_LOCK_NUMBER_OF_LANES - 1)
+
+typedef struct {
+    TATASLock mutexLock;
+    LLPaddedULong version;
+    LLForwardCount forwards;
+    LLPaddedPointer waiters;
+    QDQueue lanes[PQD_LOCK_NUMBER_OF_LANES];
+} PriorityQDLock;
+
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable PRIORITY_QD_LOCK_METHOD_TABLE;
+
+void pqd_initialize(PriorityQDLock * lock);
+void pqd_lock(void * lock);
+void pqd_unlock(void * lock);
+static inline
+bool pqd_is_locked(void * lock){
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    return tatas_is_locked(&l->mutexLock);
+}
+bool pqd_try_lock(void * lock);
+// Reader locks do not increment the version
+void pqd_rlock(void * lock);
+void pqd_runlock(void * lock);
+void pqd_delegate(void* lock,
+                  void (*funPtr)(unsigned int, void *),
+                  unsigned int messageSize,
+                  void * messageAddress);
+// Works like pqd_delegate but puts the request in the lane of the
+// given priority (0 is the highest)
+void pqd_delegate_priority(void* lock,
+                           unsigned int priority,
+                           void (*funPtr)(unsigned int, void *),
+                           unsigned int messageSize,
+                           void * messageAddress);
+void * pqd_delegate_or_lock(void* lock,
+                            unsigned int messageSize);
+void * pqd_delegate_or_lock_priority(void* lock,
+                                     unsigned int priority,
+                                     unsigned int messageSize);
+void pqd_close_delegate_buffer(void * buffer,
+                               void (*funPtr)(unsigned int, void *));
+void pqd_delegate_unlock(void* lock);
+void pqd_delegate_wait(void* lock,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress);
+void pqd_delegate_wait_priority(void* lock,
+                                unsigned int priority,
+                                void (*funPtr)(unsigned int, void *),
+                                unsigned int messageSize,
+                                void * messageAddress);
+// See LL_delegate_fence in locks/locks.h
+static inline
+void pqd_delegate_fence(void * lock){
+    PriorityQDLock *l = (PriorityQDLock*)lock;
+    ll_delegate_fence_version(&l->version.value);
+}
+// See LL_wait_until in locks/locks.h
+void pqd_wait_until(void * lock, bool (*predicate)(void *), void * arg);
+bool pqd_lock_timed(void * lock, uint64_t timeoutNanos);
+bool pqd_try_delegate(void* lock,
+                      void (*funPtr)(unsigned int, void *),
+                      unsigned int messageSize,
+                      void * messageAddress);
+// Puts the critical section in the default lane if a holder has opened
+// it. Never takes the lock (see locks/delegate_forward.h).
+bool pqd_try_enqueue(void* lock,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress);
+bool pqd_delegate_timed(void* lock,
+                        void (*funPtr)(unsigned int, void *),
+                        unsigned int messageSize,
+                        void * messageAddress,
+                        uint64_t timeoutNanos);
+PriorityQDLock * plain_pqd_create();
+OOLock * oo_pqd_create();
+
+#endif
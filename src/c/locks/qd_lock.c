@@ -9,37 +9,85 @@ OOLockMethodTable QD_LOCK_METHOD_TABLE =
      .unlock = &qd_unlock,
      .is_locked = &qd_is_locked,
      .try_lock = &qd_try_lock,
-     .rlock = &qd_lock,
-     .runlock = &qd_unlock,
+     .rlock = &qd_rlock,
+     .runlock = &qd_runlock,
      .delegate = &qd_delegate,
      .delegate_wait = &qd_delegate_wait,
      .delegate_or_lock = &qd_delegate_or_lock,
      .close_delegate_buffer = &qd_close_delegate_buffer,
-     .delegate_unlock = &qd_delegate_unlock
+     .delegate_unlock = &qd_delegate_unlock,
+     .lock_timed = &qd_lock_timed,
+     .try_delegate = &qd_try_delegate,
+     .delegate_timed = &qd_delegate_timed,
+     .oread_begin = &qd_oread_begin,
+     .oread_validate = &qd_oread_validate,
+     .delegate_fence = &qd_delegate_fence,
+     .try_enqueue = &qd_try_enqueue,
+     .wait_until = &qd_wait_until
 };
 
 
 
+// Called by the lock holder after the lock has been taken for writing
+static inline void qd_begin_write(QDLock * l){
+    ll_forward_count_begin_write(&l->forwards);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Called by the lock holder before the lock is released
+static inline void qd_end_write(QDLock * l){
+    ll_wake_waiters(&l->waiters);
+    unsigned long version =
+        atomic_load_explicit(&l->version.value, memory_order_relaxed);
+    atomic_store_explicit(&l->version.value, version + 1, memory_order_release);
+}
+
+
 void qd_initialize(QDLock * lock){
     tatas_initialize(&lock->mutexLock);
+    atomic_store(&lock->version.value, 0);
+    ll_forward_count_initialize(&lock->forwards);
+    ll_waiters_initialize(&lock->waiters);
     qdq_initialize(&lock->queue);
 }
 
  void qd_lock(void * lock) {
     QDLock *l = (QDLock*)lock;
     tatas_lock(&l->mutexLock);
+    qd_begin_write(l);
 }
 
 
 void qd_unlock(void * lock) {
     QDLock *l = (QDLock*)lock;
+    qd_end_write(l);
     tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
 }
 
 
 bool qd_try_lock(void * lock) {
     QDLock *l = (QDLock*)lock;
-    return tatas_try_lock(&l->mutexLock);
+    if(tatas_try_lock(&l->mutexLock)){
+        qd_begin_write(l);
+        return true;
+    }
+    return false;
+}
+
+
+void qd_rlock(void * lock) {
+    QDLock *l = (QDLock*)lock;
+    tatas_lock(&l->mutexLock);
+}
+
+
+void qd_runlock(void * lock) {
+    QDLock *l = (QDLock*)lock;
+    tatas_unlock(&l->mutexLock);
 }
 
 
@@ -50,15 +98,21 @@ void qd_delegate(void* lock,
     QDLock *l = (QDLock*)lock;
     while(true) {
         if(tatas_try_lock(&l->mutexLock)) {
+            qd_begin_write(l);
             qdq_open(&l->queue);
             funPtr(messageSize, messageAddress);
-            qdq_flush(&l->queue);
+            ll_forwarding_flush(&l->queue, &l->forwards);
+            qd_end_write(l);
             tatas_unlock(&l->mutexLock);
+            ll_send_deferred_forwards();
             return;
-        } else if(qdq_enqueue(&l->queue,
-                              funPtr,
-                              messageSize,
-                              messageAddress)){
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(qdq_enqueue(&l->queue,
+                       funPtr,
+                       messageSize,
+                       messageAddress)){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
             return;
         }
         thread_yield();
@@ -72,10 +126,13 @@ void * qd_delegate_or_lock(void* lock,
     void * buffer;
     while(true) {
         if(tatas_try_lock(&l->mutexLock)) {
+            qd_begin_write(l);
             qdq_open(&l->queue);
             return NULL;
-        } else if(NULL != (buffer = qdq_enqueue_get_buffer(&l->queue,
-                                                           messageSize))){
+        }
+        unsigned long version = ll_delegate_fence_observe(&l->version.value);
+        if(NULL != (buffer = qdq_enqueue_get_buffer(&l->queue, messageSize))){
+            ll_delegate_fence_record(&l->version.value, version, &l->forwards);
             return buffer;
         }
         thread_yield();
@@ -91,8 +148,10 @@ void qd_close_delegate_buffer(void * buffer,
  
 void qd_delegate_unlock(void* lock) {
     QDLock *l = (QDLock*)lock;
-    qdq_flush(&l->queue);
+    ll_forwarding_flush(&l->queue, &l->forwards);
+    qd_end_write(l);
     tatas_unlock(&l->mutexLock);
+    ll_send_deferred_forwards();
 }
 
  
@@ -140,6 +199,74 @@ void qd_delegate_wait(void* lock,
 }
 
 
+bool qd_lock_timed(void * lock, uint64_t timeoutNanos) {
+    QDLock *l = (QDLock*)lock;
+    if(tatas_lock_timed(&l->mutexLock, timeoutNanos)){
+        qd_begin_write(l);
+        return true;
+    }
+    return false;
+}
+
+
+bool qd_try_delegate(void* lock,
+                     void (*funPtr)(unsigned int, void *), 
+                     unsigned int messageSize,
+                     void * messageAddress) {
+    QDLock *l = (QDLock*)lock;
+    if(tatas_try_lock(&l->mutexLock)) {
+        qd_begin_write(l);
+        qdq_open(&l->queue);
+        funPtr(messageSize, messageAddress);
+        ll_forwarding_flush(&l->queue, &l->forwards);
+        qd_end_write(l);
+        tatas_unlock(&l->mutexLock);
+        ll_send_deferred_forwards();
+        return true;
+    }
+    return qd_try_enqueue(lock, funPtr, messageSize, messageAddress);
+}
+
+
+bool qd_try_enqueue(void* lock,
+                    void (*funPtr)(unsigned int, void *),
+                    unsigned int messageSize,
+                    void * messageAddress) {
+    QDLock *l = (QDLock*)lock;
+    unsigned long version = ll_delegate_fence_observe(&l->version.value);
+    if(qdq_enqueue(&l->queue,
+                   funPtr,
+                   messageSize,
+                   messageAddress)){
+        ll_delegate_fence_record(&l->version.value, version, &l->forwards);
+        return true;
+    }
+    return false;
+}
+
+
+bool qd_delegate_timed(void* lock,
+                       void (*funPtr)(unsigned int, void *), 
+                       unsigned int messageSize,
+                       void * messageAddress,
+                       uint64_t timeoutNanos) {
+    uint64_t deadline = ll_deadline_from_timeout(timeoutNanos);
+    while(true) {
+        if(qd_try_delegate(lock, funPtr, messageSize, messageAddress)) {
+            return true;
+        } else if(ll_deadline_passed(deadline)) {
+            return false;
+        }
+        thread_yield();
+    }
+}
+
+
+void qd_wait_until(void * lock, bool (*predicate)(void *), void * arg){
+    QDLock *l = (QDLock*)lock;
+    ll_wait_until(l, &l->waiters, qd_delegate, predicate, arg);
+}
+
 QDLock * plain_qd_create(){
     QDLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(QDLock));
     qd_initialize(l);
@@ -7,15 +7,33 @@
 
 #include "misc/padded_types.h"
 #include "locks/tatas_lock.h"
+#include "locks/delegate_fence.h"
+#include "locks/wait_until.h"
 #include "qd_queues/qd_queue.h"
 
 /* Queue Delegation Lock */
 
+// The version is odd while a thread that may write holds the lock. It
+// is incremented when the lock is taken for writing and when it is
+// released, so a critical section or a flushed batch of delegated
+// critical sections is bracketed by two increments. Optimistic readers
+// (see LL_oread_begin in locks/locks.h) use it to detect writes. The
+// forward count keeps track of the follow-ups forwarded from batches of
+// the lock that have not been executed (see locks/delegate_forward.h).
+// The waiters are the threads that wait in LL_wait_until (see
+// locks/wait_until.h).
 typedef struct {
     TATASLock mutexLock;
+    LLPaddedULong version;
+    LLForwardCount forwards;
+    LLPaddedPointer waiters;
     QDQueue queue;
 } QDLock;
 
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable QD_LOCK_METHOD_TABLE;
+
 void qd_initialize(QDLock * lock);
 void qd_lock(void * lock);
 void qd_unlock(void * lock);
@@ -25,6 +43,21 @@ bool qd_is_locked(void * lock){
     return tatas_is_locked(&l->mutexLock);
 }
 bool qd_try_lock(void * lock);
+// Reader locks do not increment the version
+void qd_rlock(void * lock);
+void qd_runlock(void * lock);
+static inline
+unsigned long qd_oread_begin(void * lock){
+    QDLock *l = (QDLock*)lock;
+    return atomic_load_explicit(&l->version.value, memory_order_acquire);
+}
+static inline
+bool qd_oread_validate(void * lock, unsigned long version){
+    QDLock *l = (QDLock*)lock;
+    atomic_thread_fence(memory_order_acquire);
+    return (version & 1) == 0 &&
+        version == atomic_load_explicit(&l->version.value, memory_order_relaxed);
+}
 void qd_delegate(void* lock,
                  void (*funPtr)(unsigned int, void *), 
                  unsigned int messageSize,
@@ -34,10 +67,34 @@ void * qd_delegate_or_lock(void* lock,
 void qd_close_delegate_buffer(void * buffer,
                               void (*funPtr)(unsigned int, void *));
 void qd_delegate_unlock(void* lock);
+// See LL_delegate_fence in locks/locks.h
+static inline
+void qd_delegate_fence(void * lock){
+    QDLock *l = (QDLock*)lock;
+    ll_delegate_fence_version(&l->version.value);
+}
+// See LL_wait_until in locks/locks.h
+void qd_wait_until(void * lock, bool (*predicate)(void *), void * arg);
 void qd_delegate_wait(void* lock,
                       void (*funPtr)(unsigned int, void *), 
                       unsigned int messageSize,
                       void * messageAddress);
+bool qd_lock_timed(void * lock, uint64_t timeoutNanos);
+bool qd_try_delegate(void* lock,
+                     void (*funPtr)(unsigned int, void *), 
+                     unsigned int messageSize,
+                     void * messageAddress);
+// Puts the critical section in the queue if a holder has opened it.
+// Never takes the lock (see locks/delegate_forward.h).
+bool qd_try_enqueue(void* lock,
+                    void (*funPtr)(unsigned int, void *),
+                    unsigned int messageSize,
+                    void * messageAddress);
+bool qd_delegate_timed(void* lock,
+                       void (*funPtr)(unsigned int, void *), 
+                       unsigned int messageSize,
+                       void * messageAddress,
+                       uint64_t timeoutNanos);
 QDLock * plain_qd_create();
 OOLock * oo_qd_create();
 
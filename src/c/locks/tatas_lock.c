@@ -14,7 +14,10 @@ OOLockMethodTable TATAS_LOCK_METHOD_TABLE =
      .delegate_wait = &tatas_delegate,
      .delegate_or_lock = &tatas_delegate_or_lock,
      .close_delegate_buffer = NULL, /* Should never be called */
-     .delegate_unlock = &tatas_unlock
+     .delegate_unlock = &tatas_unlock,
+     .lock_timed = &tatas_lock_timed,
+     .try_delegate = &tatas_try_delegate,
+     .delegate_timed = &tatas_delegate_timed
 };
 
 
@@ -59,6 +62,58 @@ void * tatas_delegate_or_lock(void * lock, unsigned int messageSize){
 
 
 
+bool tatas_lock_until(void * lock, uint64_t deadline) {
+    TATASLock *l = (TATASLock*)lock;
+    while(true){
+        while(atomic_load_explicit(&l->lockFlag.value, 
+                                   memory_order_acquire)){
+            if(ll_deadline_passed(deadline)){
+                return false;
+            }
+            thread_yield();
+        }
+        if( ! atomic_flag_test_and_set_explicit(&l->lockFlag.value,
+                                                memory_order_acquire)){
+            return true;
+        }
+    }
+}
+
+
+bool tatas_lock_timed(void * lock, uint64_t timeoutNanos) {
+    return tatas_lock_until(lock, ll_deadline_from_timeout(timeoutNanos));
+}
+
+
+bool tatas_try_delegate(void * lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress){
+    TATASLock *l = (TATASLock*)lock;
+    if(!tatas_try_lock(l)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    tatas_unlock(l);
+    return true;
+}
+
+
+bool tatas_delegate_timed(void * lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress,
+                          uint64_t timeoutNanos){
+    TATASLock *l = (TATASLock*)lock;
+    if(!tatas_lock_timed(l, timeoutNanos)){
+        return false;
+    }
+    funPtr(messageSize, messageAddress);
+    tatas_unlock(l);
+    return true;
+}
+
+
 TATASLock * plain_tatas_create(){
     TATASLock * l = aligned_alloc(CACHE_LINE_SIZE, sizeof(TATASLock));
     tatas_initialize(l);
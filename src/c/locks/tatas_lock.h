@@ -6,6 +6,7 @@
 
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
 #include "misc/thread_includes.h"//Until c11 thread.h is available
+#include "misc/timing.h"
 #include <stdbool.h>
 
 
@@ -14,6 +15,10 @@ typedef struct TATASLockImpl {
 } TATASLock;
 
 
+extern
+_Alignas(CACHE_LINE_SIZE)
+OOLockMethodTable TATAS_LOCK_METHOD_TABLE;
+
 void tatas_initialize(TATASLock * lock);
 void tatas_lock(void * lock);
 static inline
@@ -40,6 +45,17 @@ void tatas_delegate(void * lock,
                     unsigned int messageSize,
                     void * messageAddress);
 void * tatas_delegate_or_lock(void * lock, unsigned int messageSize);
+bool tatas_lock_until(void * lock, uint64_t deadline);
+bool tatas_lock_timed(void * lock, uint64_t timeoutNanos);
+bool tatas_try_delegate(void * lock,
+                        void (*funPtr)(unsigned int, void *), 
+                        unsigned int messageSize,
+                        void * messageAddress);
+bool tatas_delegate_timed(void * lock,
+                          void (*funPtr)(unsigned int, void *), 
+                          unsigned int messageSize,
+                          void * messageAddress,
+                          uint64_t timeoutNanos);
 TATASLock * plain_tatas_create();
 OOLock * oo_tatas_create();
 
@@ -0,0 +1,78 @@
+#include "wait_until.h"
+
+static void ll_push_waiters(LLPaddedPointer * waiters, LLWaiter * first, LLWaiter * last){
+    intptr_t head = atomic_load_explicit(&waiters->value, memory_order_relaxed);
+    do{
+        last->next = (LLWaiter *)head;
+    }while(!atomic_compare_exchange_weak_explicit(&waiters->value,
+                                                  &head,
+                                                  (intptr_t)first,
+                                                  memory_order_release,
+                                                  memory_order_relaxed));
+}
+
+void ll_wake_waiters_slow(LLPaddedPointer * waiters){
+    LLWaiter * waiter =
+        (LLWaiter *)atomic_exchange_explicit(&waiters->value,
+                                             (intptr_t)NULL,
+                                             memory_order_acquire);
+    LLWaiter * first = NULL;
+    LLWaiter * last = NULL;
+    while(waiter != NULL){
+        // A satisfied waiter may return as soon as its flag is set
+        LLWaiter * next = waiter->next;
+        if(waiter->predicate(waiter->arg)){
+            atomic_store_explicit(&waiter->satisfied, true, memory_order_release);
+        }else if(last == NULL){
+            first = waiter;
+            last = waiter;
+        }else{
+            last->next = waiter;
+            last = waiter;
+        }
+        waiter = next;
+    }
+    if(first != NULL){
+        ll_push_waiters(waiters, first, last);
+    }
+}
+
+static void ll_wait_until_nothing(unsigned int messageSize, void * messageAddress){
+    (void)messageSize;
+    (void)messageAddress;
+}
+
+void ll_wait_until(void * lock,
+                   LLPaddedPointer * waiters,
+                   void (*delegate)(void*,
+                                    void (*funPtr)(unsigned int, void *),
+                                    unsigned int messageSize,
+                                    void * messageAddress),
+                   bool (*predicate)(void *),
+                   void * arg){
+    LLWaiter waiter;
+    waiter.predicate = predicate;
+    waiter.arg = arg;
+    atomic_store_explicit(&waiter.satisfied, false, memory_order_relaxed);
+    ll_push_waiters(waiters, &waiter, &waiter);
+    delegate(lock, ll_wait_until_nothing, 0, NULL);
+    while(!atomic_load_explicit(&waiter.satisfied, memory_order_acquire)){
+        thread_yield();
+    }
+}
+
+void ll_wait_until_polling(void * lock,
+                           void (*lockFun)(void*),
+                           void (*unlockFun)(void*),
+                           bool (*predicate)(void *),
+                           void * arg){
+    while(true){
+        lockFun(lock);
+        bool satisfied = predicate(arg);
+        unlockFun(lock);
+        if(satisfied){
+            return;
+        }
+        thread_yield();
+    }
+}
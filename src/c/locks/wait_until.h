@@ -0,0 +1,67 @@
+#ifndef WAIT_UNTIL_H
+#define WAIT_UNTIL_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "misc/padded_types.h"
+
+/* Waiting for Lock Protected State */
+
+// A thread that waits for the state protected by a QD, MRQD or
+// priority QD lock to change (see LL_wait_until in locks/locks.h)
+// pushes a waiter to a lock free stack in the lock and then delegates
+// an empty critical section to the lock. Every time a holder releases
+// the lock after writing it takes the whole stack, evaluates the
+// predicates of the waiters while it still holds the lock, marks the
+// satisfied waiters and puts the others back. The empty critical
+// section makes sure that a holder evaluates the predicate at least
+// once after the waiter has been pushed.
+//
+// A waiter spins on a flag in its own stack frame, so it does not
+// touch the lock while it waits. A holder that finds the stack empty
+// only pays for one load.
+
+typedef struct LLWaiterImpl {
+    struct LLWaiterImpl * next;
+    bool (*predicate)(void *);
+    void * arg;
+    volatile atomic_bool satisfied;
+} LLWaiter;
+
+static inline
+void ll_waiters_initialize(LLPaddedPointer * waiters){
+    atomic_store(&waiters->value, (intptr_t)NULL);
+}
+
+void ll_wake_waiters_slow(LLPaddedPointer * waiters);
+
+// Called by a holder that has written to the lock before it releases
+// the lock
+static inline
+void ll_wake_waiters(LLPaddedPointer * waiters){
+    if(atomic_load_explicit(&waiters->value, memory_order_relaxed) != (intptr_t)NULL){
+        ll_wake_waiters_slow(waiters);
+    }
+}
+
+void ll_wait_until(void * lock,
+                   LLPaddedPointer * waiters,
+                   void (*delegate)(void*,
+                                    void (*funPtr)(unsigned int, void *),
+                                    unsigned int messageSize,
+                                    void * messageAddress),
+                   bool (*predicate)(void *),
+                   void * arg);
+
+// Used for lock types without waiter stacks. Takes the lock and
+// evaluates the predicate until it is satisfied.
+void ll_wait_until_polling(void * lock,
+                           void (*lockFun)(void*),
+                           void (*unlockFun)(void*),
+                           bool (*predicate)(void *),
+                           void * arg);
+
+#endif
@@ -0,0 +1,41 @@
+#include "asymmetric_fence.h"
+
+#if defined(__linux__) && !defined(LL_NO_MEMBARRIER)
+#    include <linux/membarrier.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    define LL_HAS_MEMBARRIER 1
+#endif
+
+volatile atomic_int llAsymmetricFenceState =
+    ATOMIC_VAR_INIT(LL_ASYMMETRIC_FENCE_UNKNOWN);
+
+
+bool ll_asymmetric_fence_initialize(){
+    int state = atomic_load_explicit(&llAsymmetricFenceState, memory_order_acquire);
+    if(state != LL_ASYMMETRIC_FENCE_UNKNOWN){
+        return state == LL_ASYMMETRIC_FENCE_AVAILABLE;
+    }
+    state = LL_ASYMMETRIC_FENCE_UNAVAILABLE;
+#ifdef LL_HAS_MEMBARRIER
+    long supported = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    if(supported > 0 &&
+       (supported & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+       syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0){
+        state = LL_ASYMMETRIC_FENCE_AVAILABLE;
+    }
+#endif
+    atomic_store_explicit(&llAsymmetricFenceState, state, memory_order_release);
+    return state == LL_ASYMMETRIC_FENCE_AVAILABLE;
+}
+
+
+void ll_heavy_fence(){
+#ifdef LL_HAS_MEMBARRIER
+    if(ll_asymmetric_fence_initialize()){
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+        return;
+    }
+#endif
+    atomic_thread_fence(memory_order_seq_cst);
+}
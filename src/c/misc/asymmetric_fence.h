@@ -0,0 +1,46 @@
+#ifndef ASYMMETRIC_FENCE_H
+#define ASYMMETRIC_FENCE_H
+
+#include <stdbool.h>
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+
+/* Asymmetric fences */
+
+// An asymmetric fence pair orders a store before a following load in
+// the same way as a pair of sequentially consistent fences, but moves
+// almost all of the cost to one side. ll_light_fence is used on the
+// fast path and only prevents compiler reordering.
+// ll_heavy_fence is used on the slow path. It uses the Linux membarrier
+// system call to force a full memory barrier on every running thread
+// of the process.
+//
+// If membarrier is not available, both fences fall back to
+// atomic_thread_fence(memory_order_seq_cst). The fallback can be forced
+// by defining LL_NO_MEMBARRIER when compiling asymmetric_fence.c.
+
+#define LL_ASYMMETRIC_FENCE_UNKNOWN 0
+#define LL_ASYMMETRIC_FENCE_AVAILABLE 1
+#define LL_ASYMMETRIC_FENCE_UNAVAILABLE 2
+
+extern volatile atomic_int llAsymmetricFenceState;
+
+// Registers the process for expedited membarriers. Has to be called
+// before the fences are used. The call is cheap after the first one.
+// Returns true if the light fence is only a compiler barrier.
+bool ll_asymmetric_fence_initialize();
+
+// Initializes the fences if needed so a heavy fence is never weaker
+// than a light fence executed concurrently by another thread
+void ll_heavy_fence();
+
+static inline void ll_light_fence(){
+    if(atomic_load_explicit(&llAsymmetricFenceState, memory_order_relaxed) ==
+       LL_ASYMMETRIC_FENCE_AVAILABLE){
+        atomic_signal_fence(memory_order_seq_cst);
+    }else{
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+#endif
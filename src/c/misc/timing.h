@@ -0,0 +1,25 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+/* Monotonic time helpers used by the timed lock operations. All
+   values are in nanoseconds. */
+
+static inline uint64_t ll_now_nanos(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec) * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t ll_deadline_from_timeout(uint64_t timeoutNanos){
+    return ll_now_nanos() + timeoutNanos;
+}
+
+static inline bool ll_deadline_passed(uint64_t deadline){
+    return ll_now_nanos() >= deadline;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#include "actor.h"
+
+#include "misc/error_help.h"
+
+static _Thread_local LLActor * llCurrentActor = NULL;
+
+LLActor * ll_actor_self(){
+    return llCurrentActor;
+}
+
+void * ll_actor_state(){
+    return llCurrentActor->state;
+}
+
+static void * ll_actor_thread(void * actorPtr){
+    LLActor * actor = (LLActor *)actorPtr;
+    llCurrentActor = actor;
+    while(!actor->stopped){
+        ll_mailbox_drain_wait(&actor->mailbox, LL_ACTOR_BATCH_SIZE);
+    }
+    return NULL;
+}
+
+LLActor * ll_actor_create(void * state){
+    LLActor * actor = aligned_alloc(CACHE_LINE_SIZE, sizeof(LLActor));
+    ll_mailbox_initialize(&actor->mailbox);
+    actor->state = state;
+    actor->stopped = false;
+    if(pthread_create(&actor->thread, NULL, &ll_actor_thread, actor) != 0){
+        LL_error_and_exit("Could not start the thread of an actor\n");
+    }
+    return actor;
+}
+
+static void ll_actor_stop_message(unsigned int messageSize, void * messageAddress){
+    (void)messageSize;
+    (void)messageAddress;
+    ll_actor_self()->stopped = true;
+}
+
+void * ll_actor_stop(LLActor * actor){
+    ll_actor_send(actor, ll_actor_stop_message, 0, NULL);
+    pthread_join(actor->thread, NULL);
+    void * state = actor->state;
+    ll_mailbox_destroy(&actor->mailbox);
+    free(actor);
+    return state;
+}
@@ -0,0 +1,69 @@
+#ifndef ACTOR_H
+#define ACTOR_H
+
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "qd_queues/mailbox.h"
+
+/* Actors */
+
+// An actor owns a state and a mailbox (see qd_queues/mailbox.h) and
+// has a thread that executes the messages sent to the mailbox one at a
+// time. A message is a function and a message in the delegation
+// format. The function gets the state of the actor with
+// ll_actor_state(), so the state is only accessed by the thread of the
+// actor and needs no locking:
+//
+//     void add(unsigned int messageSize, void * messageAddress){
+//         Counter * counter = ll_actor_state();
+//         counter->value += *(long *)messageAddress;
+//     }
+//     ...
+//     LLActor * actor = ll_actor_create(counter);
+//     long amount = 2;
+//     ll_actor_send(actor, add, sizeof(amount), &amount);
+//
+// The thread of an idle actor sleeps until a message is sent to it.
+
+#ifndef LL_ACTOR_BATCH_SIZE
+#    define LL_ACTOR_BATCH_SIZE 64
+#endif
+
+typedef struct {
+    LLMailbox mailbox;
+    void * state;
+    pthread_t thread;
+    bool stopped; //Only accessed by the thread of the actor
+} LLActor;
+
+LLActor * ll_actor_create(void * state);
+
+static inline
+void ll_actor_send(LLActor * actor,
+                   void (*funPtr)(unsigned int, void *),
+                   unsigned int messageSize,
+                   void * messageAddress){
+    ll_mailbox_send(&actor->mailbox, funPtr, messageSize, messageAddress);
+}
+
+static inline
+bool ll_actor_try_send(LLActor * actor,
+                       void (*funPtr)(unsigned int, void *),
+                       unsigned int messageSize,
+                       void * messageAddress){
+    return ll_mailbox_try_send(&actor->mailbox, funPtr, messageSize, messageAddress);
+}
+
+// The actor whose message the calling thread executes or NULL
+LLActor * ll_actor_self();
+
+// The state of ll_actor_self()
+void * ll_actor_state();
+
+// Executes the messages that have been sent to the actor, stops its
+// thread, frees the actor and returns its state. No messages may be
+// sent to the actor after this has been called.
+void * ll_actor_stop(LLActor * actor);
+
+#endif
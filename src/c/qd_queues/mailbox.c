@@ -0,0 +1,79 @@
+#include "mailbox.h"
+
+#include "misc/error_help.h"
+
+void ll_mailbox_initialize(LLMailbox * mailbox){
+    qdq_initialize(&mailbox->queue);
+    qdq_open(&mailbox->queue);
+    mailbox->done = 0;
+    atomic_store(&mailbox->sleeping.value, false);
+    if(pthread_mutex_init(&mailbox->sleepMutex, NULL) != 0 ||
+       pthread_cond_init(&mailbox->sleepCondition, NULL) != 0){
+        LL_error_and_exit("Could not initialize a mailbox\n");
+    }
+}
+
+void ll_mailbox_destroy(LLMailbox * mailbox){
+    pthread_mutex_destroy(&mailbox->sleepMutex);
+    pthread_cond_destroy(&mailbox->sleepCondition);
+}
+
+LLMailbox * ll_mailbox_create(){
+    LLMailbox * mailbox = aligned_alloc(CACHE_LINE_SIZE, sizeof(LLMailbox));
+    ll_mailbox_initialize(mailbox);
+    return mailbox;
+}
+
+void ll_mailbox_free(LLMailbox * mailbox){
+    ll_mailbox_destroy(mailbox);
+    free(mailbox);
+}
+
+void ll_mailbox_wake_slow(LLMailbox * mailbox){
+    pthread_mutex_lock(&mailbox->sleepMutex);
+    atomic_store_explicit(&mailbox->sleeping.value, false, memory_order_relaxed);
+    pthread_cond_signal(&mailbox->sleepCondition);
+    pthread_mutex_unlock(&mailbox->sleepMutex);
+}
+
+unsigned long ll_mailbox_drain(LLMailbox * mailbox, unsigned long maxMessages){
+    unsigned long executed = qdq_flush_available(&mailbox->queue,
+                                                 &mailbox->done,
+                                                 maxMessages);
+    if(mailbox->done == QD_QUEUE_BUFFER_SIZE){
+        // The queue was full and all messages in it have been executed
+        mailbox->done = 0;
+        qdq_open(&mailbox->queue);
+    }
+    return executed;
+}
+
+// True if a message has been added (or is being added) after the
+// messages that the consumer has executed
+static inline bool ll_mailbox_has_messages(LLMailbox * mailbox){
+    return atomic_load_explicit(&mailbox->queue.counter.value, memory_order_seq_cst) !=
+        mailbox->done;
+}
+
+unsigned long ll_mailbox_drain_wait(LLMailbox * mailbox, unsigned long maxMessages){
+    unsigned int spins = 0;
+    while(true){
+        unsigned long executed = ll_mailbox_drain(mailbox, maxMessages);
+        if(executed > 0){
+            return executed;
+        }else if(spins < LL_MAILBOX_IDLE_SPINS){
+            spins = spins + 1;
+            thread_yield();
+            continue;
+        }
+        pthread_mutex_lock(&mailbox->sleepMutex);
+        atomic_store_explicit(&mailbox->sleeping.value, true, memory_order_seq_cst);
+        while(atomic_load_explicit(&mailbox->sleeping.value, memory_order_relaxed) &&
+              !ll_mailbox_has_messages(mailbox)){
+            pthread_cond_wait(&mailbox->sleepCondition, &mailbox->sleepMutex);
+        }
+        atomic_store_explicit(&mailbox->sleeping.value, false, memory_order_relaxed);
+        pthread_mutex_unlock(&mailbox->sleepMutex);
+        spins = 0;
+    }
+}
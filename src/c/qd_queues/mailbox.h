@@ -0,0 +1,84 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/thread_includes.h"//Until c11 thread.h is available
+#include <stdbool.h>
+
+#include "misc/padded_types.h"
+#include "qd_queues/qd_queue.h"
+
+/* Mailbox */
+
+// A multi producer single consumer mailbox built on the queue of the
+// QD locks. Producers send messages in the delegation format, a
+// function and a message that is copied into the queue, and the
+// consumer executes them in the order they were added to the queue.
+// No memory is allocated per message.
+//
+// Unlike in the QD locks the queue stays open while the consumer
+// drains it. It is only closed when it is full, and the consumer opens
+// it again when the messages in it have been executed. Senders retry
+// until the queue is open again.
+//
+// A consumer that finds the mailbox empty spins for
+// LL_MAILBOX_IDLE_SPINS rounds and then goes to sleep on a condition
+// variable. It announces that it sleeps in a flag that the senders
+// check after they have added a message, so a sender only takes the
+// mutex of the mailbox when it has to wake up the consumer.
+
+#ifndef LL_MAILBOX_IDLE_SPINS
+#    define LL_MAILBOX_IDLE_SPINS 128
+#endif
+
+typedef struct {
+    QDQueue queue;
+    LLPaddedBool sleeping;
+    // Only accessed by the consumer
+    unsigned long done;
+    pthread_mutex_t sleepMutex;
+    pthread_cond_t sleepCondition;
+} LLMailbox;
+
+void ll_mailbox_initialize(LLMailbox * mailbox);
+void ll_mailbox_destroy(LLMailbox * mailbox);
+LLMailbox * ll_mailbox_create();
+void ll_mailbox_free(LLMailbox * mailbox);
+
+void ll_mailbox_wake_slow(LLMailbox * mailbox);
+
+// Fails if the mailbox is full
+static inline
+bool ll_mailbox_try_send(LLMailbox * mailbox,
+                         void (*funPtr)(unsigned int, void *),
+                         unsigned int messageSize,
+                         void * messageAddress){
+    if(!qdq_enqueue(&mailbox->queue, funPtr, messageSize, messageAddress)){
+        return false;
+    }
+    if(atomic_load_explicit(&mailbox->sleeping.value, memory_order_seq_cst)){
+        ll_mailbox_wake_slow(mailbox);
+    }
+    return true;
+}
+
+// Waits until there is room in the mailbox
+static inline
+void ll_mailbox_send(LLMailbox * mailbox,
+                     void (*funPtr)(unsigned int, void *),
+                     unsigned int messageSize,
+                     void * messageAddress){
+    while(!ll_mailbox_try_send(mailbox, funPtr, messageSize, messageAddress)){
+        thread_yield();
+    }
+}
+
+// Executes at most maxMessages of the messages in the mailbox. Returns
+// the number of executed messages. Must only be called by the
+// consumer.
+unsigned long ll_mailbox_drain(LLMailbox * mailbox, unsigned long maxMessages);
+
+// Like ll_mailbox_drain but waits until there is at least one message
+unsigned long ll_mailbox_drain_wait(LLMailbox * mailbox, unsigned long maxMessages);
+
+#endif
@@ -132,7 +132,10 @@ static inline bool qdq_enqueue(QDQueue* q,
 
 #include <stdlib.h>
 #include <stdio.h>
-static inline void qdq_flush(QDQueue* q) {
+/* Executes the requests in the queue and closes it. Returns the
+   number of executed requests. */
+static inline unsigned long qdq_flush(QDQueue* q) {
+    unsigned long executed = 0;
     unsigned long todo = 0;
     bool open = true;
     while(open) {
@@ -170,7 +173,7 @@ static inline void qdq_flush(QDQueue* q) {
                 atomic_store_explicit( &reqId->requestIdentifier,
                                        QD_QUEUE_EMPTY_POS,
                                        memory_order_relaxed );
-                return; /* Too big, we can return */
+                return executed; /* Too big, we can return */
             }
             funPtr = (void (*)(unsigned int, void *))funPtrValue;
             unsigned int messageSize = reqId->messageSize;
@@ -180,6 +183,7 @@ static inline void qdq_flush(QDQueue* q) {
             unsigned int nextReqOffset = messageEndOffset + pad;
             void * messageAddress = q->buffer + sizeof(QDRequestRequestId) + index;
             funPtr(messageSize, messageAddress);           
+            executed = executed + 1;
             for(unsigned int i = index; i < messageEndOffset; i = i + sizeof(uintptr_t)){
                 volatile atomic_uintptr_t * ptr = (void*)&q->buffer[i];
                 atomic_store_explicit(ptr,
@@ -189,6 +193,78 @@ static inline void qdq_flush(QDQueue* q) {
             index = nextReqOffset;
         }
     }
+    return executed;
+}
+
+/* Executes at most maxRequests of the requests that are in the queue
+   without closing it. *done is the offset of the next request and has
+   to be 0 after qdq_open. *done is set to QD_QUEUE_BUFFER_SIZE when
+   the queue is closed because it is full. Returns the number of
+   executed requests. */
+static inline unsigned long qdq_flush_available(QDQueue* q,
+                                                unsigned long * done,
+                                                unsigned long maxRequests) {
+    unsigned long executed = 0;
+    unsigned long todo = atomic_load_explicit( &q->counter.value, memory_order_relaxed );
+    if(todo >= QD_QUEUE_BUFFER_SIZE) { /* queue full */
+        todo = QD_QUEUE_BUFFER_SIZE;
+        atomic_store_explicit( &q->closed.value,
+                               true,
+                               memory_order_relaxed );
+    }
+    unsigned long index = *done;
+    while( index < todo && executed < maxRequests ) {
+        QDRequestRequestId * reqId =
+            (QDRequestRequestId*)&q->buffer[index];
+        uintptr_t funPtrValue;
+        while(QD_QUEUE_EMPTY_POS ==
+              (funPtrValue = atomic_load_explicit( &reqId->requestIdentifier,
+                                                   memory_order_acquire ))){
+            /* spin wait */
+            atomic_thread_fence(memory_order_seq_cst);/*hw threads*/
+        }
+        if(funPtrValue == QD_QUEUE_EMPTY_POS_FULL){
+            atomic_store_explicit( &reqId->requestIdentifier,
+                                   QD_QUEUE_EMPTY_POS,
+                                   memory_order_relaxed );
+            *done = QD_QUEUE_BUFFER_SIZE;
+            return executed;
+        }
+        void (*funPtr)(unsigned int, void *) =
+            (void (*)(unsigned int, void *))funPtrValue;
+        unsigned int messageSize = reqId->messageSize;
+        unsigned int storeSize = sizeof(QDRequestRequestId) + messageSize;
+        unsigned int messageEndOffset = index + storeSize;
+        unsigned int pad = QDQ_CALCULATE_PAD(storeSize);
+        void * messageAddress = q->buffer + sizeof(QDRequestRequestId) + index;
+        funPtr(messageSize, messageAddress);
+        executed = executed + 1;
+        for(unsigned int i = index; i < messageEndOffset; i = i + sizeof(uintptr_t)){
+            volatile atomic_uintptr_t * ptr = (void*)&q->buffer[i];
+            atomic_store_explicit(ptr,
+                                  QD_QUEUE_EMPTY_POS,
+                                  memory_order_relaxed);
+        }
+        index = messageEndOffset + pad;
+    }
+    *done = index;
+    return executed;
+}
+
+/* Closes the queue if no request has been enqueued after offset done.
+   Sets done to QD_QUEUE_BUFFER_SIZE if the queue was closed. */
+static inline bool qdq_try_close(QDQueue* q, unsigned long * done) {
+    unsigned long todo = *done;
+    if(atomic_compare_exchange_strong( &q->counter.value,
+                                       &todo,
+                                       QD_QUEUE_BUFFER_SIZE)) {
+        atomic_store_explicit( &q->closed.value,
+                               true,
+                               memory_order_relaxed );
+        *done = QD_QUEUE_BUFFER_SIZE;
+        return true;
+    }
+    return false;
 }
 
 #endif
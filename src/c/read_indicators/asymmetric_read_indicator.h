@@ -0,0 +1,106 @@
+#ifndef ASYMMETRIC_READ_INDICATOR_H
+#define ASYMMETRIC_READ_INDICATOR_H
+
+#include "misc/thread_includes.h"
+#include "misc/padded_types.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+#include "misc/asymmetric_fence.h"
+#include "read_indicators/reader_groups_read_indicator.h"
+#include <stdbool.h>
+
+/* Asymmetric Read Indicator */
+
+// A read indicator for read dominated locks. Each of the first
+// ASYMMETRIC_READ_INDICATOR_SLOTS threads (by thread id) has its own
+// slot, which only that thread writes. A reader publishes its arrival
+// with a plain store followed by a light fence (a compiler barrier),
+// so it does not need an atomic read-modify-write or a hardware fence.
+// A writer issues a heavy fence (membarrier) before it scans the
+// slots. The heavy fence orders the readers' stores before their
+// following loads, so a reader either sees the writer or is seen by
+// it.
+//
+// Threads with higher ids share an overflow counter that is updated
+// with atomic operations. Thread ids are never reused, so a program
+// that keeps creating new reader threads will eventually only use the
+// overflow counter.
+
+#ifndef ASYMMETRIC_READ_INDICATOR_SLOTS
+#    define ASYMMETRIC_READ_INDICATOR_SLOTS 64
+#endif
+
+typedef struct {
+    LLPaddedULong overflow;
+    LLPaddedULong slots[ASYMMETRIC_READ_INDICATOR_SLOTS];
+} AsymmetricReadIndicator;
+
+static inline
+void asymmetric_initialize(AsymmetricReadIndicator * indicator){
+    atomic_store(&indicator->overflow.value, 0);
+    for(int i = 0; i < ASYMMETRIC_READ_INDICATOR_SLOTS; i++){
+        atomic_store(&indicator->slots[i].value, 0);
+    }
+    ll_asymmetric_fence_initialize();
+}
+
+static inline
+void ari_arrive(AsymmetricReadIndicator * indicator){
+    int id = rgri_get_thread_id();
+    if(id < ASYMMETRIC_READ_INDICATOR_SLOTS){
+        volatile atomic_ulong * slot = &indicator->slots[id].value;
+        atomic_store_explicit(slot,
+                              atomic_load_explicit(slot, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        ll_light_fence();
+    }else{
+        atomic_fetch_add(&indicator->overflow.value, 1);
+    }
+}
+
+static inline
+void ari_depart(AsymmetricReadIndicator * indicator){
+    int id = rgri_get_thread_id();
+    if(id < ASYMMETRIC_READ_INDICATOR_SLOTS){
+        volatile atomic_ulong * slot = &indicator->slots[id].value;
+        atomic_store_explicit(slot,
+                              atomic_load_explicit(slot, memory_order_relaxed) - 1,
+                              memory_order_release);
+    }else{
+        atomic_fetch_sub_explicit(&indicator->overflow.value, 1, memory_order_release);
+    }
+}
+
+/* Only the slots of thread ids that have been handed out are
+   scanned */
+static inline
+bool ari_wait_all_readers_gone_until(AsymmetricReadIndicator * indicator,
+                                     uint64_t deadline){
+    ll_heavy_fence();
+    int usedSlots = atomic_load(&rgri_get_thread_id_counter);
+    if(usedSlots > ASYMMETRIC_READ_INDICATOR_SLOTS){
+        usedSlots = ASYMMETRIC_READ_INDICATOR_SLOTS;
+    }
+    for(int i = 0; i < usedSlots; i++){
+        while(0 < atomic_load_explicit(&indicator->slots[i].value, memory_order_acquire)){
+            if(ll_deadline_passed(deadline)){
+                return false;
+            }
+            thread_yield();
+        }
+    }
+    while(0 < atomic_load_explicit(&indicator->overflow.value, memory_order_acquire)){
+        if(ll_deadline_passed(deadline)){
+            return false;
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+static inline
+void ari_wait_all_readers_gone(AsymmetricReadIndicator * indicator){
+    ari_wait_all_readers_gone_until(indicator, UINT64_MAX);
+}
+
+#endif
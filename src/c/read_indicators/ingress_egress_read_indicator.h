@@ -0,0 +1,65 @@
+#ifndef INGRESS_EGRESS_READ_INDICATOR_H
+#define INGRESS_EGRESS_READ_INDICATOR_H
+
+#include "misc/thread_includes.h"
+#include "misc/padded_types.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+#include <stdbool.h>
+
+/* Ingress/Egress Read Indicator */
+
+// Readers increment the ingress counter when they arrive and the
+// egress counter when they depart. The two counters are on separate
+// cache lines so arrivals and departures do not contend with each
+// other. There are no readers when the counters are equal, so a writer
+// reads two cache lines. Arrivals by all threads go to the same cache
+// line, so this indicator suits locks with few concurrent readers.
+
+typedef struct {
+    LLPaddedULong ingress;
+    LLPaddedULong egress;
+} IngressEgressReadIndicator;
+
+static inline
+void ingress_egress_initialize(IngressEgressReadIndicator * indicator){
+    atomic_store(&indicator->ingress.value, 0);
+    atomic_store(&indicator->egress.value, 0);
+}
+
+static inline
+void ieri_arrive(IngressEgressReadIndicator * indicator){
+    atomic_fetch_add(&indicator->ingress.value, 1);
+}
+
+static inline
+void ieri_depart(IngressEgressReadIndicator * indicator){
+    atomic_fetch_add_explicit(&indicator->egress.value, 1, memory_order_release);
+}
+
+/* The egress counter is read before the ingress counter. Egress can
+   never be larger than ingress, so equal values mean that there were
+   no readers when ingress was read. */
+static inline
+bool ieri_wait_all_readers_gone_until(IngressEgressReadIndicator * indicator,
+                                      uint64_t deadline){
+    atomic_thread_fence(memory_order_seq_cst);
+    while(true){
+        unsigned long egress = atomic_load_explicit(&indicator->egress.value, memory_order_acquire);
+        unsigned long ingress = atomic_load(&indicator->ingress.value);
+        if(egress == ingress){
+            return true;
+        }
+        if(ll_deadline_passed(deadline)){
+            return false;
+        }
+        thread_yield();
+    }
+}
+
+static inline
+void ieri_wait_all_readers_gone(IngressEgressReadIndicator * indicator){
+    ieri_wait_all_readers_gone_until(indicator, UINT64_MAX);
+}
+
+#endif
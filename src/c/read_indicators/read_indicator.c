@@ -0,0 +1,73 @@
+#include "read_indicator.h"
+
+static size_t ri_indicator_size(LL_read_indicator_type type, int width){
+    if(READER_GROUPS_READ_INDICATOR == type ||
+       PER_CPU_READER_GROUPS_READ_INDICATOR == type){
+        return reader_groups_size(width);
+    }else if(SNZI_READ_INDICATOR == type){
+        return sizeof(SNZIReadIndicator);
+    }else if(INGRESS_EGRESS_READ_INDICATOR == type){
+        return sizeof(IngressEgressReadIndicator);
+    }else if(ASYMMETRIC_READ_INDICATOR == type){
+        return sizeof(AsymmetricReadIndicator);
+    }
+    LL_error_and_exit("Read indicator type not supported\n");
+    return 0;/* Should not be reachable */
+}
+
+void ri_initialize(ReadIndicator * readIndicator, LL_read_indicator_type type){
+    ri_initialize_with_width(readIndicator, type, MRQD_LOCK_NUMBER_OF_READER_GROUPS);
+}
+
+void ri_initialize_with_width(ReadIndicator * readIndicator,
+                              LL_read_indicator_type type,
+                              int width){
+    if(!reader_groups_valid_width(width)){
+        LL_error_and_exit("The read indicator width has to be a power of two not larger than MRQD_LOCK_NUMBER_OF_READER_GROUPS\n");
+    }
+    void * indicator = aligned_alloc(CACHE_LINE_SIZE, ri_indicator_size(type, width));
+    if(READER_GROUPS_READ_INDICATOR == type){
+        reader_groups_initialize_with_mode(indicator, MRQD_LOCK_READER_GROUP_MODE, width);
+    }else if(PER_CPU_READER_GROUPS_READ_INDICATOR == type){
+        reader_groups_initialize_with_mode(indicator, RGRI_GROUP_BY_CPU, width);
+    }else if(SNZI_READ_INDICATOR == type){
+        snzi_initialize(indicator);
+    }else if(INGRESS_EGRESS_READ_INDICATOR == type){
+        ingress_egress_initialize(indicator);
+    }else if(ASYMMETRIC_READ_INDICATOR == type){
+        asymmetric_initialize(indicator);
+    }
+    readIndicator->type = type;
+    readIndicator->owned = true;
+    readIndicator->indicator = indicator;
+}
+
+void ri_initialize_shared(ReadIndicator * readIndicator, ReadIndicator * shared){
+    if(READER_GROUPS_READ_INDICATOR == shared->type ||
+       PER_CPU_READER_GROUPS_READ_INDICATOR == shared->type){
+        ReaderGroupsReadIndicator * indicator = shared->indicator;
+        indicator->summary.shared = true;
+    }
+    readIndicator->type = shared->type;
+    readIndicator->owned = false;
+    readIndicator->indicator = shared->indicator;
+}
+
+void ri_destroy(ReadIndicator * readIndicator){
+    if(readIndicator->owned){
+        free(readIndicator->indicator);
+    }
+    readIndicator->indicator = NULL;
+}
+
+size_t ri_allocated_size(ReadIndicator * readIndicator){
+    if(!readIndicator->owned){
+        return 0;
+    }
+    if(READER_GROUPS_READ_INDICATOR == readIndicator->type ||
+       PER_CPU_READER_GROUPS_READ_INDICATOR == readIndicator->type){
+        ReaderGroupsReadIndicator * indicator = readIndicator->indicator;
+        return reader_groups_size(indicator->summary.groupMask + 1);
+    }
+    return ri_indicator_size(readIndicator->type, 0);
+}
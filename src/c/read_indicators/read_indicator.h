@@ -0,0 +1,148 @@
+#ifndef READ_INDICATOR_H
+#define READ_INDICATOR_H
+
+#include "misc/padded_types.h"
+#include "misc/error_help.h"
+#include "read_indicators/reader_groups_read_indicator.h"
+#include "read_indicators/snzi_read_indicator.h"
+#include "read_indicators/ingress_egress_read_indicator.h"
+#include "read_indicators/asymmetric_read_indicator.h"
+#include <stdbool.h>
+
+/* Read Indicator Interface */
+
+// The reader-writer locks (MRQD and DR-MCS) use a read indicator to
+// track the readers that are inside the lock. The implementations
+// trade reader cost against writer scan cost differently:
+
+// * `READER_GROUPS_READ_INDICATOR` - one counter per reader group,
+//   indexed by thread id. Cheap arrivals, writers check the groups
+//   marked in an occupancy summary.
+// * `PER_CPU_READER_GROUPS_READ_INDICATOR` - reader groups indexed by
+//   the CPU the reader is running on.
+// * `SNZI_READ_INDICATOR` - a scalable nonzero indicator. Arrivals
+//   cost more, writers read a single cache line.
+// * `INGRESS_EGRESS_READ_INDICATOR` - one arrival and one departure
+//   counter. Writers read two cache lines, arrivals contend on one.
+// * `ASYMMETRIC_READ_INDICATOR` - one slot per thread written with
+//   plain stores. Arrivals need no atomic instruction or hardware
+//   fence, writers issue a membarrier and scan one line per thread.
+//   Meant for locks that are almost only read locked.
+
+// The type is selected per lock when the lock is initialized.
+
+// The width of the reader group indicators (the number of groups) can
+// also be selected per lock. Each group takes a cache line, so narrow
+// indicators save memory when there are many locks, at the cost of
+// readers sharing groups.
+
+// Several locks can also share one indicator. A writer of any of the
+// locks then waits for the readers of all of them. A thread must
+// therefore not hold a read lock on one of the locks while it tries
+// to take a read lock on another one, since a writer of the second
+// lock would wait for the first read lock forever.
+
+typedef enum {
+    READER_GROUPS_READ_INDICATOR,
+    PER_CPU_READER_GROUPS_READ_INDICATOR,
+    SNZI_READ_INDICATOR,
+    INGRESS_EGRESS_READ_INDICATOR,
+    ASYMMETRIC_READ_INDICATOR
+} LL_read_indicator_type;
+
+typedef union {
+    struct {
+        LL_read_indicator_type type;
+        // False if the indicator is shared with another ReadIndicator
+        bool owned;
+        void * indicator;
+    };
+    char pad[CACHE_LINE_SIZE];
+} ReadIndicator;
+
+// Allocates and initializes a read indicator of the given type
+void ri_initialize(ReadIndicator * readIndicator, LL_read_indicator_type type);
+// Like ri_initialize but with width reader groups for the reader group
+// types. width has to be a power of two not larger than
+// MRQD_LOCK_NUMBER_OF_READER_GROUPS. Other types ignore the width.
+void ri_initialize_with_width(ReadIndicator * readIndicator,
+                              LL_read_indicator_type type,
+                              int width);
+// Makes readIndicator use the indicator of shared. shared has to be
+// destroyed after all indicators that share it. Has to be called
+// before any of the locks that use the indicators is used.
+void ri_initialize_shared(ReadIndicator * readIndicator, ReadIndicator * shared);
+// Frees the memory allocated by ri_initialize. Shared indicators are
+// not freed.
+void ri_destroy(ReadIndicator * readIndicator);
+// The number of bytes allocated by ri_initialize, 0 for shared
+// indicators
+size_t ri_allocated_size(ReadIndicator * readIndicator);
+
+static inline
+void ri_arrive(ReadIndicator * readIndicator){
+    switch(readIndicator->type){
+    case SNZI_READ_INDICATOR:
+        snziri_arrive(readIndicator->indicator);
+        break;
+    case INGRESS_EGRESS_READ_INDICATOR:
+        ieri_arrive(readIndicator->indicator);
+        break;
+    case ASYMMETRIC_READ_INDICATOR:
+        ari_arrive(readIndicator->indicator);
+        break;
+    default:
+        rgri_arrive(readIndicator->indicator);
+    }
+}
+
+static inline
+void ri_depart(ReadIndicator * readIndicator){
+    switch(readIndicator->type){
+    case SNZI_READ_INDICATOR:
+        snziri_depart(readIndicator->indicator);
+        break;
+    case INGRESS_EGRESS_READ_INDICATOR:
+        ieri_depart(readIndicator->indicator);
+        break;
+    case ASYMMETRIC_READ_INDICATOR:
+        ari_depart(readIndicator->indicator);
+        break;
+    default:
+        rgri_depart(readIndicator->indicator);
+    }
+}
+
+static inline
+bool ri_wait_all_readers_gone_until(ReadIndicator * readIndicator,
+                                    uint64_t deadline){
+    switch(readIndicator->type){
+    case SNZI_READ_INDICATOR:
+        return snziri_wait_all_readers_gone_until(readIndicator->indicator, deadline);
+    case INGRESS_EGRESS_READ_INDICATOR:
+        return ieri_wait_all_readers_gone_until(readIndicator->indicator, deadline);
+    case ASYMMETRIC_READ_INDICATOR:
+        return ari_wait_all_readers_gone_until(readIndicator->indicator, deadline);
+    default:
+        return rgri_wait_all_readers_gone_until(readIndicator->indicator, deadline);
+    }
+}
+
+static inline
+void ri_wait_all_readers_gone(ReadIndicator * readIndicator){
+    switch(readIndicator->type){
+    case SNZI_READ_INDICATOR:
+        snziri_wait_all_readers_gone(readIndicator->indicator);
+        break;
+    case INGRESS_EGRESS_READ_INDICATOR:
+        ieri_wait_all_readers_gone(readIndicator->indicator);
+        break;
+    case ASYMMETRIC_READ_INDICATOR:
+        ari_wait_all_readers_gone(readIndicator->indicator);
+        break;
+    default:
+        rgri_wait_all_readers_gone(readIndicator->indicator);
+    }
+}
+
+#endif
@@ -1,6 +1,17 @@
+#define _GNU_SOURCE //For sched_getcpu
 #include "reader_groups_read_indicator.h"
 
 volatile atomic_int rgri_get_thread_id_counter = ATOMIC_VAR_INIT(0);
 
 _Alignas(CACHE_LINE_SIZE)
 _Thread_local RGRIGetThreadIDVarWrapper rgri_get_thread_id_var = {.value = -1};
+
+_Thread_local RGRICPUArrivals rgri_cpu_arrivals;
+
+int rgri_get_cpu(){
+    int cpu = sched_getcpu();
+    if(cpu < 0){
+        return rgri_get_thread_id();
+    }
+    return cpu;
+}
@@ -4,6 +4,9 @@
 #include "misc/thread_includes.h"
 #include "misc/padded_types.h"
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+#include "misc/error_help.h"
+#include <stdbool.h>
 
 /* Read Indicator */
 
@@ -14,15 +17,92 @@
 //Warning this will not work when using more threads than reader groups
 // #define MRQD_LOCK_READER_GROUP_PER_THREAD 1
 
+// Reader group modes. In the thread mode a reader always uses the
+// group given by its thread id. In the CPU mode a reader uses the
+// group of the CPU it is running on when it arrives, so readers on
+// the same core share a cache line and readers on different cores do
+// not. A reader can migrate before it departs, so the group used at
+// arrival is remembered in a thread local table and used at departure.
+
+#define RGRI_GROUP_BY_THREAD 0
+#define RGRI_GROUP_BY_CPU 1
+
+#ifndef MRQD_LOCK_READER_GROUP_MODE
+#    define MRQD_LOCK_READER_GROUP_MODE RGRI_GROUP_BY_THREAD
+#endif
+
+// Max number of read indicators a thread can have arrived at at the
+// same time in the CPU mode
+#ifndef RGRI_MAX_NESTED_CPU_ARRIVALS
+#    define RGRI_MAX_NESTED_CPU_ARRIVALS 16
+#endif
+
+// The occupancy summary has one bit per reader group. A bit is set by
+// the first reader that finds it cleared after arriving in the group
+// and is cleared by writers that find the group empty. A writer only
+// has to check the groups with a set bit, so the common case without
+// readers costs one cache line instead of one line per group.
+//
+// Clearing a bit is only safe when all writers that scan the indicator
+// belong to the same lock. When several locks share the indicator (see
+// ri_initialize_shared), a reader of one lock can skip setting a bit
+// that a writer of another lock is about to clear, and a later writer
+// of the first lock would then miss the reader. The bits of a shared
+// indicator are therefore never cleared.
+
+#define RGRI_BITS_PER_SUMMARY_WORD (sizeof(unsigned long) * 8)
+#define RGRI_NUMBER_OF_SUMMARY_WORDS \
+    ((MRQD_LOCK_NUMBER_OF_READER_GROUPS + RGRI_BITS_PER_SUMMARY_WORD - 1) / RGRI_BITS_PER_SUMMARY_WORD)
+
+// The number of reader groups is chosen when the indicator is
+// initialized. It has to be a power of two and at most
+// MRQD_LOCK_NUMBER_OF_READER_GROUPS. Fewer groups use less memory
+// (one cache line per group) but make readers share cache lines.
+
+_Static_assert((MRQD_LOCK_NUMBER_OF_READER_GROUPS & (MRQD_LOCK_NUMBER_OF_READER_GROUPS - 1)) == 0,
+               "MRQD_LOCK_NUMBER_OF_READER_GROUPS has to be a power of two");
+
+typedef union {
+    struct {
+        volatile atomic_ulong words[RGRI_NUMBER_OF_SUMMARY_WORDS];
+        int groupMode;
+        // The number of reader groups minus one
+        unsigned int groupMask;
+        // True if the indicator is used by more than one lock. Has to
+        // be set before the locks are used.
+        bool shared;
+    };
+    char pad[CACHE_LINE_SIZE];
+} RGRIOccupancySummary;
+
 typedef struct {
-    LLPaddedUInt readerGroups[MRQD_LOCK_NUMBER_OF_READER_GROUPS];
+    RGRIOccupancySummary summary;
+    LLPaddedUInt readerGroups[];
 } ReaderGroupsReadIndicator;
 
+// The size to allocate for an indicator with numberOfGroups groups
+static inline
+size_t reader_groups_size(int numberOfGroups){
+    return sizeof(ReaderGroupsReadIndicator) + numberOfGroups * sizeof(LLPaddedUInt);
+}
+
+static inline
+bool reader_groups_valid_width(int numberOfGroups){
+    return numberOfGroups > 0 &&
+        numberOfGroups <= MRQD_LOCK_NUMBER_OF_READER_GROUPS &&
+        (numberOfGroups & (numberOfGroups - 1)) == 0;
+}
+
 typedef union {
     int value;
     char pad[CACHE_LINE_SIZE];
 } RGRIGetThreadIDVarWrapper;
 
+typedef struct {
+    void * indicators[RGRI_MAX_NESTED_CPU_ARRIVALS];
+    int groups[RGRI_MAX_NESTED_CPU_ARRIVALS];
+} RGRICPUArrivals;
+
 
 
 extern volatile atomic_int rgri_get_thread_id_counter;
@@ -31,14 +111,42 @@ extern
 _Alignas(CACHE_LINE_SIZE)
 _Thread_local RGRIGetThreadIDVarWrapper rgri_get_thread_id_var;
 
+extern
+_Thread_local RGRICPUArrivals rgri_cpu_arrivals;
+
+// Returns the CPU the calling thread is running on. sched_getcpu reads
+// the CPU from the rseq area on glibc 2.35 and later. Falls back to the
+// thread id if the CPU can not be found.
+int rgri_get_cpu();
+
 
+/* readIndicator has to point to reader_groups_size(numberOfGroups)
+   bytes */
 static inline
-void reader_groups_initialize(ReaderGroupsReadIndicator * readIndicator){
-    for(int i = 0; i < MRQD_LOCK_NUMBER_OF_READER_GROUPS; i++){
+void reader_groups_initialize_with_mode(ReaderGroupsReadIndicator * readIndicator,
+                                        int groupMode,
+                                        int numberOfGroups){
+    if(!reader_groups_valid_width(numberOfGroups)){
+        LL_error_and_exit("The number of reader groups has to be a power of two not larger than MRQD_LOCK_NUMBER_OF_READER_GROUPS\n");
+    }
+    readIndicator->summary.groupMode = groupMode;
+    readIndicator->summary.groupMask = numberOfGroups - 1;
+    readIndicator->summary.shared = false;
+    for(unsigned int i = 0; i < RGRI_NUMBER_OF_SUMMARY_WORDS; i++){
+        atomic_store(&readIndicator->summary.words[i], 0);
+    }
+    for(int i = 0; i < numberOfGroups; i++){
         atomic_store(&readIndicator->readerGroups[i].value, 0);
     }
 }
 
+static inline
+void reader_groups_initialize(ReaderGroupsReadIndicator * readIndicator){
+    reader_groups_initialize_with_mode(readIndicator,
+                                       MRQD_LOCK_READER_GROUP_MODE,
+                                       MRQD_LOCK_NUMBER_OF_READER_GROUPS);
+}
+
 static inline
 int rgri_get_thread_id(){
     if(rgri_get_thread_id_var.value > -1) {
@@ -49,19 +157,68 @@ int rgri_get_thread_id(){
     }
 }
 
+/* Must be called after the arrival in the group is visible. The
+   summary is only written when the bit is not already set. */
+static inline
+void rgri_mark_group_occupied(ReaderGroupsReadIndicator * indicator, int index){
+    volatile atomic_ulong * word = &indicator->summary.words[index / RGRI_BITS_PER_SUMMARY_WORD];
+    unsigned long bit = 1ul << (index % RGRI_BITS_PER_SUMMARY_WORD);
+    if(!(atomic_load(word) & bit)){
+        atomic_fetch_or(word, bit);
+    }
+}
+
+/* Returns the group of a CPU mode reader and remembers it for the
+   departure */
+static inline
+int rgri_cpu_arrival_group(ReaderGroupsReadIndicator * indicator){
+    int index = rgri_get_cpu() & indicator->summary.groupMask;
+    for(int i = 0; i < RGRI_MAX_NESTED_CPU_ARRIVALS; i++){
+        if(rgri_cpu_arrivals.indicators[i] == NULL){
+            rgri_cpu_arrivals.indicators[i] = indicator;
+            rgri_cpu_arrivals.groups[i] = index;
+            return index;
+        }
+    }
+    LL_error_and_exit("Too many nested read locks, increase RGRI_MAX_NESTED_CPU_ARRIVALS\n");
+    return index;
+}
+
+static inline
+int rgri_cpu_departure_group(ReaderGroupsReadIndicator * indicator){
+    int i = 0;
+    while(rgri_cpu_arrivals.indicators[i] != indicator){
+        i = i + 1;
+    }
+    rgri_cpu_arrivals.indicators[i] = NULL;
+    return rgri_cpu_arrivals.groups[i];
+}
+
 static inline
 void rgri_arrive(ReaderGroupsReadIndicator * indicator){
-    int index = rgri_get_thread_id() % MRQD_LOCK_NUMBER_OF_READER_GROUPS;
+    int index;
+    if(indicator->summary.groupMode == RGRI_GROUP_BY_CPU){
+        index = rgri_cpu_arrival_group(indicator);
+        atomic_fetch_add(&indicator->readerGroups[index].value, 1);
+    }else{
+        index = rgri_get_thread_id() & indicator->summary.groupMask;
 #ifdef MRQD_LOCK_READER_GROUP_PER_THREAD
-    atomic_store(&indicator->readerGroups[index].value, 1);
+        atomic_store(&indicator->readerGroups[index].value, 1);
 #else
-    atomic_fetch_add(&indicator->readerGroups[index].value, 1);
+        atomic_fetch_add(&indicator->readerGroups[index].value, 1);
 #endif
+    }
+    rgri_mark_group_occupied(indicator, index);
 }
 
 static inline
 void rgri_depart(ReaderGroupsReadIndicator * indicator){
-    int index = rgri_get_thread_id() % MRQD_LOCK_NUMBER_OF_READER_GROUPS;
+    if(indicator->summary.groupMode == RGRI_GROUP_BY_CPU){
+        int index = rgri_cpu_departure_group(indicator);
+        atomic_fetch_sub_explicit(&indicator->readerGroups[index].value, 1, memory_order_release);
+        return;
+    }
+    int index = rgri_get_thread_id() & indicator->summary.groupMask;
 #ifdef MRQD_LOCK_READER_GROUP_PER_THREAD
     atomic_store_explicit(&indicator->readerGroups[index].value, 0, memory_order_release);
 #else
@@ -69,14 +226,55 @@ void rgri_depart(ReaderGroupsReadIndicator * indicator){
 #endif
 }
 
+/* Waits until the group is empty. If the group looks empty and the
+   indicator is not shared its summary bit is cleared first. The count
+   is read again after the clear, so a reader that arrived before the
+   clear and saw the bit set is still waited for. */
 static inline
-void rgri_wait_all_readers_gone(ReaderGroupsReadIndicator * indicator){
+bool rgri_wait_group_gone_until(ReaderGroupsReadIndicator * indicator,
+                                int index,
+                                uint64_t deadline){
+    volatile atomic_ulong * word = &indicator->summary.words[index / RGRI_BITS_PER_SUMMARY_WORD];
+    unsigned long bit = 1ul << (index % RGRI_BITS_PER_SUMMARY_WORD);
+    bool cleared = false;
+    if(!indicator->summary.shared &&
+       0 == atomic_load(&indicator->readerGroups[index].value)){
+        atomic_fetch_and(word, ~bit);
+        cleared = true;
+    }
+    while(0 < atomic_load_explicit(&indicator->readerGroups[index].value, memory_order_acquire)){
+        if(ll_deadline_passed(deadline)){
+            if(cleared){
+                //Readers that saw the bit set may still be in the group
+                atomic_fetch_or(word, bit);
+            }
+            return false;
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+static inline
+bool rgri_wait_all_readers_gone_until(ReaderGroupsReadIndicator * indicator,
+                                      uint64_t deadline){
     atomic_thread_fence(memory_order_seq_cst);
-    for(int i = 0; i < MRQD_LOCK_NUMBER_OF_READER_GROUPS; i++){
-        while(0 < atomic_load_explicit(&indicator->readerGroups[i].value, memory_order_acquire)){
-            thread_yield();
+    for(unsigned int w = 0; w < RGRI_NUMBER_OF_SUMMARY_WORDS; w++){
+        unsigned long occupied = atomic_load(&indicator->summary.words[w]);
+        while(occupied != 0){
+            int index = w * RGRI_BITS_PER_SUMMARY_WORD + __builtin_ctzl(occupied);
+            occupied = occupied & (occupied - 1);
+            if(!rgri_wait_group_gone_until(indicator, index, deadline)){
+                return false;
+            }
         }
     }
+    return true;
+}
+
+static inline
+void rgri_wait_all_readers_gone(ReaderGroupsReadIndicator * indicator){
+    rgri_wait_all_readers_gone_until(indicator, UINT64_MAX);
 }
 
 #endif
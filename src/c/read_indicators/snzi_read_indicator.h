@@ -0,0 +1,212 @@
+#ifndef SNZI_READ_INDICATOR_H
+#define SNZI_READ_INDICATOR_H
+
+#include "misc/thread_includes.h"
+#include "misc/padded_types.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/timing.h"
+#include "read_indicators/reader_groups_read_indicator.h"
+#include <stdbool.h>
+
+/* SNZI Read Indicator */
+
+// A read indicator based on a Scalable NonZero Indicator (Ellen, Lev,
+// Luchangco and Moir, PODC 2007) with a two level tree. Readers arrive
+// and depart at a leaf chosen by their thread id. A leaf only arrives
+// at the root when its count goes from zero to nonzero, and only
+// departs from it when its count goes back to zero. The root sets a
+// single indicator flag, so a writer only has to read one cache line.
+//
+// Arrivals are more expensive than with reader groups, since they use
+// CAS loops and sometimes update the root. In return, the writer's
+// scan costs one cache line however many leaves there are.
+
+#ifndef SNZI_NUMBER_OF_LEAVES
+#    define SNZI_NUMBER_OF_LEAVES 16
+#endif
+
+typedef struct {
+    // Count in the low 31 bits, announce flag in bit 31 and version
+    // in the high 32 bits
+    LLPaddedULong root;
+    // Indicator flag in bit 0 and a version in the other bits. The
+    // version makes a CAS fail if the flag was written after it was
+    // read.
+    LLPaddedULong indicator;
+    // Count in half units in the low 32 bits (1 means 1/2) and
+    // version in the high 32 bits
+    LLPaddedULong leaves[SNZI_NUMBER_OF_LEAVES];
+} SNZIReadIndicator;
+
+#define SNZI_HALF 1ul
+#define SNZI_ONE 2ul
+
+static inline unsigned long snziri_count(unsigned long x){
+    return x & 0xFFFFFFFFul;
+}
+static inline unsigned long snziri_version(unsigned long x){
+    return x >> 32;
+}
+static inline unsigned long snziri_make_leaf(unsigned long count, unsigned long version){
+    return ((version & 0xFFFFFFFFul) << 32) | count;
+}
+static inline unsigned long snziri_root_count(unsigned long x){
+    return x & 0x7FFFFFFFul;
+}
+static inline bool snziri_root_announce(unsigned long x){
+    return (x >> 31) & 1ul;
+}
+static inline unsigned long snziri_make_root(unsigned long count, bool announce, unsigned long version){
+    return ((version & 0xFFFFFFFFul) << 32) | ((unsigned long)announce << 31) | count;
+}
+
+static inline
+void snzi_initialize(SNZIReadIndicator * indicator){
+    atomic_store(&indicator->root.value, 0);
+    atomic_store(&indicator->indicator.value, 0);
+    for(int i = 0; i < SNZI_NUMBER_OF_LEAVES; i++){
+        atomic_store(&indicator->leaves[i].value, 0);
+    }
+}
+
+static inline
+void snziri_write_indicator(SNZIReadIndicator * indicator, unsigned long flag){
+    unsigned long old = atomic_load(&indicator->indicator.value);
+    while(!atomic_compare_exchange_weak(&indicator->indicator.value,
+                                        &old,
+                                        (((old >> 1) + 1) << 1) | flag)){
+    }
+}
+
+static inline
+void snziri_root_arrive(SNZIReadIndicator * indicator){
+    unsigned long x = atomic_load(&indicator->root.value);
+    unsigned long newX;
+    do{
+        if(snziri_root_count(x) == 0){
+            newX = snziri_make_root(1, true, snziri_version(x) + 1);
+        }else{
+            newX = snziri_make_root(snziri_root_count(x) + 1,
+                                    snziri_root_announce(x),
+                                    snziri_version(x));
+        }
+    }while(!atomic_compare_exchange_weak(&indicator->root.value, &x, newX));
+    if(snziri_root_announce(newX)){
+        snziri_write_indicator(indicator, 1);
+        unsigned long expected = newX;
+        atomic_compare_exchange_strong(&indicator->root.value,
+                                       &expected,
+                                       snziri_make_root(snziri_root_count(newX),
+                                                        false,
+                                                        snziri_version(newX)));
+    }
+}
+
+static inline
+void snziri_root_depart(SNZIReadIndicator * indicator){
+    unsigned long x = atomic_load(&indicator->root.value);
+    while(!atomic_compare_exchange_weak(&indicator->root.value,
+                                        &x,
+                                        snziri_make_root(snziri_root_count(x) - 1,
+                                                         false,
+                                                         snziri_version(x)))){
+    }
+    if(snziri_root_count(x) >= 2){
+        return;
+    }
+    //Clear the indicator unless a new arrival has changed the version
+    unsigned long flag = atomic_load(&indicator->indicator.value);
+    while(true){
+        if(snziri_version(atomic_load(&indicator->root.value)) != snziri_version(x)){
+            return;
+        }
+        if(atomic_compare_exchange_strong(&indicator->indicator.value,
+                                          &flag,
+                                          ((flag >> 1) + 1) << 1)){
+            return;
+        }
+    }
+}
+
+static inline
+void snziri_leaf_arrive(SNZIReadIndicator * indicator, volatile atomic_ulong * leaf){
+    bool success = false;
+    int undoArrivals = 0;
+    while(!success){
+        unsigned long x = atomic_load(leaf);
+        if(snziri_count(x) >= SNZI_ONE){
+            unsigned long expected = x;
+            if(atomic_compare_exchange_strong(leaf,
+                                              &expected,
+                                              snziri_make_leaf(snziri_count(x) + SNZI_ONE,
+                                                               snziri_version(x)))){
+                success = true;
+            }
+        }
+        if(snziri_count(x) == 0){
+            unsigned long expected = x;
+            unsigned long half = snziri_make_leaf(SNZI_HALF, snziri_version(x) + 1);
+            if(atomic_compare_exchange_strong(leaf, &expected, half)){
+                success = true;
+                x = half;
+            }
+        }
+        if(snziri_count(x) == SNZI_HALF){
+            snziri_root_arrive(indicator);
+            unsigned long expected = x;
+            if(!atomic_compare_exchange_strong(leaf,
+                                               &expected,
+                                               snziri_make_leaf(SNZI_ONE, snziri_version(x)))){
+                undoArrivals = undoArrivals + 1;
+            }
+        }
+    }
+    for(int i = 0; i < undoArrivals; i++){
+        snziri_root_depart(indicator);
+    }
+}
+
+static inline
+void snziri_leaf_depart(SNZIReadIndicator * indicator, volatile atomic_ulong * leaf){
+    unsigned long x = atomic_load(leaf);
+    while(!atomic_compare_exchange_weak(leaf,
+                                        &x,
+                                        snziri_make_leaf(snziri_count(x) - SNZI_ONE,
+                                                         snziri_version(x)))){
+    }
+    if(snziri_count(x) == SNZI_ONE){
+        snziri_root_depart(indicator);
+    }
+}
+
+static inline
+void snziri_arrive(SNZIReadIndicator * indicator){
+    int index = rgri_get_thread_id() % SNZI_NUMBER_OF_LEAVES;
+    snziri_leaf_arrive(indicator, &indicator->leaves[index].value);
+}
+
+static inline
+void snziri_depart(SNZIReadIndicator * indicator){
+    int index = rgri_get_thread_id() % SNZI_NUMBER_OF_LEAVES;
+    snziri_leaf_depart(indicator, &indicator->leaves[index].value);
+}
+
+static inline
+bool snziri_wait_all_readers_gone_until(SNZIReadIndicator * indicator,
+                                        uint64_t deadline){
+    atomic_thread_fence(memory_order_seq_cst);
+    while(atomic_load_explicit(&indicator->indicator.value, memory_order_acquire) & 1ul){
+        if(ll_deadline_passed(deadline)){
+            return false;
+        }
+        thread_yield();
+    }
+    return true;
+}
+
+static inline
+void snziri_wait_all_readers_gone(SNZIReadIndicator * indicator){
+    snziri_wait_all_readers_gone_until(indicator, UINT64_MAX);
+}
+
+#endif
@@ -11,7 +11,7 @@
     printf("STARTING TEST: ");                  \
     test(testFunCall, tesName);
 
-void test(int success, char msg[]){
+void test(int success, const char msg[]){
 
     if(success){
         printf("\033[32m -- SUCCESS! -- \033[m");
@@ -4,6 +4,8 @@
 #include "misc/thread_includes.h"
 #include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
 #include <string.h>
+#include <limits.h>
+#include <poll.h>
 
 #include "locks/locks.h"
 
@@ -29,6 +31,20 @@ typedef struct {
 
 LLLockTypeNameWrapper lock_type;
 
+/* Read indicator used by the reader-writer locks or -1 for the
+   default */
+int read_indicator_type = -1;
+int read_indicator_width = MRQD_LOCK_NUMBER_OF_READER_GROUPS;
+
+LOCK_TYPE * create_test_lock(){
+    if(read_indicator_type >= 0){
+        return LL_create_with_read_indicator_width(lock_type.value,
+                                                   read_indicator_type,
+                                                   read_indicator_width);
+    }
+    return LL_create(lock_type.value);
+}
+
 int test_create(){
     LOCK_TYPE * lock = LL_create(lock_type.value);
     LL_free(lock);
@@ -136,15 +152,8 @@ void  * critical_section_thread(void * threadLocalDataVPtr){
     }
     return NULL;
 }
-int test_mutual_exclusion(double delegatePercentageParm,
-                          double readPercentageParm,
-                          double delegateOrLockPercentageParm,
-                          double delegateWaitPercentageParm){
-    delegatePercentage.value = delegatePercentageParm;
-    readPercentage.value = readPercentageParm;
-    delegateOrLockPercentage.value = delegateOrLockPercentageParm;
-    delegateWaitPercentage.value = delegateWaitPercentageParm;
-    lock = LL_create(lock_type.value);
+void run_critical_section_threads(void * (*threadFunction)(void *)){
+    lock = create_test_lock();
     struct timespec testTime= {.tv_sec = 1, .tv_nsec = 100000000}; 
     int threadCountsToTest[] = {1,2,4,8,16};
     int nrOfThreadCountsToTest = 5;
@@ -164,7 +173,7 @@ int test_mutual_exclusion(double delegatePercentageParm,
             threadLocalData[n].localInCSCounter = &localInCSCounters[n].value;
             threadLocalData[n].localSeed = &localSeeds[n].value;
             pthread_create(&threads[n], NULL,
-                           critical_section_thread,
+                           threadFunction,
                            &threadLocalData[n]);
         }
         nanosleep(&testTime, NULL);
@@ -182,6 +191,1001 @@ int test_mutual_exclusion(double delegatePercentageParm,
         assert(localInCSCountersSum == atomic_load(&counter.value));
     }
     LL_free(lock);
+}
+
+int test_mutual_exclusion(double delegatePercentageParm,
+                          double readPercentageParm,
+                          double delegateOrLockPercentageParm,
+                          double delegateWaitPercentageParm){
+    delegatePercentage.value = delegatePercentageParm;
+    readPercentage.value = readPercentageParm;
+    delegateOrLockPercentage.value = delegateOrLockPercentageParm;
+    delegateWaitPercentage.value = delegateWaitPercentageParm;
+    run_critical_section_threads(critical_section_thread);
+    return 1;
+}
+
+#define TIMED_TEST_TIMEOUT_NANOS 2000
+
+void * timed_critical_section_thread(void * threadLocalDataVPtr){
+    ThreadLocalData * threadLocalDataPtr = (ThreadLocalData*)threadLocalDataVPtr;
+    unsigned long * localInCSCounter = threadLocalDataPtr->localInCSCounter;
+    unsigned int * localSeed = threadLocalDataPtr->localSeed;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        double randomNumber = random_double(localSeed);
+        if(randomNumber > 0.66){
+            if(LL_lock_timed(lock, TIMED_TEST_TIMEOUT_NANOS)){
+                critical_section_code(localInCSCounter);
+                LL_unlock(lock);
+            }
+        }else if(randomNumber > 0.33){
+            LL_try_delegate(lock, delegate_function, sizeof(unsigned long *), &localInCSCounter);
+        }else{
+            LL_delegate_timed(lock, delegate_function, sizeof(unsigned long *), &localInCSCounter, TIMED_TEST_TIMEOUT_NANOS);
+        }
+    }
+    return NULL;
+}
+
+int test_timed_mutual_exclusion(){
+    run_critical_section_threads(timed_critical_section_thread);
+    return 1;
+}
+
+LLPaddedBool lockHeld = {.value = ATOMIC_FLAG_INIT};
+LLPaddedBool releaseLock = {.value = ATOMIC_FLAG_INIT};
+
+void * hold_lock_thread(void * unused){
+    UNUSED(unused);
+    LL_lock(lock);
+    atomic_store(&lockHeld.value, true);
+    while(!atomic_load(&releaseLock.value)){
+        thread_yield();
+    }
+    LL_unlock(lock);
+    return NULL;
+}
+
+#define READER_HELD_TIMEOUT_NANOS 200000000
+
+LLPaddedBool writerEntered;
+
+void * timed_writer_thread(void * unused){
+    UNUSED(unused);
+    assert(!LL_lock_timed(lock, READER_HELD_TIMEOUT_NANOS));
+    return NULL;
+}
+
+void * blocking_writer_thread(void * unused){
+    UNUSED(unused);
+    LL_lock(lock);
+    atomic_store(&writerEntered.value, true);
+    LL_unlock(lock);
+    return NULL;
+}
+
+int test_lock_timed(){
+    unsigned long localCounter = 0;
+    unsigned long * localCounterPtr = &localCounter;
+    lock = LL_create(lock_type.value);
+    atomic_store(&counter.value, 0);
+    assert(LL_lock_timed(lock, TIMED_TEST_TIMEOUT_NANOS));
+    LL_unlock(lock);
+    atomic_store(&lockHeld.value, false);
+    atomic_store(&releaseLock.value, false);
+    pthread_t holder;
+    pthread_create(&holder, NULL, hold_lock_thread, NULL);
+    while(!atomic_load(&lockHeld.value)){
+        thread_yield();
+    }
+    assert(!LL_lock_timed(lock, TIMED_TEST_TIMEOUT_NANOS));
+    assert(!LL_try_delegate(lock, delegate_function, sizeof(unsigned long *), &localCounterPtr));
+    assert(!LL_delegate_timed(lock, delegate_function, sizeof(unsigned long *), &localCounterPtr, TIMED_TEST_TIMEOUT_NANOS));
+    atomic_store(&releaseLock.value, true);
+    pthread_join(holder, NULL);
+    assert(LL_try_delegate(lock, delegate_function, sizeof(unsigned long *), &localCounterPtr));
+    assert(LL_delegate_timed(lock, delegate_function, sizeof(unsigned long *), &localCounterPtr, TIMED_TEST_TIMEOUT_NANOS));
+    assert(localCounter == 2);
+    //A writer that queued up behind a timed writer that gave up waiting
+    //for a reader still has to wait for the reader
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 50000000};
+    pthread_t timedWriter;
+    pthread_t blockingWriter;
+    atomic_store(&writerEntered.value, false);
+    LL_rlock(lock);
+    pthread_create(&timedWriter, NULL, timed_writer_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    pthread_create(&blockingWriter, NULL, blocking_writer_thread, NULL);
+    pthread_join(timedWriter, NULL);
+    nanosleep(&waitTime, NULL);
+    assert(!atomic_load(&writerEntered.value));
+    LL_runlock(lock);
+    pthread_join(blockingWriter, NULL);
+    assert(atomic_load(&writerEntered.value));
+    LL_free(lock);
+    return 1;
+}
+
+#define NESTED_TEST_NUMBER_OF_LOCKS 4
+
+LOCK_TYPE * nestedLocks[NESTED_TEST_NUMBER_OF_LOCKS];
+LLPaddedLocalCounter nestedCounters[NESTED_TEST_NUMBER_OF_LOCKS];
+
+void * nested_critical_section_thread(void * threadLocalDataVPtr){
+    ThreadLocalData * threadLocalDataPtr = (ThreadLocalData*)threadLocalDataVPtr;
+    unsigned long * localInCSCounter = threadLocalDataPtr->localInCSCounter;
+    unsigned int * localSeed = threadLocalDataPtr->localSeed;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        int first = (int)(random_double(localSeed) * (NESTED_TEST_NUMBER_OF_LOCKS - 1));
+        int second = first + 1 + (int)(random_double(localSeed) * (NESTED_TEST_NUMBER_OF_LOCKS - 1 - first));
+        if(second >= NESTED_TEST_NUMBER_OF_LOCKS){
+            second = NESTED_TEST_NUMBER_OF_LOCKS - 1;
+        }
+        LL_lock(nestedLocks[first]);
+        LL_lock(nestedLocks[second]);
+        nestedCounters[first].value++;
+        nestedCounters[second].value++;
+        *localInCSCounter = *localInCSCounter + 2;
+        if(random_double(localSeed) > 0.5){
+            LL_unlock(nestedLocks[first]);
+            LL_unlock(nestedLocks[second]);
+        }else{
+            LL_unlock(nestedLocks[second]);
+            LL_unlock(nestedLocks[first]);
+        }
+    }
+    return NULL;
+}
+
+int test_nested_locks(){
+    for(int i = 0; i < NESTED_TEST_NUMBER_OF_LOCKS; i++){
+        nestedLocks[i] = LL_create(lock_type.value);
+        nestedCounters[i].value = 0;
+    }
+    for(int i = 0; i < NESTED_TEST_NUMBER_OF_LOCKS; i++){
+        LL_lock(nestedLocks[i]);
+        assert(LL_is_locked(nestedLocks[i]));
+    }
+    LL_unlock(nestedLocks[1]);
+    LL_unlock(nestedLocks[3]);
+    LL_unlock(nestedLocks[0]);
+    LL_unlock(nestedLocks[2]);
+    for(int i = 0; i < NESTED_TEST_NUMBER_OF_LOCKS; i++){
+        assert(!LL_is_locked(nestedLocks[i]));
+    }
+    int numberOfThreads = 8;
+    struct timespec testTime= {.tv_sec = 1, .tv_nsec = 0};
+    pthread_t threads[numberOfThreads];
+    LLPaddedLocalCounter localInCSCounters[numberOfThreads];
+    LLPaddedSeed localSeeds[numberOfThreads];
+    ThreadLocalData threadLocalData[numberOfThreads];
+    atomic_store(&stop.value, false);
+    for(int n = 0; n < numberOfThreads; n++){
+        localInCSCounters[n].value = 0;
+        localSeeds[n].value = n;
+        threadLocalData[n].localInCSCounter = &localInCSCounters[n].value;
+        threadLocalData[n].localSeed = &localSeeds[n].value;
+        pthread_create(&threads[n], NULL,
+                       nested_critical_section_thread,
+                       &threadLocalData[n]);
+    }
+    nanosleep(&testTime, NULL);
+    atomic_store(&stop.value, true);
+    unsigned long localInCSCountersSum = 0;
+    unsigned long nestedCountersSum = 0;
+    for(int n = 0; n < numberOfThreads; n++){
+        pthread_join(threads[n], NULL);
+        localInCSCountersSum = localInCSCountersSum + localInCSCounters[n].value;
+    }
+    for(int i = 0; i < NESTED_TEST_NUMBER_OF_LOCKS; i++){
+        nestedCountersSum = nestedCountersSum + nestedCounters[i].value;
+        LL_free(nestedLocks[i]);
+    }
+    assert(localInCSCountersSum == nestedCountersSum);
+    return 1;
+}
+
+void count_delegations(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    int ** counterPtrPtr = (int **)messageAddress;
+    (**counterPtrPtr)++;
+}
+
+int test_compact_qd_queue_detached_when_idle(){
+    CompactQDLock * lock = plain_cqd_create();
+    int delegations = 0;
+    int * delegationsPtr = &delegations;
+    assert(sizeof(CompactQDLock) == CACHE_LINE_SIZE);
+    assert(atomic_load(&lock->queue) == 0);
+    LL_lock(lock);
+    //A failed delegation attaches a queue
+    assert(!LL_try_delegate(lock, count_delegations, sizeof(int *), &delegationsPtr));
+    assert(atomic_load(&lock->queue) != 0);
+    LL_unlock(lock);
+    //Nothing is delegated while this delegation holds the lock
+    LL_delegate(lock, count_delegations, sizeof(int *), &delegationsPtr);
+    assert(delegations == 1);
+    assert(atomic_load(&lock->queue) == 0);
+    LL_free(lock);
+    return 1;
+}
+
+#define PRIORITY_TEST_LOW_REQUESTS 10
+
+PriorityQDLock * priorityLock;
+int priorityOrder[PRIORITY_TEST_LOW_REQUESTS + 1];
+int priorityOrderSize;
+LLPaddedInt priorityDelegated;
+
+void record_priority_order(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    priorityOrder[priorityOrderSize] = *(int *)messageAddress;
+    priorityOrderSize++;
+}
+
+void * delegate_low_priority_thread(void * unused){
+    UNUSED(unused);
+    for(int i = 1; i <= PRIORITY_TEST_LOW_REQUESTS; i++){
+        LL_delegate(priorityLock, record_priority_order, sizeof(int), &i);
+    }
+    atomic_fetch_add(&priorityDelegated.value, 1);
+    return NULL;
+}
+
+void * delegate_high_priority_thread(void * unused){
+    UNUSED(unused);
+    int high = 0;
+    LL_delegate_priority(priorityLock, 0, record_priority_order, sizeof(int), &high);
+    atomic_fetch_add(&priorityDelegated.value, 1);
+    return NULL;
+}
+
+int test_priority_lanes(){
+    pthread_t threads[2];
+    priorityLock = plain_pqd_create();
+    priorityOrderSize = 0;
+    atomic_store(&priorityDelegated.value, 0);
+    //Hold the lock so that the requests are queued
+    assert(NULL == LL_delegate_or_lock(priorityLock, 0));
+    pthread_create(&threads[0], NULL, &delegate_low_priority_thread, NULL);
+    while(atomic_load(&priorityDelegated.value) < 1){
+        thread_yield();
+    }
+    pthread_create(&threads[1], NULL, &delegate_high_priority_thread, NULL);
+    while(atomic_load(&priorityDelegated.value) < 2){
+        thread_yield();
+    }
+    assert(priorityOrderSize == 0);
+    LL_delegate_unlock(priorityLock);
+    for(int i = 0; i < 2; i++){
+        pthread_join(threads[i], NULL);
+    }
+    //The high priority request was delegated last but executed first
+    assert(priorityOrderSize == PRIORITY_TEST_LOW_REQUESTS + 1);
+    for(int i = 0; i <= PRIORITY_TEST_LOW_REQUESTS; i++){
+        assert(priorityOrder[i] == i);
+    }
+    LL_free(priorityLock);
+    return 1;
+}
+
+void increment_counter(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    atomic_fetch_add(&counter.value, 1);
+}
+
+int test_optimistic_read_versions(){
+    QDLock * qdLock = plain_qd_create();
+    unsigned long version = LL_oread_begin(qdLock);
+    assert(LL_oread_validate(qdLock, version));
+    LL_rlock(qdLock);
+    assert(LL_oread_validate(qdLock, version));
+    LL_runlock(qdLock);
+    LL_lock(qdLock);
+    assert(!LL_oread_validate(qdLock, LL_oread_begin(qdLock)));
+    LL_unlock(qdLock);
+    assert(!LL_oread_validate(qdLock, version));
+    version = LL_oread_begin(qdLock);
+    LL_delegate(qdLock, increment_counter, 0, NULL);
+    assert(!LL_oread_validate(qdLock, version));
+    free(qdLock);
+    MRQDLock * mrqdLock = plain_mrqd_create();
+    version = LL_oread_begin(mrqdLock);
+    LL_rlock(mrqdLock);
+    LL_runlock(mrqdLock);
+    assert(LL_oread_validate(mrqdLock, version));
+    LL_delegate(mrqdLock, increment_counter, 0, NULL);
+    assert(!LL_oread_validate(mrqdLock, version));
+    mrqd_free(mrqdLock);
+    //Lock types without a version never validate
+    OOLock * tatasLock = LL_create(TATAS_LOCK);
+    assert(!LL_oread_validate(tatasLock, LL_oread_begin(tatasLock)));
+    LL_free(tatasLock);
+    return 1;
+}
+
+#define OPTIMISTIC_READ_ATTEMPTS 3
+
+OOLock * optimisticLock;
+volatile atomic_ulong optimisticPair[2];
+LLPaddedULong validatedReads;
+
+void write_optimistic_pair(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    unsigned long value = atomic_load_explicit(&optimisticPair[0], memory_order_relaxed);
+    atomic_store_explicit(&optimisticPair[0], value + 1, memory_order_relaxed);
+    thread_yield();
+    atomic_store_explicit(&optimisticPair[1], value + 1, memory_order_relaxed);
+}
+
+void * optimistic_read_thread(void * seedVPtr){
+    unsigned int * seed = (unsigned int *)seedVPtr;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        double randomNumber = random_double(seed);
+        if(randomNumber < 0.25){
+            LL_delegate(optimisticLock, write_optimistic_pair, 0, NULL);
+        }else if(randomNumber < 0.5){
+            LL_lock(optimisticLock);
+            write_optimistic_pair(0, NULL);
+            LL_unlock(optimisticLock);
+        }else{
+            bool validated = false;
+            for(int i = 0; i < OPTIMISTIC_READ_ATTEMPTS && !validated; i++){
+                unsigned long version = LL_oread_begin(optimisticLock);
+                unsigned long first = atomic_load_explicit(&optimisticPair[0], memory_order_relaxed);
+                unsigned long second = atomic_load_explicit(&optimisticPair[1], memory_order_relaxed);
+                if(LL_oread_validate(optimisticLock, version)){
+                    assert(first == second);
+                    atomic_fetch_add(&validatedReads.value, 1);
+                    validated = true;
+                }
+            }
+            if(!validated){
+                LL_rlock(optimisticLock);
+                assert(atomic_load(&optimisticPair[0]) == atomic_load(&optimisticPair[1]));
+                LL_runlock(optimisticLock);
+            }
+        }
+    }
+    return NULL;
+}
+
+int test_optimistic_read(LL_lock_type_name ooLockType){
+    pthread_t threads[8];
+    unsigned int seeds[8];
+    struct timespec testTime = {.tv_sec = 0, .tv_nsec = 500000000};
+    optimisticLock = LL_create(ooLockType);
+    atomic_store(&optimisticPair[0], 0);
+    atomic_store(&optimisticPair[1], 0);
+    atomic_store(&validatedReads.value, 0);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < 8; i++){
+        seeds[i] = i;
+        pthread_create(&threads[i], NULL, &optimistic_read_thread, &seeds[i]);
+    }
+    nanosleep(&testTime, NULL);
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < 8; i++){
+        pthread_join(threads[i], NULL);
+    }
+    assert(atomic_load(&validatedReads.value) > 0);
+    LL_free(optimisticLock);
+    return 1;
+}
+
+void read_optimistic_pair(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    unsigned long * resultPtr = *(unsigned long **)messageAddress;
+    unsigned long first = atomic_load_explicit(&optimisticPair[0], memory_order_relaxed);
+    assert(first == atomic_load_explicit(&optimisticPair[1], memory_order_relaxed));
+    *resultPtr = first;
+}
+
+void * delegate_read_thread(void * seedVPtr){
+    unsigned int * seed = (unsigned int *)seedVPtr;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        double randomNumber = random_double(seed);
+        if(randomNumber < 0.25){
+            LL_delegate(optimisticLock, write_optimistic_pair, 0, NULL);
+        }else if(randomNumber < 0.3){
+            LL_lock(optimisticLock);
+            write_optimistic_pair(0, NULL);
+            LL_unlock(optimisticLock);
+        }else{
+            unsigned long result = ULONG_MAX;
+            unsigned long * resultPtr = &result;
+            LL_delegate_read(optimisticLock, read_optimistic_pair, sizeof(unsigned long *), &resultPtr);
+            assert(result != ULONG_MAX);
+            atomic_fetch_add(&validatedReads.value, 1);
+        }
+    }
+    return NULL;
+}
+
+int test_delegate_read(LL_lock_type_name ooLockType){
+    pthread_t threads[8];
+    unsigned int seeds[8];
+    struct timespec testTime = {.tv_sec = 0, .tv_nsec = 500000000};
+    optimisticLock = LL_create(ooLockType);
+    atomic_store(&optimisticPair[0], 0);
+    atomic_store(&optimisticPair[1], 0);
+    atomic_store(&validatedReads.value, 0);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < 8; i++){
+        seeds[i] = i;
+        pthread_create(&threads[i], NULL, &delegate_read_thread, &seeds[i]);
+    }
+    nanosleep(&testTime, NULL);
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < 8; i++){
+        pthread_join(threads[i], NULL);
+    }
+    assert(atomic_load(&validatedReads.value) > 0);
+    LL_free(optimisticLock);
+    return 1;
+}
+
+OOLock * fenceLocks[2];
+LLPaddedBool fenced;
+
+void * delegate_and_fence_thread(void * unused){
+    UNUSED(unused);
+    LL_delegate(fenceLocks[0], increment_counter, 0, NULL);
+    LL_delegate(fenceLocks[1], increment_counter, 0, NULL);
+    LL_delegate_fence(fenceLocks[0]);
+    assert(atomic_load(&counter.value) >= 1);
+    LL_delegate_fence_all();
+    assert(atomic_load(&counter.value) == 2);
+    atomic_store(&fenced.value, true);
+    return NULL;
+}
+
+//The adaptive lock only opens its queue in the delegate mode and the
+//compact QD lock only opens a queue that has been attached before
+void prepare_fence_lock(OOLock * lock, LL_lock_type_name ooLockType){
+    int delegations = 0;
+    int * delegationsPtr = &delegations;
+    if(ooLockType == ADAPTIVE_LOCK){
+        ((AdaptiveLock *)lock->lock)->holderData.value.stats.mode = ADAPTIVE_LOCK_MODE_DELEGATE;
+    }else if(ooLockType == COMPACT_QD_LOCK){
+        LL_lock(lock);
+        assert(!LL_try_delegate(lock, count_delegations, sizeof(int *), &delegationsPtr));
+        LL_unlock(lock);
+    }
+}
+
+int test_delegate_fence(LL_lock_type_name ooLockType){
+    pthread_t thread;
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 100000000};
+    fenceLocks[0] = LL_create(ooLockType);
+    fenceLocks[1] = LL_create(ooLockType);
+    prepare_fence_lock(fenceLocks[0], ooLockType);
+    prepare_fence_lock(fenceLocks[1], ooLockType);
+    atomic_store(&counter.value, 0);
+    atomic_store(&fenced.value, false);
+    //Hold both locks with open queues so that the delegations are queued
+    assert(LL_delegate_or_lock(fenceLocks[0], 0) == NULL);
+    assert(LL_delegate_or_lock(fenceLocks[1], 0) == NULL);
+    pthread_create(&thread, NULL, &delegate_and_fence_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    assert(!atomic_load(&fenced.value));
+    LL_delegate_unlock(fenceLocks[0]);
+    nanosleep(&waitTime, NULL);
+    assert(!atomic_load(&fenced.value));
+    LL_delegate_unlock(fenceLocks[1]);
+    pthread_join(thread, NULL);
+    assert(atomic_load(&fenced.value));
+    assert(atomic_load(&counter.value) == 2);
+    //Nothing is outstanding, so the fences return immediately
+    LL_delegate_fence(fenceLocks[0]);
+    LL_delegate_fence_all();
+    LL_free(fenceLocks[0]);
+    LL_free(fenceLocks[1]);
+    return 1;
+}
+
+void forward_increment(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    LL_delegate_forward(fenceLocks[1], increment_counter, 0, NULL);
+}
+
+void * delegate_forward_and_fence_thread(void * unused){
+    UNUSED(unused);
+    LL_delegate(fenceLocks[0], forward_increment, 0, NULL);
+    LL_delegate_fence(fenceLocks[0]);
+    assert(atomic_load(&counter.value) == 1);
+    atomic_store(&fenced.value, true);
+    return NULL;
+}
+
+int test_delegate_forward_fence(LL_lock_type_name ooLockType){
+    pthread_t thread;
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 100000000};
+    fenceLocks[0] = LL_create(ooLockType);
+    fenceLocks[1] = LL_create(ooLockType);
+    atomic_store(&counter.value, 0);
+    atomic_store(&fenced.value, false);
+    assert(LL_delegate_or_lock(fenceLocks[0], 0) == NULL);
+    assert(LL_delegate_or_lock(fenceLocks[1], 0) == NULL);
+    pthread_create(&thread, NULL, &delegate_forward_and_fence_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    //The follow-up is queued in the second lock when the batch runs
+    LL_delegate_unlock(fenceLocks[0]);
+    assert(atomic_load(&counter.value) == 0);
+    nanosleep(&waitTime, NULL);
+    assert(!atomic_load(&fenced.value));
+    LL_delegate_unlock(fenceLocks[1]);
+    pthread_join(thread, NULL);
+    assert(atomic_load(&fenced.value));
+    assert(atomic_load(&counter.value) == 1);
+    LL_free(fenceLocks[0]);
+    LL_free(fenceLocks[1]);
+    return 1;
+}
+
+LLPaddedULong otherCounter;
+
+void increment_other_counter(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    atomic_fetch_add(&otherCounter.value, 1);
+}
+
+void * delegate_forward_thread(void * unused){
+    UNUSED(unused);
+    LL_delegate(fenceLocks[0], forward_increment, 0, NULL);
+    return NULL;
+}
+
+void * delegate_other_and_fence_thread(void * unused){
+    UNUSED(unused);
+    LL_delegate(fenceLocks[0], increment_other_counter, 0, NULL);
+    LL_delegate_fence(fenceLocks[0]);
+    assert(atomic_load(&otherCounter.value) == 1);
+    atomic_store(&fenced.value, true);
+    return NULL;
+}
+
+//A fence does not wait for follow-ups that other threads have
+//forwarded from earlier batches of the lock
+int test_delegate_fence_other_forwards(LL_lock_type_name ooLockType){
+    pthread_t forwarder;
+    pthread_t fencer;
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 100000000};
+    fenceLocks[0] = LL_create(ooLockType);
+    fenceLocks[1] = LL_create(ooLockType);
+    atomic_store(&counter.value, 0);
+    atomic_store(&otherCounter.value, 0);
+    atomic_store(&fenced.value, false);
+    //The follow-up stays in flight while the second lock is held
+    assert(LL_delegate_or_lock(fenceLocks[1], 0) == NULL);
+    assert(LL_delegate_or_lock(fenceLocks[0], 0) == NULL);
+    pthread_create(&forwarder, NULL, &delegate_forward_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    LL_delegate_unlock(fenceLocks[0]);
+    pthread_join(forwarder, NULL);
+    assert(atomic_load(&counter.value) == 0);
+    assert(LL_delegate_or_lock(fenceLocks[0], 0) == NULL);
+    pthread_create(&fencer, NULL, &delegate_other_and_fence_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    assert(!atomic_load(&fenced.value));
+    LL_delegate_unlock(fenceLocks[0]);
+    nanosleep(&waitTime, NULL);
+    assert(atomic_load(&fenced.value));
+    assert(atomic_load(&counter.value) == 0);
+    LL_delegate_unlock(fenceLocks[1]);
+    pthread_join(fencer, NULL);
+    assert(atomic_load(&counter.value) == 1);
+    LL_free(fenceLocks[0]);
+    LL_free(fenceLocks[1]);
+    return 1;
+}
+
+void forward_increment_to_free_lock(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    LL_delegate_forward(fenceLocks[1], increment_counter, 0, NULL);
+    //The holder does not take the free lock to execute the follow-up
+    assert(!LL_is_locked(fenceLocks[1]));
+    assert(atomic_load(&counter.value) == 0);
+}
+
+int test_delegate_forward_is_deferred(LL_lock_type_name ooLockType){
+    fenceLocks[0] = LL_create(ooLockType);
+    fenceLocks[1] = LL_create(ooLockType);
+    atomic_store(&counter.value, 0);
+    LL_delegate(fenceLocks[0], forward_increment_to_free_lock, 0, NULL);
+    //Delegated when the first lock has been released
+    assert(atomic_load(&counter.value) == 1);
+    LL_free(fenceLocks[0]);
+    LL_free(fenceLocks[1]);
+    return 1;
+}
+
+#define FORWARD_INITIAL_BALANCE 1000000
+
+long forwardBalances[2];
+LLPaddedULong forwardTransfers;
+
+void forward_deposit(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    int to = *(int *)messageAddress;
+    forwardBalances[to] = forwardBalances[to] + 1;
+}
+
+void forward_withdraw(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    int from = *(int *)messageAddress;
+    int to = 1 - from;
+    forwardBalances[from] = forwardBalances[from] - 1;
+    LL_delegate_forward(fenceLocks[to], forward_deposit, sizeof(int), &to);
+}
+
+void * forward_transfer_thread(void * seedVPtr){
+    unsigned int * seed = (unsigned int *)seedVPtr;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        int from = random_double(seed) < 0.5 ? 0 : 1;
+        LL_delegate(fenceLocks[from], forward_withdraw, sizeof(int), &from);
+        atomic_fetch_add(&forwardTransfers.value, 1);
+    }
+    LL_delegate_fence_all();
+    return NULL;
+}
+
+int test_delegate_forward(LL_lock_type_name ooLockType){
+    pthread_t threads[8];
+    unsigned int seeds[8];
+    struct timespec testTime = {.tv_sec = 0, .tv_nsec = 500000000};
+    fenceLocks[0] = LL_create(ooLockType);
+    fenceLocks[1] = LL_create(ooLockType);
+    forwardBalances[0] = FORWARD_INITIAL_BALANCE;
+    forwardBalances[1] = FORWARD_INITIAL_BALANCE;
+    atomic_store(&forwardTransfers.value, 0);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < 8; i++){
+        seeds[i] = i;
+        pthread_create(&threads[i], NULL, &forward_transfer_thread, &seeds[i]);
+    }
+    nanosleep(&testTime, NULL);
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < 8; i++){
+        pthread_join(threads[i], NULL);
+    }
+    assert(atomic_load(&forwardTransfers.value) > 0);
+    assert(forwardBalances[0] + forwardBalances[1] == 2 * FORWARD_INITIAL_BALANCE);
+    LL_free(fenceLocks[0]);
+    LL_free(fenceLocks[1]);
+    return 1;
+}
+
+LLPaddedULong cancelledDelegations;
+
+void cancel_delegation(unsigned int messageSize, void * messageAddress){
+    assert(messageSize == sizeof(int));
+    assert(*(int *)messageAddress == 42);
+    atomic_fetch_add(&cancelledDelegations.value, 1);
+}
+
+void add_message_to_counter(unsigned int messageSize, void * messageAddress){
+    assert(messageSize == sizeof(int));
+    atomic_fetch_add(&counter.value, *(int *)messageAddress);
+}
+
+int test_delegate_deadline(){
+    LOCK_TYPE * lock = LL_create(lock_type.value);
+    int message = 42;
+    atomic_store(&counter.value, 0);
+    atomic_store(&cancelledDelegations.value, 0);
+    LL_delegate_deadline(lock, ll_now_nanos(), cancel_delegation,
+                         add_message_to_counter, sizeof(int), &message);
+    LL_delegate_deadline(lock, ll_now_nanos(), NULL,
+                         add_message_to_counter, sizeof(int), &message);
+    LL_delegate_deadline(lock, ll_deadline_from_timeout(60000000000), cancel_delegation,
+                         add_message_to_counter, sizeof(int), &message);
+    LL_lock(lock);
+    assert(atomic_load(&counter.value) == 42);
+    assert(atomic_load(&cancelledDelegations.value) == 1);
+    LL_unlock(lock);
+    LL_free(lock);
+    return 1;
+}
+
+void * delegate_with_deadlines_thread(void * unused){
+    UNUSED(unused);
+    int message = 42;
+    LL_delegate_deadline(fenceLocks[0], ll_deadline_from_timeout(1000000), cancel_delegation,
+                         add_message_to_counter, sizeof(int), &message);
+    LL_delegate_deadline(fenceLocks[0], ll_deadline_from_timeout(60000000000), cancel_delegation,
+                         add_message_to_counter, sizeof(int), &message);
+    atomic_store(&fenced.value, true);
+    return NULL;
+}
+
+int test_delegate_deadline_expires_in_queue(LL_lock_type_name ooLockType){
+    pthread_t thread;
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 10000000};
+    fenceLocks[0] = LL_create(ooLockType);
+    atomic_store(&counter.value, 0);
+    atomic_store(&cancelledDelegations.value, 0);
+    atomic_store(&fenced.value, false);
+    //Hold the lock so that the requests stay in the queue
+    assert(LL_delegate_or_lock(fenceLocks[0], 0) == NULL);
+    pthread_create(&thread, NULL, &delegate_with_deadlines_thread, NULL);
+    while(!atomic_load(&fenced.value)){
+        thread_yield();
+    }
+    nanosleep(&waitTime, NULL);
+    LL_delegate_unlock(fenceLocks[0]);
+    pthread_join(thread, NULL);
+    assert(atomic_load(&cancelledDelegations.value) == 1);
+    assert(atomic_load(&counter.value) == 42);
+    LL_delegate_fence_all();
+    LL_free(fenceLocks[0]);
+    return 1;
+}
+
+#define ASYNC_TEST_DELEGATIONS 1000
+#define ASYNC_TEST_RING_CAPACITY 64
+
+int test_delegate_async(){
+    LOCK_TYPE * lock = LL_create(lock_type.value);
+    LLCompletionRing * ring = ll_completion_ring_create(ASYNC_TEST_RING_CAPACITY);
+    struct pollfd pollFd = {.fd = ll_completion_ring_fd(ring), .events = POLLIN};
+    bool harvested[ASYNC_TEST_DELEGATIONS] = {false};
+    void * tags[16];
+    unsigned long sent = 0;
+    unsigned long completed = 0;
+    atomic_store(&counter.value, 0);
+    while(completed < ASYNC_TEST_DELEGATIONS){
+        while(sent < ASYNC_TEST_DELEGATIONS &&
+              LL_delegate_async(lock, ring, (void *)(uintptr_t)sent,
+                                increment_counter, 0, NULL)){
+            sent = sent + 1;
+        }
+        assert(poll(&pollFd, 1, 10000) == 1);
+        unsigned int n;
+        while(0 != (n = ll_completion_ring_harvest(ring, tags, 16))){
+            for(unsigned int i = 0; i < n; i++){
+                uintptr_t tag = (uintptr_t)tags[i];
+                assert(tag < sent && !harvested[tag]);
+                harvested[tag] = true;
+            }
+            completed = completed + n;
+        }
+    }
+    assert(atomic_load(&counter.value) == ASYNC_TEST_DELEGATIONS);
+    //Nothing is left, so the descriptor is not readable
+    assert(poll(&pollFd, 1, 0) == 0);
+    LL_delegate_fence(lock);
+    ll_completion_ring_free(ring);
+    LL_free(lock);
+    return 1;
+}
+
+#define WAIT_UNTIL_TEST_WAITERS 4
+
+LOCK_TYPE * waitLock;
+unsigned long waitTokens;
+unsigned long takenWaitTokens;
+
+bool take_wait_token(void * arg){
+    UNUSED(arg);
+    if(waitTokens == 0){
+        return false;
+    }
+    waitTokens = waitTokens - 1;
+    takenWaitTokens = takenWaitTokens + 1;
+    return true;
+}
+
+void add_wait_token(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    waitTokens = waitTokens + 1;
+}
+
+void * wait_for_token_thread(void * unused){
+    UNUSED(unused);
+    LL_wait_until(waitLock, take_wait_token, NULL);
+    return NULL;
+}
+
+int test_wait_until(){
+    pthread_t threads[WAIT_UNTIL_TEST_WAITERS];
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 10000000};
+    waitLock = LL_create(lock_type.value);
+    waitTokens = 0;
+    takenWaitTokens = 0;
+    for(int i = 0; i < WAIT_UNTIL_TEST_WAITERS; i++){
+        pthread_create(&threads[i], NULL, &wait_for_token_thread, NULL);
+    }
+    nanosleep(&waitTime, NULL);
+    LL_lock(waitLock);
+    assert(takenWaitTokens == 0);
+    LL_unlock(waitLock);
+    for(int i = 0; i < WAIT_UNTIL_TEST_WAITERS; i++){
+        LL_delegate(waitLock, add_wait_token, 0, NULL);
+        nanosleep(&waitTime, NULL);
+    }
+    for(int i = 0; i < WAIT_UNTIL_TEST_WAITERS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    LL_lock(waitLock);
+    assert(takenWaitTokens == WAIT_UNTIL_TEST_WAITERS);
+    assert(waitTokens == 0);
+    LL_unlock(waitLock);
+    //A satisfied predicate returns right away
+    LL_delegate(waitLock, add_wait_token, 0, NULL);
+    LL_wait_until(waitLock, take_wait_token, NULL);
+    assert(takenWaitTokens == WAIT_UNTIL_TEST_WAITERS + 1);
+    LL_delegate_fence(waitLock);
+    LL_free(waitLock);
+    return 1;
+}
+
+OOLock * upgradeLock;
+unsigned long upgradeValue;
+LLPaddedULong upgradeOperations;
+
+void * write_lock_thread(void * unused){
+    UNUSED(unused);
+    LL_lock(upgradeLock);
+    LL_unlock(upgradeLock);
+    return NULL;
+}
+
+int test_upgrade_downgrade(LL_lock_type_name ooLockType){
+    upgradeLock = LL_create(ooLockType);
+    LL_rlock(upgradeLock);
+    assert(LL_upgrade(upgradeLock));
+    assert(LL_is_locked(upgradeLock));
+    LL_downgrade(upgradeLock);
+    assert(!LL_is_locked(upgradeLock));
+    LL_runlock(upgradeLock);
+    //The upgrade fails and releases the read lock when a writer waits
+    pthread_t writer;
+    LL_rlock(upgradeLock);
+    pthread_create(&writer, NULL, &write_lock_thread, NULL);
+    while(!LL_is_locked(upgradeLock)){
+        thread_yield();
+    }
+    assert(!LL_upgrade(upgradeLock));
+    pthread_join(writer, NULL);
+    LL_free(upgradeLock);
+    //Lock types without read locks never upgrade
+    OOLock * tatasLock = LL_create(TATAS_LOCK);
+    LL_rlock(tatasLock);
+    assert(!LL_upgrade(tatasLock));
+    assert(!LL_is_locked(tatasLock));
+    LL_free(tatasLock);
+    return 1;
+}
+
+void increment_upgrade_value(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    UNUSED(messageAddress);
+    upgradeValue = upgradeValue + 1;
+}
+
+void * check_then_modify_thread(void * unused){
+    UNUSED(unused);
+    unsigned long operations = 0;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        LL_rlock(upgradeLock);
+        unsigned long value = upgradeValue;
+        if(LL_upgrade_or_delegate(upgradeLock, increment_upgrade_value, 0, NULL)){
+            //No writer can get in between the read and the upgrade
+            assert(value == upgradeValue);
+            upgradeValue = value + 1;
+            if(operations % 2 == 0){
+                //Lets the other threads queue up for the write lock
+                thread_yield();
+                LL_downgrade(upgradeLock);
+                assert(value + 1 == upgradeValue);
+                //Writers that queued up meanwhile must still be kept out
+                thread_yield();
+                assert(value + 1 == upgradeValue);
+                LL_runlock(upgradeLock);
+            }else{
+                LL_unlock(upgradeLock);
+            }
+        }
+        operations = operations + 1;
+    }
+    atomic_fetch_add(&upgradeOperations.value, operations);
+    return NULL;
+}
+
+void * check_then_modify_writer_thread(void * unused){
+    UNUSED(unused);
+    unsigned long operations = 0;
+    while(!atomic_load_explicit(&stop.value, memory_order_acquire)){
+        LL_lock(upgradeLock);
+        upgradeValue = upgradeValue + 1;
+        LL_unlock(upgradeLock);
+        operations = operations + 1;
+    }
+    atomic_fetch_add(&upgradeOperations.value, operations);
+    return NULL;
+}
+
+int test_check_then_modify(LL_lock_type_name ooLockType){
+    pthread_t threads[8];
+    struct timespec testTime = {.tv_sec = 0, .tv_nsec = 500000000};
+    upgradeLock = LL_create(ooLockType);
+    upgradeValue = 0;
+    atomic_store(&upgradeOperations.value, 0);
+    atomic_store(&stop.value, false);
+    //The last two threads are writers that queue up while another
+    //thread holds the upgraded lock
+    for(int i = 0; i < 8; i++){
+        pthread_create(&threads[i],
+                       NULL,
+                       i < 6 ? &check_then_modify_thread : &check_then_modify_writer_thread,
+                       NULL);
+    }
+    nanosleep(&testTime, NULL);
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < 8; i++){
+        pthread_join(threads[i], NULL);
+    }
+    assert(upgradeValue == atomic_load(&upgradeOperations.value));
+    LL_free(upgradeLock);
+    return 1;
+}
+
+MRQDLock * fairnessLock;
+
+void * read_lock_thread(void * unused){
+    UNUSED(unused);
+    LL_rlock(fairnessLock);
+    LL_runlock(fairnessLock);
+    return NULL;
+}
+
+void * write_lock_fairness_lock_thread(void * unused){
+    UNUSED(unused);
+    LL_lock(fairnessLock);
+    LL_unlock(fairnessLock);
+    return NULL;
+}
+
+int test_read_patience_adjustment(){
+    struct timespec waitTime = {.tv_sec = 0, .tv_nsec = 10000000};
+    pthread_t thread;
+    fairnessLock = plain_mrqd_create();
+    LL_lock(fairnessLock);
+    LL_unlock(fairnessLock);
+    MRQDFairnessStats stats = mrqd_fairness_stats(fairnessLock);
+    assert(stats.readPatience == MRQD_READ_PATIENCE_LIMIT);
+    assert(stats.writeHolds == 1);
+    //A blocked reader makes the next writer halve the patience
+    LL_lock(fairnessLock);
+    pthread_create(&thread, NULL, &read_lock_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    LL_unlock(fairnessLock);
+    pthread_join(thread, NULL);
+    LL_lock(fairnessLock);
+    LL_unlock(fairnessLock);
+    stats = mrqd_fairness_stats(fairnessLock);
+    assert(stats.blockedReads == 1);
+    assert(stats.readPatience == MRQD_READ_PATIENCE_LIMIT / 2);
+    assert(stats.patienceAdjustments == 1);
+    //A writer stopped by the write barrier doubles it again
+    atomic_fetch_add(&fairnessLock->writeBarrier.value, 1);
+    pthread_create(&thread, NULL, &write_lock_fairness_lock_thread, NULL);
+    nanosleep(&waitTime, NULL);
+    atomic_fetch_sub(&fairnessLock->writeBarrier.value, 1);
+    pthread_join(thread, NULL);
+    stats = mrqd_fairness_stats(fairnessLock);
+    assert(stats.blockedWrites == 1);
+    assert(stats.readPatience == MRQD_READ_PATIENCE_LIMIT);
+    assert(stats.patienceAdjustments == 2);
+    assert(stats.writeHolds == 4);
+    mrqd_free(fairnessLock);
     return 1;
 }
 
@@ -194,6 +1198,11 @@ void test_lock_type(LL_lock_type_name name){
     T(test_lock(), "test_lock()");
     T(test_is_locked(), "test_is_locked()");
     T(test_is_locked(), "test_is_locked()");
+    T(test_lock_timed(), "test_lock_timed()");
+    if(name != CCSYNCH_LOCK && name != PLAIN_CCSYNCH_LOCK){
+        /* CC-Synch keeps one node per thread and can not be nested */
+        T(test_nested_locks(), "test_nested_locks()");
+    }
     T(test_mutual_exclusion(0.0, 0.0, 0.0, 0.0), "test_mutual_exclusion LL_lock = 100%");
     T(test_mutual_exclusion(0.5, 0.0, 0.0, 0.0), "test_mutual_exclusion LL_delegate = 50% LL_lock = 50%");
     T(test_mutual_exclusion(1.0, 0.0, 0.0, 0.0), "test_mutual_exclusion LL_delegate = 100%");
@@ -204,6 +1213,77 @@ void test_lock_type(LL_lock_type_name name){
     T(test_mutual_exclusion(0.0, 0.5, 0.5, 0.0), "LL_rlock = 50% LL_lock_or_delegate = 50%");
     T(test_mutual_exclusion(0.0, 0.0, 1.0, 0.0), "LL_delegate_wait = 100%");
     T(test_mutual_exclusion(0.2, 0.2, 0.2, 0.2), "20% All ops");
+    T(test_timed_mutual_exclusion(), "test_timed_mutual_exclusion LL_lock_timed = 33% LL_try_delegate = 33% LL_delegate_timed = 34%");
+    T(test_delegate_deadline(), "test_delegate_deadline()");
+    T(test_wait_until(), "test_wait_until()");
+    T(test_delegate_async(), "test_delegate_async()");
+    if(name == MRQD_LOCK || name == DRMCS_LOCK ||
+       name == PLAIN_MRQD_LOCK || name == PLAIN_DRMCS_LOCK){
+        LL_read_indicator_type readIndicatorTypes[] =
+            {PER_CPU_READER_GROUPS_READ_INDICATOR,
+             SNZI_READ_INDICATOR,
+             INGRESS_EGRESS_READ_INDICATOR,
+             ASYMMETRIC_READ_INDICATOR};
+        for(int i = 0; i < 4; i++){
+            read_indicator_type = readIndicatorTypes[i];
+            printf("Read indicator type %d\n", read_indicator_type);
+            T(test_mutual_exclusion(0.0, 1.0, 0.0, 0.0), "test_mutual_exclusion LL_rlock = 100%");
+            T(test_mutual_exclusion(0.33, 0.34, 0.0, 0.0), "test_mutual_exclusion LL_delegate = 33% LL_lock = 33% LL_rlock = 34%");
+            T(test_timed_mutual_exclusion(), "test_timed_mutual_exclusion LL_lock_timed = 33% LL_try_delegate = 33% LL_delegate_timed = 34%");
+        }
+        read_indicator_type = READER_GROUPS_READ_INDICATOR;
+        read_indicator_width = 1;
+        printf("Read indicator width %d\n", read_indicator_width);
+        T(test_mutual_exclusion(0.33, 0.34, 0.0, 0.0), "test_mutual_exclusion LL_delegate = 33% LL_lock = 33% LL_rlock = 34%");
+        read_indicator_width = MRQD_LOCK_NUMBER_OF_READER_GROUPS;
+        read_indicator_type = -1;
+        LL_lock_type_name ooLockType =
+            (name == MRQD_LOCK || name == PLAIN_MRQD_LOCK) ? MRQD_LOCK : DRMCS_LOCK;
+        T(test_upgrade_downgrade(ooLockType), "test_upgrade_downgrade()");
+        T(test_check_then_modify(ooLockType), "test_check_then_modify()");
+    }
+    if(name == MRQD_LOCK || name == PLAIN_MRQD_LOCK){
+        T(test_read_patience_adjustment(), "test_read_patience_adjustment()");
+        T(test_delegate_read(MRQD_LOCK), "test_delegate_read()");
+    }
+    if(name == QD_LOCK || name == PLAIN_QD_LOCK){
+        T(test_delegate_read(QD_LOCK), "test_delegate_read()");
+    }
+    if(name == QD_LOCK || name == PLAIN_QD_LOCK){
+        T(test_delegate_fence(QD_LOCK), "test_delegate_fence()");
+        T(test_delegate_forward_fence(QD_LOCK), "test_delegate_forward_fence()");
+        T(test_delegate_forward(QD_LOCK), "test_delegate_forward()");
+        T(test_delegate_forward_is_deferred(QD_LOCK), "test_delegate_forward_is_deferred()");
+        T(test_delegate_fence_other_forwards(QD_LOCK), "test_delegate_fence_other_forwards()");
+        T(test_delegate_deadline_expires_in_queue(QD_LOCK), "test_delegate_deadline_expires_in_queue()");
+    }
+    if(name == MRQD_LOCK || name == PLAIN_MRQD_LOCK){
+        T(test_delegate_fence(MRQD_LOCK), "test_delegate_fence()");
+        T(test_delegate_forward_fence(MRQD_LOCK), "test_delegate_forward_fence()");
+        T(test_delegate_forward(MRQD_LOCK), "test_delegate_forward()");
+        T(test_delegate_forward_is_deferred(MRQD_LOCK), "test_delegate_forward_is_deferred()");
+        T(test_delegate_fence_other_forwards(MRQD_LOCK), "test_delegate_fence_other_forwards()");
+        T(test_delegate_deadline_expires_in_queue(MRQD_LOCK), "test_delegate_deadline_expires_in_queue()");
+    }
+    if(name == QD_LOCK || name == PLAIN_QD_LOCK){
+        T(test_optimistic_read_versions(), "test_optimistic_read_versions()");
+        T(test_optimistic_read(QD_LOCK), "test_optimistic_read()");
+    }
+    if(name == MRQD_LOCK || name == PLAIN_MRQD_LOCK){
+        T(test_optimistic_read(MRQD_LOCK), "test_optimistic_read()");
+    }
+    if(name == ADAPTIVE_LOCK || name == PLAIN_ADAPTIVE_LOCK){
+        T(test_delegate_fence(ADAPTIVE_LOCK), "test_delegate_fence()");
+    }
+    if(name == COMPACT_QD_LOCK || name == PLAIN_COMPACT_QD_LOCK){
+        T(test_compact_qd_queue_detached_when_idle(), "test_compact_qd_queue_detached_when_idle()");
+        T(test_delegate_fence(COMPACT_QD_LOCK), "test_delegate_fence()");
+    }
+    if(name == PRIORITY_QD_LOCK || name == PLAIN_PRIORITY_QD_LOCK){
+        T(test_priority_lanes(), "test_priority_lanes()");
+        T(test_delegate_forward_is_deferred(PRIORITY_QD_LOCK), "test_delegate_forward_is_deferred()");
+        T(test_delegate_fence_other_forwards(PRIORITY_QD_LOCK), "test_delegate_fence_other_forwards()");
+    }
 
     printf("\n\n\n\033[32m ### LOCK TESTS COMPLETED! -- \033[m\n\n\n");    
 
@@ -225,6 +1305,14 @@ int main(int argc, char **argv){
             test_lock_type(MCS_LOCK);
         }else if(strcmp("DRMCS_LOCK", argv[1]) == 0){
             test_lock_type(DRMCS_LOCK);
+        }else if(strcmp("ADAPTIVE_LOCK", argv[1]) == 0){
+            test_lock_type(ADAPTIVE_LOCK);
+        }else if(strcmp("BIASED_LOCK", argv[1]) == 0){
+            test_lock_type(BIASED_LOCK);
+        }else if(strcmp("COMPACT_QD_LOCK", argv[1]) == 0){
+            test_lock_type(COMPACT_QD_LOCK);
+        }else if(strcmp("PRIORITY_QD_LOCK", argv[1]) == 0){
+            test_lock_type(PRIORITY_QD_LOCK);
         }else{
             printf("No lock with the name %s.\n", argv[1]);
         }
@@ -236,6 +1324,10 @@ int main(int argc, char **argv){
         printf("\tCCSYNCH_LOCK\n");
         printf("\tMCS_LOCK\n");
         printf("\tDRMCS_LOCK\n");
+        printf("\tADAPTIVE_LOCK\n");
+        printf("\tBIASED_LOCK\n");
+        printf("\tCOMPACT_QD_LOCK\n");
+        printf("\tPRIORITY_QD_LOCK\n");
     }
 #else
     UNUSED(argc);
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "locks/lock_table.h"
+#include "misc/misc_utils.h"
+#include "tests/test_framework.h"
+
+#define NUMBER_OF_THREADS 8
+#define NUMBER_OF_RECORDS 1000
+#define OPERATIONS_PER_THREAD 20000
+#define INITIAL_BALANCE 100
+
+LLLockTable * table;
+long balances[NUMBER_OF_RECORDS];
+volatile atomic_long deposits;
+
+int test_create(LL_lock_type_name lockType){
+    table = LL_lock_table_create(lockType, 1000);
+    assert(LL_table_number_of_stripes(table) == 1024);
+    for(int i = 0; i < NUMBER_OF_RECORDS; i++){
+        uintptr_t key = LL_table_key(&balances[i]);
+        assert(LL_table_stripe(table, key) < 1024);
+        assert(LL_table_stripe(table, key) == LL_table_stripe(table, key));
+        assert(((uintptr_t)LL_table_key_lock(table, key)) % CACHE_LINE_SIZE == 0);
+    }
+    LL_table_lock(table, 42);
+    assert(!LL_table_try_lock(table, 42));
+    LL_table_unlock(table, 42);
+    assert(LL_table_try_lock(table, 42));
+    LL_table_unlock(table, 42);
+    LL_lock_table_free(table);
+    return 1;
+}
+
+int test_lock_keys_deduplicates(LL_lock_type_name lockType){
+    table = LL_lock_table_create(lockType, 4);
+    uintptr_t keys[8];
+    unsigned long stripes[8];
+    for(int i = 0; i < 8; i++){
+        keys[i] = LL_table_key(&balances[i % 3]);
+    }
+    unsigned long numberOfStripes = LL_table_lock_keys(table, keys, 8, stripes);
+    assert(numberOfStripes >= 1 && numberOfStripes <= 3);
+    for(unsigned long i = 1; i < numberOfStripes; i++){
+        assert(stripes[i - 1] < stripes[i]);
+    }
+    for(int i = 0; i < 8; i++){
+        assert(!LL_table_try_lock(table, keys[i]));
+    }
+    LL_table_unlock_stripes(table, stripes, numberOfStripes);
+    for(int i = 0; i < 8; i++){
+        assert(LL_table_try_lock(table, keys[i]));
+        LL_table_unlock(table, keys[i]);
+    }
+    LL_lock_table_free(table);
+    return 1;
+}
+
+void deposit(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    long * balance = *(long **)messageAddress;
+    *balance = *balance + 1;
+}
+
+void * transfer_thread(void * seedVPtr){
+    unsigned int seed = *(unsigned int *)seedVPtr;
+    for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+        int from = rand_r(&seed) % NUMBER_OF_RECORDS;
+        int to = rand_r(&seed) % NUMBER_OF_RECORDS;
+        if(i % 4 == 0){
+            long * balance = &balances[to];
+            LL_table_delegate(table, LL_table_key(balance), deposit, sizeof(long *), &balance);
+            atomic_fetch_add(&deposits, 1);
+        }else{
+            uintptr_t keys[2] = {LL_table_key(&balances[from]), LL_table_key(&balances[to])};
+            unsigned long stripes[2];
+            unsigned long numberOfStripes = LL_table_lock_keys(table, keys, 2, stripes);
+            balances[from] = balances[from] - 1;
+            balances[to] = balances[to] + 1;
+            LL_table_unlock_stripes(table, stripes, numberOfStripes);
+        }
+    }
+    return NULL;
+}
+
+int test_transfers(LL_lock_type_name lockType, unsigned long numberOfStripes){
+    pthread_t threads[NUMBER_OF_THREADS];
+    unsigned int seeds[NUMBER_OF_THREADS];
+    table = LL_lock_table_create(lockType, numberOfStripes);
+    atomic_store(&deposits, 0);
+    for(int i = 0; i < NUMBER_OF_RECORDS; i++){
+        balances[i] = INITIAL_BALANCE;
+    }
+    for(int i = 0; i < NUMBER_OF_THREADS; i++){
+        seeds[i] = i + 1;
+        pthread_create(&threads[i], NULL, &transfer_thread, &seeds[i]);
+    }
+    for(int i = 0; i < NUMBER_OF_THREADS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    long sum = 0;
+    for(int i = 0; i < NUMBER_OF_RECORDS; i++){
+        sum = sum + balances[i];
+    }
+    assert(sum == NUMBER_OF_RECORDS * INITIAL_BALANCE + atomic_load(&deposits));
+    LL_lock_table_free(table);
+    return 1;
+}
+
+void test_lock_table_type(LL_lock_type_name lockType){
+    T(test_create(lockType), "test_create()");
+    T(test_lock_keys_deduplicates(lockType), "test_lock_keys_deduplicates()");
+    T(test_transfers(lockType, 64), "test_transfers(64 stripes)");
+    T(test_transfers(lockType, 1), "test_transfers(1 stripe)");
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING LOCK TABLE TESTS! -- \033[m\n\n\n");
+
+    printf("TATAS_LOCK\n");
+    test_lock_table_type(TATAS_LOCK);
+    printf("QD_LOCK\n");
+    test_lock_table_type(QD_LOCK);
+    printf("COMPACT_QD_LOCK\n");
+    test_lock_table_type(COMPACT_QD_LOCK);
+    printf("MRQD_LOCK\n");
+    test_lock_table_type(MRQD_LOCK);
+    printf("MCS_LOCK\n");
+    test_lock_table_type(MCS_LOCK);
+    printf("PLAIN_ADAPTIVE_LOCK\n");
+    test_lock_table_type(PLAIN_ADAPTIVE_LOCK);
+
+    printf("\n\n\n\033[32m ### LOCK TABLE TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}
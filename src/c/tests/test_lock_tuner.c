@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "locks/lock_tuner.h"
+#include "tests/test_framework.h"
+
+int test_lock_type_names(){
+    LL_lock_type_name types[] = {TATAS_LOCK, QD_LOCK, MRQD_LOCK, ADAPTIVE_LOCK, BIASED_LOCK,
+                                 COMPACT_QD_LOCK, CCSYNCH_LOCK, MCS_LOCK, DRMCS_LOCK};
+    for(unsigned int i = 0; i < sizeof(types)/sizeof(LL_lock_type_name); i++){
+        LL_lock_type_name parsed;
+        const char * name = lock_tuner_lock_type_name(types[i]);
+        assert(name != NULL);
+        assert(lock_tuner_parse_lock_type_name(name, &parsed));
+        assert(parsed == types[i]);
+    }
+    LL_lock_type_name parsed;
+    assert(!lock_tuner_parse_lock_type_name("NO_SUCH_LOCK", &parsed));
+    assert(lock_tuner_lock_type_name(PLAIN_QD_LOCK) == NULL);
+    return 1;
+}
+
+int test_benchmark(double delegatePercentage, double readPercentage){
+    LLWorkloadProfile profile = {.delegatePercentage = delegatePercentage,
+                                 .readPercentage = readPercentage,
+                                 .numberOfThreads = 4,
+                                 .criticalSectionWork = 4,
+                                 .nonCriticalSectionWork = 16};
+    assert(lock_tuner_benchmark(QD_LOCK, &profile) > 0.0);
+    assert(lock_tuner_benchmark(MRQD_LOCK, &profile) > 0.0);
+    return 1;
+}
+
+int test_select_with_cache(){
+    char cacheFile[] = "/tmp/test_lock_tuner_cacheXXXXXX";
+    int fd = mkstemp(cacheFile);
+    assert(fd >= 0);
+    close(fd);
+    LLWorkloadProfile profile = {.delegatePercentage = 0.5,
+                                 .readPercentage = 0.25,
+                                 .numberOfThreads = 2,
+                                 .criticalSectionWork = 2,
+                                 .nonCriticalSectionWork = 8};
+    LL_lock_type_name selected = lock_tuner_select(&profile, cacheFile);
+    assert(lock_tuner_lock_type_name(selected) != NULL);
+    //The second selection has to come from the cache
+    FILE * file = fopen(cacheFile, "w");
+    fprintf(file, "%.4f %.4f %u %u %u %s\n",
+            profile.delegatePercentage,
+            profile.readPercentage,
+            profile.numberOfThreads,
+            profile.criticalSectionWork,
+            profile.nonCriticalSectionWork,
+            "DRMCS_LOCK");
+    fclose(file);
+    assert(lock_tuner_select(&profile, cacheFile) == DRMCS_LOCK);
+    unlink(cacheFile);
+    return 1;
+}
+
+int test_create_auto(){
+    LLWorkloadProfile profile = {.delegatePercentage = 0.9,
+                                 .readPercentage = 0.0,
+                                 .numberOfThreads = 2,
+                                 .criticalSectionWork = 1,
+                                 .nonCriticalSectionWork = 0};
+    OOLock * lock = LL_create_auto(profile);
+    LL_lock(lock);
+    assert(LL_is_locked(lock));
+    LL_unlock(lock);
+    LL_free(lock);
+    return 1;
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING LOCK TUNER TESTS! -- \033[m\n\n\n");
+
+    T(test_lock_type_names(), "test_lock_type_names()");
+    T(test_benchmark(1.0, 0.0), "test_benchmark LL_delegate = 100%");
+    T(test_benchmark(0.0, 1.0), "test_benchmark LL_rlock = 100%");
+    T(test_benchmark(0.33, 0.34), "test_benchmark LL_delegate = 33% LL_lock = 33% LL_rlock = 34%");
+    T(test_select_with_cache(), "test_select_with_cache()");
+    T(test_create_auto(), "test_create_auto()");
+
+    printf("\n\n\n\033[32m ### LOCK TUNER TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "tests/test_framework.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "locks/locks_coroutine.hpp"
+
+#define NUMBER_OF_POOL_THREADS 2
+#define NUMBER_OF_COROUTINES 1000
+#define OPERATIONS_PER_COROUTINE 100
+
+static const LL_lock_type_name lockTypes[] = {
+    TATAS_LOCK,
+    QD_LOCK,
+    MRQD_LOCK,
+    CCSYNCH_LOCK,
+    MCS_LOCK,
+    DRMCS_LOCK,
+    ADAPTIVE_LOCK,
+    BIASED_LOCK,
+    COMPACT_QD_LOCK,
+    PRIORITY_QD_LOCK
+};
+
+void wait_for(std::atomic<int> & finished, int expected){
+    while(finished.load() < expected){
+        std::this_thread::yield();
+    }
+}
+
+ll::DetachedCoroutine increment(ll::Lock & lock,
+                                ll::ThreadPool & pool,
+                                long & counter,
+                                std::atomic<int> & finished){
+    co_await pool.schedule();
+    long previous = 0;
+    for(int i = 0; i < OPERATIONS_PER_COROUTINE; i++){
+        // The yield gives the other pool threads time to delegate to
+        // the lock while it is held
+        long value = co_await ll::delegate_await(lock, [&counter]{
+                std::this_thread::yield();
+                return ++counter;
+            }, pool);
+        assert(value > previous);
+        previous = value;
+    }
+    finished.fetch_add(1);
+}
+
+int test_delegate_await(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    long counter = 0;
+    std::atomic<int> finished(0);
+    {
+        ll::ThreadPool pool(NUMBER_OF_POOL_THREADS);
+        for(int i = 0; i < NUMBER_OF_COROUTINES; i++){
+            increment(lock, pool, counter, finished);
+        }
+        wait_for(finished, NUMBER_OF_COROUTINES);
+    }
+    assert(counter == NUMBER_OF_COROUTINES * OPERATIONS_PER_COROUTINE);
+    return 1;
+}
+
+ll::DetachedCoroutine append(ll::Lock & lock,
+                             ll::ThreadPool & pool,
+                             std::string & text,
+                             std::atomic<int> & finished){
+    co_await pool.schedule();
+    co_await ll::delegate_await(lock, [&text]{ text.push_back('x'); }, pool);
+    std::string copy = co_await ll::delegate_await(lock, [&text]{ return text; }, pool);
+    assert(!copy.empty());
+    finished.fetch_add(1);
+}
+
+int test_delegate_await_void_and_class_results(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    std::string text;
+    std::atomic<int> finished(0);
+    {
+        ll::ThreadPool pool(NUMBER_OF_POOL_THREADS);
+        for(int i = 0; i < NUMBER_OF_COROUTINES; i++){
+            append(lock, pool, text, finished);
+        }
+        wait_for(finished, NUMBER_OF_COROUTINES);
+    }
+    assert(text.size() == NUMBER_OF_COROUTINES);
+    return 1;
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING C++ COROUTINE LOCK TESTS! -- \033[m\n\n\n");
+
+    for(LL_lock_type_name lockType : lockTypes){
+        T(test_delegate_await(lockType), "test_delegate_await()");
+        T(test_delegate_await_void_and_class_results(lockType),
+          "test_delegate_await_void_and_class_results()");
+    }
+
+    printf("\n\n\n\033[32m ### C++ COROUTINE LOCK TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}
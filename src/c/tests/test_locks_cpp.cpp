@@ -0,0 +1,124 @@
+#include "tests/test_framework.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "locks/locks.hpp"
+
+#define NUMBER_OF_THREADS 4
+#define OPERATIONS_PER_THREAD 10000
+
+static const LL_lock_type_name lockTypes[] = {
+    TATAS_LOCK,
+    QD_LOCK,
+    MRQD_LOCK,
+    CCSYNCH_LOCK,
+    MCS_LOCK,
+    DRMCS_LOCK,
+    ADAPTIVE_LOCK,
+    BIASED_LOCK,
+    COMPACT_QD_LOCK,
+    PRIORITY_QD_LOCK
+};
+
+template<class F>
+void run_in_threads(F function){
+    std::vector<std::thread> threads;
+    for(int i = 0; i < NUMBER_OF_THREADS; i++){
+        threads.push_back(std::thread(function));
+    }
+    for(std::thread & thread : threads){
+        thread.join();
+    }
+}
+
+int test_guards(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    long counter = 0;
+    run_in_threads([&]{
+            for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+                if(i % 2 == 0){
+                    ll::LockGuard guard(lock);
+                    counter++;
+                }else{
+                    std::lock_guard<ll::Lock> guard(lock);
+                    counter++;
+                }
+                ll::ReadGuard guard(lock);
+                assert(counter > 0);
+            }
+        });
+    assert(counter == NUMBER_OF_THREADS * OPERATIONS_PER_THREAD);
+    return 1;
+}
+
+int test_delegate(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    long counter = 0;
+    run_in_threads([&]{
+            for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+                long amount = i % 3;
+                ll::delegate(lock, [&counter, amount]{ counter = counter + amount; });
+            }
+            lock.delegate_fence();
+        });
+    long expected = 0;
+    for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+        expected = expected + NUMBER_OF_THREADS * (i % 3);
+    }
+    assert(ll::delegate_wait(lock, [&counter]{ return counter; }) == expected);
+    return 1;
+}
+
+int test_delegate_future(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    std::vector<int> values;
+    run_in_threads([&]{
+            for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+                ll::Future<std::size_t> size;
+                ll::delegate(lock, [&values, i]{ values.push_back(i); return values.size(); }, size);
+                assert(size.get() > 0);
+            }
+        });
+    assert(values.size() == NUMBER_OF_THREADS * OPERATIONS_PER_THREAD);
+    ll::Future<void> done;
+    ll::delegate(lock, [&values]{ values.clear(); }, done);
+    done.get();
+    assert(values.empty());
+    return 1;
+}
+
+int test_captured_state_is_destroyed(LL_lock_type_name lockType){
+    ll::Lock lock(lockType);
+    std::shared_ptr<std::string> text = std::make_shared<std::string>("text");
+    std::string copies;
+    run_in_threads([&]{
+            for(int i = 0; i < OPERATIONS_PER_THREAD; i++){
+                std::shared_ptr<std::string> captured = text;
+                ll::delegate(lock, [&copies, captured]{ copies = *captured; });
+            }
+            lock.delegate_fence();
+        });
+    assert(ll::delegate_wait(lock, [&copies]{ return copies; }) == "text");
+    assert(text.use_count() == 1);
+    return 1;
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING C++ LOCK TESTS! -- \033[m\n\n\n");
+
+    for(LL_lock_type_name lockType : lockTypes){
+        T(test_guards(lockType), "test_guards()");
+        T(test_delegate(lockType), "test_delegate()");
+        T(test_delegate_future(lockType), "test_delegate_future()");
+        T(test_captured_state_is_destroyed(lockType), "test_captured_state_is_destroyed()");
+    }
+
+    printf("\n\n\n\033[32m ### C++ LOCK TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}
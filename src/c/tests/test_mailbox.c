@@ -0,0 +1,164 @@
+#include "tests/test_framework.h"
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "misc/misc_utils.h"
+
+#include "qd_queues/mailbox.h"
+#include "qd_queues/actor.h"
+
+#define NUMBER_OF_PRODUCERS 4
+#define MESSAGES_PER_PRODUCER 20000
+
+typedef struct {
+    int producer;
+    unsigned long sequenceNumber;
+} ProducerMessage;
+
+LLMailbox * mailbox;
+unsigned long received;
+unsigned long nextSequenceNumbers[NUMBER_OF_PRODUCERS];
+
+void receive_in_order(unsigned int messageSize, void * messageAddress){
+    assert(messageSize == sizeof(ProducerMessage));
+    ProducerMessage * message = messageAddress;
+    assert(message->sequenceNumber == nextSequenceNumbers[message->producer]);
+    nextSequenceNumbers[message->producer]++;
+    received++;
+}
+
+void reset_receiver(){
+    received = 0;
+    for(int i = 0; i < NUMBER_OF_PRODUCERS; i++){
+        nextSequenceNumbers[i] = 0;
+    }
+}
+
+int test_send_and_drain(){
+    mailbox = ll_mailbox_create();
+    reset_receiver();
+    ProducerMessage message = {.producer = 0, .sequenceNumber = 0};
+    assert(ll_mailbox_drain(mailbox, 100) == 0);
+    //Fill the mailbox a few times
+    while(message.sequenceNumber < 4 * QD_QUEUE_BUFFER_SIZE / sizeof(ProducerMessage)){
+        if(ll_mailbox_try_send(mailbox, receive_in_order, sizeof(message), &message)){
+            message.sequenceNumber++;
+        }else{
+            assert(ll_mailbox_drain(mailbox, ULONG_MAX) > 0);
+        }
+    }
+    while(ll_mailbox_drain(mailbox, 7) > 0){
+        //The rest is executed in small batches
+    }
+    assert(received == message.sequenceNumber);
+    ll_mailbox_free(mailbox);
+    return 1;
+}
+
+void * producer_thread(void * producerPtr){
+    ProducerMessage message = {.producer = *(int *)producerPtr, .sequenceNumber = 0};
+    for(int i = 0; i < MESSAGES_PER_PRODUCER; i++){
+        ll_mailbox_send(mailbox, receive_in_order, sizeof(message), &message);
+        message.sequenceNumber++;
+    }
+    return NULL;
+}
+
+int test_multiple_producers(){
+    pthread_t producers[NUMBER_OF_PRODUCERS];
+    int producerIds[NUMBER_OF_PRODUCERS];
+    mailbox = ll_mailbox_create();
+    reset_receiver();
+    for(int i = 0; i < NUMBER_OF_PRODUCERS; i++){
+        producerIds[i] = i;
+        pthread_create(&producers[i], NULL, &producer_thread, &producerIds[i]);
+    }
+    while(received < NUMBER_OF_PRODUCERS * MESSAGES_PER_PRODUCER){
+        ll_mailbox_drain_wait(mailbox, 64);
+    }
+    for(int i = 0; i < NUMBER_OF_PRODUCERS; i++){
+        pthread_join(producers[i], NULL);
+        assert(nextSequenceNumbers[i] == MESSAGES_PER_PRODUCER);
+    }
+    ll_mailbox_free(mailbox);
+    return 1;
+}
+
+void * drain_wait_thread(void * unused){
+    UNUSED(unused);
+    assert(ll_mailbox_drain_wait(mailbox, 64) == 1);
+    return NULL;
+}
+
+int test_wake_sleeping_consumer(){
+    pthread_t consumer;
+    ProducerMessage message = {.producer = 0, .sequenceNumber = 0};
+    mailbox = ll_mailbox_create();
+    reset_receiver();
+    pthread_create(&consumer, NULL, &drain_wait_thread, NULL);
+    while(!atomic_load(&mailbox->sleeping.value)){
+        thread_yield();
+    }
+    ll_mailbox_send(mailbox, receive_in_order, sizeof(message), &message);
+    pthread_join(consumer, NULL);
+    assert(received == 1);
+    ll_mailbox_free(mailbox);
+    return 1;
+}
+
+/* A pipeline of two actors. The first doubles the numbers it gets and
+   sends them to the second, which sums them up. */
+
+typedef struct {
+    LLActor * next;
+} Doubler;
+
+typedef struct {
+    unsigned long sum;
+    unsigned long numbers;
+} Summer;
+
+void sum_number(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    Summer * summer = ll_actor_state();
+    summer->sum = summer->sum + *(unsigned long *)messageAddress;
+    summer->numbers++;
+}
+
+void double_number(unsigned int messageSize, void * messageAddress){
+    UNUSED(messageSize);
+    Doubler * doubler = ll_actor_state();
+    unsigned long doubled = 2 * *(unsigned long *)messageAddress;
+    ll_actor_send(doubler->next, sum_number, sizeof(doubled), &doubled);
+}
+
+int test_actor_pipeline(){
+    Summer summer = {.sum = 0, .numbers = 0};
+    LLActor * summerActor = ll_actor_create(&summer);
+    Doubler doubler = {.next = summerActor};
+    LLActor * doublerActor = ll_actor_create(&doubler);
+    unsigned long expectedSum = 0;
+    for(unsigned long i = 0; i < 100000; i++){
+        ll_actor_send(doublerActor, double_number, sizeof(i), &i);
+        expectedSum = expectedSum + 2 * i;
+    }
+    assert(ll_actor_stop(doublerActor) == &doubler);
+    assert(ll_actor_stop(summerActor) == &summer);
+    assert(summer.numbers == 100000);
+    assert(summer.sum == expectedSum);
+    return 1;
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING MAILBOX TESTS! -- \033[m\n\n\n");
+
+    T(test_send_and_drain(), "test_send_and_drain()");
+    T(test_multiple_producers(), "test_multiple_producers()");
+    T(test_wake_sleeping_consumer(), "test_wake_sleeping_consumer()");
+    T(test_actor_pipeline(), "test_actor_pipeline()");
+
+    printf("\n\n\n\033[32m ### MAILBOX TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}
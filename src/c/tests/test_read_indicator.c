@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "misc/thread_includes.h"
+#include "misc/bsd_stdatomic.h"//Until c11 stdatomic.h is available
+#include "read_indicators/read_indicator.h"
+#include "locks/locks.h"
+#include "misc/misc_utils.h"
+#include "tests/test_framework.h"
+
+#define NUMBER_OF_READER_THREADS 8
+#define ARRIVALS_PER_THREAD 20000
+
+ReadIndicator indicators[2];
+LLPaddedULong readersInside;
+LLPaddedBool stop;
+
+bool no_readers(ReadIndicator * indicator){
+    return ri_wait_all_readers_gone_until(indicator, ll_now_nanos());
+}
+
+int test_arrive_depart(LL_read_indicator_type type){
+    ReadIndicator indicator;
+    ri_initialize(&indicator, type);
+    for(int i = 0; i < 100; i++){
+        ri_arrive(&indicator);
+        assert(!no_readers(&indicator));
+        ri_arrive(&indicator);
+        ri_depart(&indicator);
+        assert(!no_readers(&indicator));
+        ri_depart(&indicator);
+        ri_wait_all_readers_gone(&indicator);
+    }
+    assert(no_readers(&indicator));
+    ri_destroy(&indicator);
+    return 1;
+}
+
+int test_wait_times_out_with_reader(LL_read_indicator_type type){
+    ReadIndicator indicator;
+    ri_initialize(&indicator, type);
+    ri_arrive(&indicator);
+    assert(!ri_wait_all_readers_gone_until(&indicator, ll_deadline_from_timeout(1000)));
+    assert(!ri_wait_all_readers_gone_until(&indicator, ll_deadline_from_timeout(1000)));
+    ri_depart(&indicator);
+    assert(ri_wait_all_readers_gone_until(&indicator, ll_deadline_from_timeout(1000)));
+    ri_destroy(&indicator);
+    return 1;
+}
+
+void * nested_reader_thread(void * unused){
+    UNUSED(unused);
+    for(int i = 0; i < ARRIVALS_PER_THREAD; i++){
+        ri_arrive(&indicators[0]);
+        atomic_fetch_add(&readersInside.value, 1);
+        ri_arrive(&indicators[1]);
+        //Give the thread a chance to migrate between arrive and depart
+        thread_yield();
+        atomic_fetch_sub(&readersInside.value, 1);
+        ri_depart(&indicators[0]);
+        ri_depart(&indicators[1]);
+    }
+    return NULL;
+}
+
+void * writer_thread(void * unused){
+    UNUSED(unused);
+    while(!atomic_load(&stop.value)){
+        ri_wait_all_readers_gone(&indicators[1]);
+        ri_wait_all_readers_gone(&indicators[0]);
+        thread_yield();
+    }
+    return NULL;
+}
+
+int test_nested_arrivals_with_writer(LL_read_indicator_type type){
+    pthread_t readers[NUMBER_OF_READER_THREADS];
+    pthread_t writer;
+    ri_initialize(&indicators[0], type);
+    ri_initialize(&indicators[1], type);
+    atomic_store(&stop.value, false);
+    pthread_create(&writer, NULL, &writer_thread, NULL);
+    for(int i = 0; i < NUMBER_OF_READER_THREADS; i++){
+        pthread_create(&readers[i], NULL, &nested_reader_thread, NULL);
+    }
+    for(int i = 0; i < NUMBER_OF_READER_THREADS; i++){
+        pthread_join(readers[i], NULL);
+    }
+    atomic_store(&stop.value, true);
+    pthread_join(writer, NULL);
+    assert(atomic_load(&readersInside.value) == 0);
+    assert(no_readers(&indicators[0]));
+    assert(no_readers(&indicators[1]));
+    ri_destroy(&indicators[0]);
+    ri_destroy(&indicators[1]);
+    return 1;
+}
+
+void * holding_reader_thread(void * unused){
+    UNUSED(unused);
+    ri_arrive(&indicators[0]);
+    atomic_fetch_add(&readersInside.value, 1);
+    while(!atomic_load(&stop.value)){
+        thread_yield();
+    }
+    ri_depart(&indicators[0]);
+    return NULL;
+}
+
+/* Uses more reader threads than the asymmetric read indicator has
+   slots so both the slots and the overflow counter are used */
+int test_more_readers_than_slots(){
+    int numberOfThreads = ASYMMETRIC_READ_INDICATOR_SLOTS + NUMBER_OF_READER_THREADS;
+    pthread_t * readers = malloc(sizeof(pthread_t) * numberOfThreads);
+    ri_initialize(&indicators[0], ASYMMETRIC_READ_INDICATOR);
+    atomic_store(&readersInside.value, 0);
+    atomic_store(&stop.value, false);
+    for(int i = 0; i < numberOfThreads; i++){
+        pthread_create(&readers[i], NULL, &holding_reader_thread, NULL);
+    }
+    while(atomic_load(&readersInside.value) < (unsigned long)numberOfThreads){
+        thread_yield();
+    }
+    assert(atomic_load(&rgri_get_thread_id_counter) > ASYMMETRIC_READ_INDICATOR_SLOTS);
+    assert(!ri_wait_all_readers_gone_until(&indicators[0], ll_deadline_from_timeout(1000)));
+    atomic_store(&stop.value, true);
+    for(int i = 0; i < numberOfThreads; i++){
+        pthread_join(readers[i], NULL);
+    }
+    assert(ri_wait_all_readers_gone_until(&indicators[0], ll_deadline_from_timeout(1000)));
+    ri_destroy(&indicators[0]);
+    free(readers);
+    return 1;
+}
+
+int test_width(LL_read_indicator_type type, int width){
+    ReadIndicator indicator;
+    ri_initialize_with_width(&indicator, type, width);
+    assert(ri_allocated_size(&indicator) == reader_groups_size(width));
+    ri_arrive(&indicator);
+    assert(!no_readers(&indicator));
+    ri_depart(&indicator);
+    assert(no_readers(&indicator));
+    ri_destroy(&indicator);
+    return 1;
+}
+
+int test_shared(LL_read_indicator_type type){
+    ReadIndicator indicator;
+    ReadIndicator sharing[2];
+    ri_initialize(&indicator, type);
+    ri_initialize_shared(&sharing[0], &indicator);
+    ri_initialize_shared(&sharing[1], &indicator);
+    assert(ri_allocated_size(&sharing[0]) == 0);
+    ri_arrive(&sharing[0]);
+    assert(!no_readers(&sharing[1]));
+    assert(!no_readers(&indicator));
+    ri_depart(&sharing[0]);
+    assert(no_readers(&sharing[1]));
+    ri_destroy(&sharing[0]);
+    ri_destroy(&sharing[1]);
+    ri_arrive(&indicator);
+    ri_depart(&indicator);
+    ri_destroy(&indicator);
+    return 1;
+}
+
+/* Two locks share one indicator. Readers and writers of both locks
+   check that the writers of a lock exclude all other threads in the
+   same lock. */
+
+#define NUMBER_OF_SHARING_THREADS 4
+#define OPERATIONS_PER_SHARING_THREAD 20000
+
+OOLock * sharingLocks[2];
+LLPaddedULong readersInLock[2];
+LLPaddedULong writersInLock[2];
+
+void * sharing_lock_thread(void * threadIdPtr){
+    unsigned long threadId = *(unsigned long *)threadIdPtr;
+    for(unsigned long i = 0; i < OPERATIONS_PER_SHARING_THREAD; i++){
+        int l = (i + threadId) % 2;
+        if((i / 2 + threadId) % 3 == 0){
+            LL_lock(sharingLocks[l]);
+            assert(atomic_fetch_add(&writersInLock[l].value, 1) == 0);
+            assert(atomic_load(&readersInLock[l].value) == 0);
+            thread_yield();
+            assert(atomic_load(&readersInLock[l].value) == 0);
+            atomic_fetch_sub(&writersInLock[l].value, 1);
+            LL_unlock(sharingLocks[l]);
+        }else{
+            LL_rlock(sharingLocks[l]);
+            atomic_fetch_add(&readersInLock[l].value, 1);
+            assert(atomic_load(&writersInLock[l].value) == 0);
+            thread_yield();
+            assert(atomic_load(&writersInLock[l].value) == 0);
+            atomic_fetch_sub(&readersInLock[l].value, 1);
+            LL_runlock(sharingLocks[l]);
+        }
+    }
+    return NULL;
+}
+
+int test_shared_with_locks(LL_read_indicator_type type, LL_lock_type_name lockType){
+    pthread_t threads[NUMBER_OF_SHARING_THREADS];
+    unsigned long threadIds[NUMBER_OF_SHARING_THREADS];
+    ReadIndicator indicator;
+    // With a single reader group all threads race on the same summary bit
+    ri_initialize_with_width(&indicator, type, 1);
+    for(int l = 0; l < 2; l++){
+        sharingLocks[l] = LL_create_with_shared_read_indicator(lockType, &indicator);
+        atomic_store(&readersInLock[l].value, 0);
+        atomic_store(&writersInLock[l].value, 0);
+    }
+    for(int i = 0; i < NUMBER_OF_SHARING_THREADS; i++){
+        threadIds[i] = i;
+        pthread_create(&threads[i], NULL, &sharing_lock_thread, &threadIds[i]);
+    }
+    for(int i = 0; i < NUMBER_OF_SHARING_THREADS; i++){
+        pthread_join(threads[i], NULL);
+    }
+    for(int l = 0; l < 2; l++){
+        LL_free(sharingLocks[l]);
+    }
+    assert(no_readers(&indicator));
+    ri_destroy(&indicator);
+    return 1;
+}
+
+void test_read_indicator_type(LL_read_indicator_type type){
+    T(test_arrive_depart(type), "test_arrive_depart()");
+    T(test_wait_times_out_with_reader(type), "test_wait_times_out_with_reader()");
+    T(test_nested_arrivals_with_writer(type), "test_nested_arrivals_with_writer()");
+    T(test_shared(type), "test_shared()");
+    T(test_shared_with_locks(type, MRQD_LOCK), "test_shared_with_locks(MRQD_LOCK)");
+    T(test_shared_with_locks(type, DRMCS_LOCK), "test_shared_with_locks(DRMCS_LOCK)");
+}
+
+int main(){
+
+    printf("\n\n\n\033[32m ### STARTING READ INDICATOR TESTS! -- \033[m\n\n\n");
+
+    printf("READER_GROUPS_READ_INDICATOR\n");
+    test_read_indicator_type(READER_GROUPS_READ_INDICATOR);
+    printf("PER_CPU_READER_GROUPS_READ_INDICATOR\n");
+    test_read_indicator_type(PER_CPU_READER_GROUPS_READ_INDICATOR);
+    T(test_width(READER_GROUPS_READ_INDICATOR, 1), "test_width(READER_GROUPS_READ_INDICATOR, 1)");
+    T(test_width(READER_GROUPS_READ_INDICATOR, 4), "test_width(READER_GROUPS_READ_INDICATOR, 4)");
+    T(test_width(PER_CPU_READER_GROUPS_READ_INDICATOR, 2), "test_width(PER_CPU_READER_GROUPS_READ_INDICATOR, 2)");
+    printf("SNZI_READ_INDICATOR\n");
+    test_read_indicator_type(SNZI_READ_INDICATOR);
+    printf("INGRESS_EGRESS_READ_INDICATOR\n");
+    test_read_indicator_type(INGRESS_EGRESS_READ_INDICATOR);
+    printf("ASYMMETRIC_READ_INDICATOR\n");
+    test_read_indicator_type(ASYMMETRIC_READ_INDICATOR);
+    T(test_more_readers_than_slots(), "test_more_readers_than_slots()");
+
+    printf("\n\n\n\033[32m ### READ INDICATOR TESTS COMPLETED! -- \033[m\n\n\n");
+
+    return 0;
+}